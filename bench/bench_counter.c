@@ -0,0 +1,138 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "geohex/geohex.h"
+#include "geohex/counter.h"
+
+#include "idmap.h"
+
+#define ZONES           4096
+#define OPS_PER_THREAD  2000000
+#define MAX_THREADS     64
+
+static geohex_id_t ids[ZONES];
+
+typedef struct {
+    geohex_counter_t *counter;
+    geohex_idmap_t *map;
+    uint64_t *counts;
+    pthread_mutex_t *lock;
+    uint32_t seed;
+} worker_t;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static inline uint32_t next_index(uint32_t *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return (*seed >> 8) % ZONES;
+}
+
+static void *lockfree_main(void *arg)
+{
+    worker_t *worker = arg;
+
+    for (uint32_t i = 0; i < OPS_PER_THREAD; i++) {
+        geohex_counter_add(worker->counter, ids[next_index(&worker->seed)], 1);
+    }
+
+    return NULL;
+}
+
+static void *mutex_main(void *arg)
+{
+    worker_t *worker = arg;
+
+    for (uint32_t i = 0; i < OPS_PER_THREAD; i++) {
+        geohex_id_t id = ids[next_index(&worker->seed)];
+        bool inserted;
+
+        pthread_mutex_lock(worker->lock);
+        size_t *index = geohex_idmap_insert(worker->map, id, &inserted);
+        if (inserted) {
+            *index = worker->map->size - 1;
+        }
+        worker->counts[*index]++;
+        pthread_mutex_unlock(worker->lock);
+    }
+
+    return NULL;
+}
+
+static double run(uint32_t threads, void *(*main_fn)(void *), worker_t *proto)
+{
+    pthread_t handles[MAX_THREADS];
+    worker_t workers[MAX_THREADS];
+    double start = now_seconds();
+
+    for (uint32_t t = 0; t < threads; t++) {
+        workers[t] = *proto;
+        workers[t].seed = t * 7919u + 1u;
+        pthread_create(&handles[t], NULL, main_fn, &workers[t]);
+    }
+    for (uint32_t t = 0; t < threads; t++) {
+        pthread_join(handles[t], NULL);
+    }
+
+    return (double) threads * OPS_PER_THREAD / (now_seconds() - start) / 1e6;
+}
+
+int main(void)
+{
+    for (uint32_t i = 0; i < ZONES; i++) {
+        loc_t loc = {139.0 + (i % 64) * 0.01, 35.0 + (i / 64) * 0.01};
+        xy_t xy;
+
+        get_xy_by_location(&loc, 9, &xy);
+        get_id_by_xy(&xy, 9, &ids[i]);
+    }
+
+    printf("%8s %16s %16s\n", "threads", "lock-free Mops/s", "mutex Mops/s");
+
+    for (uint32_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        worker_t proto = {0};
+        pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+        geohex_idmap_t map;
+
+        proto.counter = geohex_counter_create(ZONES);
+        double lockfree = run(threads, lockfree_main, &proto);
+        geohex_counter_destroy(proto.counter);
+
+        geohex_idmap_init(&map, ZONES);
+        proto.counter = NULL;
+        proto.map = &map;
+        proto.counts = calloc(ZONES, sizeof(uint64_t));
+        proto.lock = &lock;
+        double mutex = run(threads, mutex_main, &proto);
+        free(proto.counts);
+        geohex_idmap_free(&map);
+
+        printf("%8u %16.2f %16.2f\n", threads, lockfree, mutex);
+    }
+
+    return 0;
+}
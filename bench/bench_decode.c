@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "geohex/geohex.h"
+
+#define CODES   1000000
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+    geohex_code_t *codes = malloc(CODES * sizeof(geohex_code_t));
+    zone_t *exact = malloc(CODES * sizeof(zone_t));
+    zone_t *fast = malloc(CODES * sizeof(zone_t));
+    uint32_t seed = 1;
+
+    printf("%6s %14s %14s %12s\n", "level", "exact ns/code", "fast ns/code", "max error");
+
+    for (uint32_t level = 3; level <= MAX_LEVEL; level += 4) {
+        double error = 0;
+
+        for (size_t i = 0; i < CODES; i++) {
+            loc_t loc;
+            zone_t zone;
+
+            seed = seed * 1664525u + 1013904223u;
+            loc.lon = -180.0 + 360.0 * (double) (seed >> 8) / 16777216.0;
+            seed = seed * 1664525u + 1013904223u;
+            loc.lat = -85.0 + 170.0 * (double) (seed >> 8) / 16777216.0;
+            get_zone_by_location(&loc, level, &zone);
+            memcpy(codes[i], zone.code, sizeof(geohex_code_t));
+        }
+
+        double start = now_seconds();
+        get_zones_by_codes((const geohex_code_t *) codes, CODES, exact);
+        double slow = now_seconds() - start;
+
+        start = now_seconds();
+        get_zones_by_codes_fast((const geohex_code_t *) codes, CODES, fast);
+        double quick = now_seconds() - start;
+
+        for (size_t i = 0; i < CODES; i++) {
+            error = fmax(error, fabs(exact[i].latlon.lat - fast[i].latlon.lat));
+        }
+        printf("%6u %14.1f %14.1f %12.2e\n", level, slow * 1e9 / CODES, quick * 1e9 / CODES, error);
+    }
+
+    free(fast);
+    free(exact);
+    free(codes);
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/grid.h"
+
+#define HALF_WIDTH  500
+
+typedef struct {
+    size_t n;
+    double checksum;
+} sink_t;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static void consume(void *arg, const zone_t *zones, size_t n)
+{
+    sink_t *sink = arg;
+
+    for (size_t i = 0; i < n; i++) {
+        sink->checksum += zones[i].latlon.lat + zones[i].code[zones[i].xy.x & 7];
+    }
+    sink->n += n;
+}
+
+int main(void)
+{
+    loc_t tokyo = {139.7671, 35.6812};
+    xy_t origin = {0, 0, false};
+
+    printf("%6s %10s %16s %16s %8s\n", "level", "zones", "per-cell ns/zone", "grid ns/zone", "speedup");
+
+    for (uint32_t level = 9; level <= 11; level++) {
+        sink_t cells = {0}, grid = {0};
+        xy_t center;
+        ij_t ij;
+
+        get_xy_by_location(&tokyo, level, &center);
+        get_local_ij(&origin, &center, level, &ij);
+
+        /* a get_zone_by_xy() for every cell of the same range */
+        double start = now_seconds();
+        for (int32_t y = ij.j - HALF_WIDTH; y <= ij.j + HALF_WIDTH; y++) {
+            zone_t zone;
+
+            for (int32_t x = ij.i - HALF_WIDTH; x <= ij.i + HALF_WIDTH; x++) {
+                xy_t xy;
+
+                adjust_xy(x, y, level, &xy);
+                get_zone_by_xy(&xy, level, &zone);
+                consume(&cells, &zone, 1);
+            }
+        }
+        double per_cell = now_seconds() - start;
+
+        start = now_seconds();
+        geohex_grid_rect(ij.i - HALF_WIDTH, ij.j - HALF_WIDTH, ij.i + HALF_WIDTH, ij.j + HALF_WIDTH, level, consume, &grid);
+        double walk = now_seconds() - start;
+
+        printf("%6u %10zu %16.1f %16.1f %7.1fx\n", level, grid.n, per_cell * 1e9 / cells.n, walk * 1e9 / grid.n, per_cell / walk);
+        if (fabs(cells.checksum - grid.checksum) > 1e-6 * fabs(cells.checksum)) {
+            printf("checksum mismatch\n");
+            return 1;
+        }
+    }
+
+    return 0;
+}
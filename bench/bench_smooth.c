@@ -0,0 +1,166 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/smooth.h"
+
+#include "idmap.h"
+
+#define ZONES       1000000
+#define MAX_RADIUS  3
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/* the k-ring way: a hash probe for every zone of every disk */
+static double smooth_by_disks(const geohex_id_t *ids, const double *values, size_t n, const double *kernel, uint32_t radius, double *out)
+{
+    geohex_idmap_t map;
+    uint32_t reach = 2 * radius;
+    xy_t *disk = malloc(GEOHEX_DISK_SIZE(reach) * sizeof(xy_t));
+    double *weights = calloc(GEOHEX_DISK_SIZE(reach), sizeof(double));
+    int32_t r = (int32_t) radius;
+    xy_t origin = {0, 0, false};
+    double start;
+
+    /* weight of each disk position, folded from the three axis passes */
+    get_xy_disk(&origin, MAX_LEVEL, reach, disk);
+    for (int32_t a = -r; a <= r; a++) {
+        for (int32_t b = -r; b <= r; b++) {
+            for (int32_t c = -r; c <= r; c++) {
+                for (size_t k = 0; k < GEOHEX_DISK_SIZE(reach); k++) {
+                    if (disk[k].x == a + c && disk[k].y == b + c) {
+                        weights[k] += kernel[abs(a)] * kernel[abs(b)] * kernel[abs(c)];
+                    }
+                }
+            }
+        }
+    }
+
+    start = now_seconds();
+    geohex_idmap_init(&map, n);
+    for (size_t i = 0; i < n; i++) {
+        bool inserted;
+        xy_t xy;
+
+        get_xy_by_id(ids[i], &xy);
+        *geohex_idmap_insert(&map, idmap_xy_key(xy.x, xy.y), &inserted) = i;
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint32_t level = get_level_by_id(ids[i]);
+        double sum = 0;
+        xy_t xy;
+
+        get_xy_by_id(ids[i], &xy);
+        get_xy_disk(&xy, level, reach, disk);
+        for (size_t k = 0; k < GEOHEX_DISK_SIZE(reach); k++) {
+            size_t *slot = geohex_idmap_find(&map, idmap_xy_key(disk[k].x, disk[k].y));
+
+            if (slot) {
+                sum += weights[k] * values[*slot];
+            }
+        }
+        out[i] = sum;
+    }
+    double elapsed = now_seconds() - start;
+
+    geohex_idmap_free(&map);
+    free(weights);
+    free(disk);
+
+    return elapsed;
+}
+
+int main(void)
+{
+    geohex_id_t *ids = malloc(ZONES * sizeof(geohex_id_t));
+    double *values = malloc(ZONES * sizeof(double));
+    double *expected = malloc(ZONES * sizeof(double));
+    double *out = malloc(ZONES * sizeof(double));
+    xy_t *disk = malloc(GEOHEX_DISK_SIZE(576) * sizeof(xy_t));
+    loc_t tokyo = {139.7, 35.68};
+    uint32_t seed = 1;
+
+    printf("%8s %6s %14s %14s %10s\n", "layout", "radius", "disks ns/zone", "smooth ns/zone", "max error");
+
+    for (int layout = 0; layout < 2; layout++) {
+        size_t n;
+
+        if (layout == 0) {
+            /* a solid city-sized heatmap at level 11 */
+            xy_t center;
+
+            get_xy_by_location(&tokyo, 11, &center);
+            n = get_xy_disk(&center, 11, 576, disk);
+            for (size_t i = 0; i < n; i++) {
+                get_id_by_xy(&disk[i], 11, &ids[i]);
+            }
+        } else {
+            /* the same number of zones scattered over a country */
+            n = ZONES;
+            for (size_t i = 0; i < n; i++) {
+                loc_t loc;
+                xy_t xy;
+
+                seed = seed * 1664525u + 1013904223u;
+                loc.lon = 130.0 + 12.0 * (double) (seed >> 8) / 16777216.0;
+                seed = seed * 1664525u + 1013904223u;
+                loc.lat = 31.0 + 10.0 * (double) (seed >> 8) / 16777216.0;
+                get_xy_by_location(&loc, 11, &xy);
+                get_id_by_xy(&xy, 11, &ids[i]);
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            values[i] = (double) (seed >> 24);
+        }
+
+        for (uint32_t radius = 1; radius <= MAX_RADIUS; radius++) {
+            double kernel[MAX_RADIUS + 1], error = 0;
+
+            geohex_smooth_gaussian(0.8 * radius, radius, kernel);
+            double disks = smooth_by_disks(ids, values, n, kernel, radius, expected);
+
+            double start = now_seconds();
+            geohex_smooth(ids, values, n, kernel, radius, out);
+            double smooth = now_seconds() - start;
+
+            for (size_t i = 0; i < n; i++) {
+                error = fmax(error, fabs(out[i] - expected[i]));
+            }
+            printf("%8s %6u %14.1f %14.1f %10.2e\n", layout ? "sparse" : "dense", radius, disks * 1e9 / n, smooth * 1e9 / n, error);
+        }
+    }
+
+    free(disk);
+    free(out);
+    free(expected);
+    free(values);
+    free(ids);
+
+    return 0;
+}
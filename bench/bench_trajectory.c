@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "geohex/geohex.h"
+#include "geohex/trajectory.h"
+
+#define POINTS  1000000
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+    double *lon = malloc(POINTS * sizeof(double));
+    double *lat = malloc(POINTS * sizeof(double));
+    zone_t *out = malloc(POINTS * sizeof(zone_t));
+    uint32_t seed = 1;
+
+    printf("%6s %12s %12s %8s %8s\n", "level", "plain ns/pt", "trace ns/pt", "hit %", "step %");
+
+    for (uint32_t level = 5; level <= 13; level += 2) {
+        /* a vehicle moving about a tenth of a zone per fix */
+        double stride = 0.1 * 180.0 / pow(3.0, level + 3), heading = 0;
+        geohex_trajectory_t trajectory;
+
+        lon[0] = 139.7;
+        lat[0] = 35.68;
+        for (uint32_t i = 1; i < POINTS; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            heading += ((double) (seed >> 8) / 16777216.0 - 0.5) * 0.5;
+            lon[i] = lon[i - 1] + stride * cos(heading);
+            lat[i] = lat[i - 1] + stride * sin(heading);
+        }
+
+        double start = now_seconds();
+        for (uint32_t i = 0; i < POINTS; i++) {
+            loc_t loc = {lon[i], lat[i]};
+
+            get_zone_by_location(&loc, level, &out[i]);
+        }
+        double plain = now_seconds() - start;
+
+        geohex_trajectory_init(&trajectory, level);
+        start = now_seconds();
+        geohex_trajectory_encode_batch(&trajectory, lon, lat, POINTS, out);
+        double trace = now_seconds() - start;
+
+        printf("%6u %12.1f %12.1f %8.1f %8.1f\n", level, plain * 1e9 / POINTS, trace * 1e9 / POINTS,
+               100.0 * trajectory.hits / POINTS, 100.0 * trajectory.steps / POINTS);
+    }
+
+    free(out);
+    free(lat);
+    free(lon);
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_AGG_H
+#define GEOHEX_AGG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+#include "geohex/parallel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint64_t count;
+    double sum;
+    double min;
+    double max;
+} geohex_stats_t;
+
+typedef struct {
+    geohex_id_t id;
+    geohex_stats_t stats;
+} geohex_agg_entry_t;
+
+/* Seconds spent in each phase, summed over all workers. */
+typedef struct {
+    double encode;
+    double accumulate;
+    double merge;
+} geohex_agg_timings_t;
+
+typedef struct _geohex_agg_t geohex_agg_t;
+
+/*
+ * Points are accumulated at max_level only. Coarser levels down to min_level
+ * are derived on demand by folding each zone into its code-prefix parent, so
+ * a coarse zone holds the points whose fine zone descends from it.
+ */
+geohex_agg_t *geohex_agg_create(uint32_t min_level, uint32_t max_level);
+void geohex_agg_destroy(geohex_agg_t *agg);
+void geohex_agg_clear(geohex_agg_t *agg);
+
+bool geohex_agg_add(geohex_agg_t *agg, const loc_t *location, double value);
+/* value may be NULL, in which case every point contributes 1.0. */
+bool geohex_agg_add_batch(geohex_agg_t *agg, const double *lon, const double *lat, const double *value, size_t n);
+/*
+ * Sharded mode: every worker accumulates into a private table, and the tables
+ * are merged by radix partitioning their zone ids once the batch is done.
+ * timings may be NULL.
+ */
+bool geohex_agg_add_batch_parallel(geohex_agg_t *agg, const geohex_executor_t *executor, const double *lon, const double *lat, const double *value, size_t n, geohex_agg_timings_t *timings);
+
+size_t geohex_agg_size(geohex_agg_t *agg, uint32_t level);
+/* Writes the zones of level sorted by id; fails when capacity is short. */
+bool geohex_agg_export(geohex_agg_t *agg, uint32_t level, geohex_agg_entry_t *out, size_t capacity, size_t *written);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_AGG_H */
@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_CODEC_H
+#define GEOHEX_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Delta + group varint encoding of sorted packed zone ids. When every id has
+ * the same level the deltas are taken between zone indices at that level
+ * rather than between raw ids, so neighbouring zones cost a byte or two.
+ */
+typedef struct {
+    const uint8_t *cursor;
+    const uint8_t *end;
+    uint64_t count;
+    uint64_t remaining;
+    uint64_t previous;
+    uint32_t level;
+    bool uniform;
+    bool error;
+    uint32_t buffered;
+    uint32_t position;
+    geohex_id_t buffer[4];
+} geohex_decoder_t;
+
+/* Upper bound of the encoded size of n ids. */
+size_t geohex_codec_bound(size_t n);
+/* ids must be sorted in ascending order. */
+bool geohex_codec_encode(const geohex_id_t *ids, size_t n, uint8_t *buf, size_t capacity, size_t *written);
+
+/* Decodes incrementally, one group of four ids at a time. */
+bool geohex_decoder_init(geohex_decoder_t *decoder, const uint8_t *buf, size_t len);
+bool geohex_decoder_next(geohex_decoder_t *decoder, geohex_id_t *out);
+/* Returns the number of ids written; check decoder->error on a short read. */
+size_t geohex_decoder_read(geohex_decoder_t *decoder, geohex_id_t *out, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_CODEC_H */
@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_COMPONENTS_H
+#define GEOHEX_COMPONENTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+#include "geohex/parallel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Groups zones of one level that connect through shared edges, across the
+ * antimeridian too. labels[i] receives the component of ids[i]; components
+ * are numbered from 0 in order of their first zone in ids. sizes, if not
+ * NULL, must hold n counts and receives the distinct zones of each
+ * component. Duplicate ids share a label and are counted once.
+ */
+bool geohex_components(const geohex_id_t *ids, size_t n, uint32_t *labels, size_t *sizes, size_t *count);
+bool geohex_components_parallel(const geohex_executor_t *executor, const geohex_id_t *ids, size_t n, uint32_t *labels, size_t *sizes, size_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_COMPONENTS_H */
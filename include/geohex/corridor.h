@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_CORRIDOR_H
+#define GEOHEX_CORRIDOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*geohex_corridor_fn)(void *arg, const geohex_id_t *ids, size_t n);
+
+/*
+ * Every zone of level within buffer steps of a zone the polyline passes
+ * through, each passed to fn once, in blocks, as the line is walked.
+ * Segments are straight in Web Mercator and take the shorter way across the
+ * antimeridian. A single vertex covers the zones around that point.
+ */
+bool geohex_corridor_cover(const loc_t *vertices, size_t n, uint32_t level, uint32_t buffer, geohex_corridor_fn fn, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_CORRIDOR_H */
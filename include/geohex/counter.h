@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_COUNTER_H
+#define GEOHEX_COUNTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    geohex_id_t id;
+    uint64_t count;
+} geohex_counter_entry_t;
+
+typedef struct _geohex_counter_t geohex_counter_t;
+
+/*
+ * Concurrent per-zone counter for up to capacity distinct zones. Adds are
+ * lock-free (a CAS claims a linear probing slot once per zone, after which
+ * increments are a single fetch-add) and may run from any number of threads.
+ * Reads never block or retry: a snapshot reports, for every zone, a count it
+ * held at some point during the scan.
+ */
+geohex_counter_t *geohex_counter_create(size_t capacity);
+void geohex_counter_destroy(geohex_counter_t *counter);
+
+/*
+ * Fails when id is GEOHEX_ID_INVALID or the counter is full. A new zone
+ * takes a ticket on the size before its slot is claimed, so the limit is
+ * exact; close to capacity, a new zone may be turned away while another
+ * thread's losing claim still holds its ticket. A delta of 0 succeeds
+ * without storing the zone.
+ */
+bool geohex_counter_add(geohex_counter_t *counter, geohex_id_t id, uint64_t delta);
+uint64_t geohex_counter_get(const geohex_counter_t *counter, geohex_id_t id);
+size_t geohex_counter_size(const geohex_counter_t *counter);
+/* Returns the number of entries written, at most capacity. */
+size_t geohex_counter_snapshot(const geohex_counter_t *counter, geohex_counter_entry_t *out, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_COUNTER_H */
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_DISSOLVE_H
+#define GEOHEX_DISSOLVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Rings back to back, ring_sizes[i] vertices each and closed implicitly, in
+ * the layout geohex_geofence_add() takes. Outer rings run counter-clockwise
+ * and holes clockwise; under the even-odd rule they cover the union.
+ */
+typedef struct {
+    loc_t *vertices;
+    size_t *ring_sizes;
+    size_t rings;
+    size_t vertex_count;
+} geohex_outline_t;
+
+/*
+ * Outlines the union of zones of one level; duplicate ids are ignored. A ring
+ * crossing the antimeridian continues past +-180 degrees so that its edges
+ * stay short.
+ */
+bool geohex_dissolve(const geohex_id_t *ids, size_t n, geohex_outline_t *out);
+void geohex_outline_free(geohex_outline_t *outline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_DISSOLVE_H */
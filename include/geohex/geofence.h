@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_GEOFENCE_H
+#define GEOHEX_GEOFENCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GEOHEX_GEOFENCE_NONE UINT32_MAX
+
+typedef struct _geohex_geofence_t geohex_geofence_t;
+
+/*
+ * Polygons are rasterized into the zones of level. Zones lying fully inside a
+ * polygon answer a query directly; zones crossed by its outline keep the
+ * nearby edges and settle the point exactly. Polygons are tested in Web
+ * Mercator with the even-odd rule and must not cross the antimeridian.
+ */
+geohex_geofence_t *geohex_geofence_create(uint32_t level);
+void geohex_geofence_destroy(geohex_geofence_t *fence);
+
+/*
+ * vertices holds rings back to back, ring_sizes[i] vertices each; rings are
+ * closed implicitly and later rings cut holes. Fence ids count up from 0.
+ */
+bool geohex_geofence_add(geohex_geofence_t *fence, const loc_t *vertices, const size_t *ring_sizes, size_t rings, uint32_t *fence_id);
+/* Builds the zone lookup; no fence can be added afterwards. */
+bool geohex_geofence_compile(geohex_geofence_t *fence);
+
+/* Writes the ids of every fence containing location, ascending; fails when capacity is short. */
+bool geohex_geofence_query(const geohex_geofence_t *fence, const loc_t *location, uint32_t *out, size_t capacity, size_t *found);
+/* out[i] is the lowest fence id containing (lon[i], lat[i]) or GEOHEX_GEOFENCE_NONE. */
+bool geohex_geofence_query_batch(const geohex_geofence_t *fence, const double *lon, const double *lat, size_t n, uint32_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_GEOFENCE_H */
@@ -13,6 +13,7 @@
 #ifndef GEOHEX_H
 #define GEOHEX_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -28,7 +29,17 @@ extern "C" {
 #define MAX_H_DEC9_LEN  (4 + MAX_LEVEL)
 #define MAX_H_DEC3_LEN  (MAX_H_DEC9_LEN * 2)
 
+/*
+ * Packed zone id: the base-9 code digits (prefix letters expanded to their
+ * three digits) left-aligned to MAX_LEVEL + 3 digits, shifted above a 4 bit
+ * level field. Ordering ids numerically equals ordering codes by prefix, and
+ * every descendant of a zone sorts directly after it.
+ */
+#define GEOHEX_ID_LEVEL_BITS    4
+#define GEOHEX_ID_INVALID       UINT64_MAX
+
 typedef char geohex_code_t[MAX_CODE_LEN];
+typedef uint64_t geohex_id_t;
 
 typedef struct {
     double lon;
@@ -50,10 +61,50 @@ typedef struct {
 bool adjust_xy(int32_t x, int32_t y, uint32_t level, xy_t *out);
 bool get_xy_by_location(const loc_t *location, uint32_t level, xy_t *out);
 bool get_xy_by_code(const geohex_code_t code, xy_t *out);
+
+/*
+ * Web Mercator meters as loc2xy() projects them, so a pipeline already in
+ * EPSG:3857 encodes and takes zone centres without a round trip through
+ * longitude and latitude. Batches read and write separate x and y arrays.
+ * A zone centred on the antimeridian has its centre at the west edge, matching
+ * the -180 longitude get_zone_by_xy() reports for it.
+ */
+bool get_xy_by_mercator(double dx, double dy, uint32_t level, xy_t *out);
+bool get_xys_by_mercator(const double *dx, const double *dy, size_t n, uint32_t level, xy_t *out);
+bool get_mercator_center_by_xy(const xy_t *xy, uint32_t level, double *dx, double *dy);
+bool get_mercator_centers_by_xys(const xy_t *xys, size_t n, uint32_t level, double *dx, double *dy);
+
+/*
+ * Batches of integer degrees times 1e7 (the OSM E7 format) in separate
+ * longitude and latitude arrays; the same zones as get_xy_by_location() on
+ * lon_e7[i] / 1e7 and lat_e7[i] / 1e7.
+ */
+bool get_xys_by_e7(const int32_t *lon_e7, const int32_t *lat_e7, size_t n, uint32_t level, xy_t *out);
+bool get_ids_by_e7(const int32_t *lon_e7, const int32_t *lat_e7, size_t n, uint32_t level, geohex_id_t *out);
+
 bool get_zone_by_location(const loc_t *location, uint32_t level, zone_t *out);
 bool get_zone_by_code(const geohex_code_t code, zone_t *out);
 bool get_zone_by_xy(const xy_t *xy, uint32_t level, zone_t *out);
 
+bool get_zones_by_locations(const loc_t *locations, size_t n, uint32_t level, zone_t *out);
+bool get_zones_by_codes(const geohex_code_t *codes, size_t n, zone_t *out);
+
+/*
+ * Same zones with the centre latitude interpolated from a table instead of
+ * exp() and atan(); it stays within 1e-10 degrees of the exact value.
+ */
+bool get_zone_by_xy_fast(const xy_t *xy, uint32_t level, zone_t *out);
+bool get_zone_by_code_fast(const geohex_code_t code, zone_t *out);
+bool get_zones_by_codes_fast(const geohex_code_t *codes, size_t n, zone_t *out);
+
+bool get_id_by_xy(const xy_t *xy, uint32_t level, geohex_id_t *out);
+bool get_id_by_code(const geohex_code_t code, geohex_id_t *out);
+bool get_code_by_id(geohex_id_t id, geohex_code_t out);
+bool get_xy_by_id(geohex_id_t id, xy_t *out);
+bool get_zone_by_id(geohex_id_t id, zone_t *out);
+uint32_t get_level_by_id(geohex_id_t id);
+bool get_parent_id(geohex_id_t id, uint32_t level, geohex_id_t *out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,47 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_GRID_H
+#define GEOHEX_GRID_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*geohex_grid_fn)(void *arg, const zone_t *zones, size_t n);
+
+/*
+ * Every lattice cell with x_min <= x <= x_max and y_min <= y <= y_max, as
+ * zones of level passed to fn in blocks, row by row of y. Coordinates are
+ * unwrapped, so a range may run across the antimeridian; a range wider than
+ * the globe passes its zones once per lap.
+ */
+bool geohex_grid_rect(int32_t x_min, int32_t y_min, int32_t x_max, int32_t y_max, uint32_t level, geohex_grid_fn fn, void *arg);
+
+/*
+ * Every zone of level whose centre lies inside the polygon, with rings laid
+ * out as for geohex_geofence_add(). Centres are tested in Web Mercator with
+ * the even-odd rule; the polygon must not cross the antimeridian.
+ */
+bool geohex_grid_polygon(const loc_t *vertices, const size_t *ring_sizes, size_t rings, uint32_t level, geohex_grid_fn fn, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_GRID_H */
@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_INDEX_H
+#define GEOHEX_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Read-only zone index file: sorted zone ids, each with an opaque payload.
+ * The file is mapped shared and read in place, so every process opening the
+ * same file shares its pages and opening costs a header check only.
+ */
+typedef struct _geohex_index_t geohex_index_t;
+
+typedef struct {
+    geohex_id_t id;
+    const void *data;
+    size_t size;
+} geohex_index_entry_t;
+
+/* Entries may be given in any order; duplicate ids are rejected. */
+bool geohex_index_write(const char *path, const geohex_index_entry_t *entries, size_t n);
+
+geohex_index_t *geohex_index_open(const char *path);
+void geohex_index_close(geohex_index_t *index);
+size_t geohex_index_size(const geohex_index_t *index);
+
+/* On success *data points into the mapping and stays valid until close. */
+bool geohex_index_lookup_id(const geohex_index_t *index, geohex_id_t id, const void **data, size_t *size);
+bool geohex_index_lookup(const geohex_index_t *index, const geohex_code_t code, const void **data, size_t *size);
+bool geohex_index_lookup_xy(const geohex_index_t *index, const xy_t *xy, uint32_t level, const void **data, size_t *size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_INDEX_H */
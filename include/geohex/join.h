@@ -0,0 +1,52 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_JOIN_H
+#define GEOHEX_JOIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+#include "geohex/parallel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Indices into the two point sets and their great-circle distance in meters. */
+typedef struct {
+    size_t a;
+    size_t b;
+    double distance;
+} geohex_join_pair_t;
+
+/*
+ * Receives the pairs found by one worker. Different workers may call it at
+ * the same time, each with its own worker index.
+ */
+typedef void (*geohex_join_fn)(void *arg, const geohex_join_pair_t *pairs, size_t n, uint32_t worker);
+
+/*
+ * Reports every pair of points from A and B at most meters apart on a sphere
+ * of mean Earth radius. A is bucketed by zone at a level picked from meters
+ * and the latitudes involved; each point of B then probes the zones around
+ * its own. executor may be NULL to run on the calling thread.
+ */
+bool geohex_join_within(const geohex_executor_t *executor, const double *a_lon, const double *a_lat, size_t na, const double *b_lon, const double *b_lat, size_t nb, double meters, geohex_join_fn fn, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_JOIN_H */
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_KNN_H
+#define GEOHEX_KNN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* distance is measured in Web Mercator meters from the query to the zone centre. */
+typedef struct {
+    geohex_id_t id;
+    double distance;
+} geohex_knn_result_t;
+
+typedef struct _geohex_knn_t geohex_knn_t;
+
+/* An index over occupied zones of one level; duplicate ids are merged. */
+geohex_knn_t *geohex_knn_create(uint32_t level, const geohex_id_t *ids, size_t n);
+void geohex_knn_destroy(geohex_knn_t *knn);
+size_t geohex_knn_size(const geohex_knn_t *knn);
+
+/*
+ * Writes the k occupied zones nearest to location, nearest first, measured
+ * across the antimeridian where that is shorter. Rings of zones around the
+ * query are probed until no further ring can improve the k-th distance.
+ */
+bool geohex_knn_search(const geohex_knn_t *knn, const loc_t *location, size_t k, geohex_knn_result_t *out, size_t *found);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_KNN_H */
@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_LATTICE_H
+#define GEOHEX_LATTICE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Offset of a zone from an anchor zone, on the same axes as xy_t. */
+typedef struct {
+    int32_t i;
+    int32_t j;
+} ij_t;
+
+/* Number of zones within radius steps of a zone, itself included. */
+#define GEOHEX_DISK_SIZE(radius) (3 * (size_t) (radius) * ((size_t) (radius) + 1) + 1)
+
+/*
+ * Zones of one level adjoin their six neighbours at xy + (1, 1), (0, 1),
+ * (-1, 0), (-1, -1), (0, -1) and (1, 0). Results are wrapped across the
+ * antimeridian with adjust_xy(); a radius spanning half the globe or more
+ * yields duplicates.
+ */
+bool get_xy_neighbors(const xy_t *xy, uint32_t level, xy_t out[6]);
+/* Zones exactly radius steps away, 6 * radius of them (1 for radius 0). */
+size_t get_xy_ring(const xy_t *xy, uint32_t level, uint32_t radius, xy_t *out);
+/* Zones at most radius steps away, ring by ring, GEOHEX_DISK_SIZE(radius) of them. */
+size_t get_xy_disk(const xy_t *xy, uint32_t level, uint32_t radius, xy_t *out);
+/* Steps between two zones of level, the shorter way around the antimeridian. */
+bool get_xy_distance(const xy_t *a, const xy_t *b, uint32_t level, uint32_t *out);
+
+/*
+ * The offset from anchor to xy, taken the shorter way around the
+ * antimeridian, so nearby zones get small offsets that can index a dense
+ * array. get_xy_by_local_ij() turns an offset back into the zone.
+ */
+bool get_local_ij(const xy_t *anchor, const xy_t *xy, uint32_t level, ij_t *out);
+bool get_xy_by_local_ij(const xy_t *anchor, const ij_t *ij, uint32_t level, xy_t *out);
+
+/*
+ * The zone dx, dy (each -1, 0 or 1) steps away along the lattice axes,
+ * stepped on the code digits with a balanced ternary carry. Matches
+ * get_xy_by_code(), an offset and get_zone_by_xy() without the projection.
+ */
+bool get_code_step(const geohex_code_t code, int32_t dx, int32_t dy, geohex_code_t out);
+bool get_id_step(geohex_id_t id, int32_t dx, int32_t dy, geohex_id_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_LATTICE_H */
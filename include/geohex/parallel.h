@@ -0,0 +1,59 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_PARALLEL_H
+#define GEOHEX_PARALLEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Processes items [begin, end); worker is in [0, executor workers). */
+typedef void (*geohex_task_fn)(void *arg, size_t begin, size_t end, uint32_t worker);
+
+/*
+ * parallel_for must call task over disjoint ranges covering [0, n) and return
+ * once all of them are done. A single worker index must never run two ranges
+ * at the same time.
+ */
+typedef struct {
+    uint32_t workers;
+    void (*parallel_for)(void *context, size_t n, geohex_task_fn task, void *arg);
+    void *context;
+} geohex_executor_t;
+
+typedef struct _geohex_pool_t geohex_pool_t;
+
+/*
+ * threads == 0 uses the number of online processors. A pool runs one batch
+ * at a time; geohex_pool_run() must not be re-entered from a task.
+ */
+geohex_pool_t *geohex_pool_create(uint32_t threads);
+void geohex_pool_destroy(geohex_pool_t *pool);
+uint32_t geohex_pool_size(const geohex_pool_t *pool);
+void geohex_pool_run(geohex_pool_t *pool, size_t n, geohex_task_fn task, void *arg);
+bool geohex_pool_executor(geohex_pool_t *pool, geohex_executor_t *out);
+
+bool get_zones_by_locations_parallel(const geohex_executor_t *executor, const loc_t *locations, size_t n, uint32_t level, zone_t *out);
+bool get_zones_by_codes_parallel(const geohex_executor_t *executor, const geohex_code_t *codes, size_t n, zone_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_PARALLEL_H */
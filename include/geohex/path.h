@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_PATH_H
+#define GEOHEX_PATH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GEOHEX_PATH_BLOCKED INFINITY
+
+typedef struct _geohex_path_t geohex_path_t;
+
+/*
+ * A* over the zones of one level. Entering a zone costs 1 unless set
+ * otherwise; the step distance times the lowest cost ever set guides the
+ * search and keeps it exact. The search state is kept between calls, so a
+ * warmed-up finder allocates nothing.
+ */
+geohex_path_t *geohex_path_create(uint32_t level);
+void geohex_path_destroy(geohex_path_t *path);
+
+/* cost must be positive; GEOHEX_PATH_BLOCKED makes id an obstacle. */
+bool geohex_path_set_cost(geohex_path_t *path, geohex_id_t id, double cost);
+
+/*
+ * Writes the cheapest path from from to to, both included, and its cost.
+ * *length is 0 when to cannot be reached within max_expansions zones (0 for
+ * no limit). Fails with the needed *length when capacity is short.
+ */
+bool geohex_path_find(geohex_path_t *path, geohex_id_t from, geohex_id_t to, size_t max_expansions, geohex_id_t *out, size_t capacity, size_t *length, double *cost);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_PATH_H */
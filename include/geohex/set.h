@@ -0,0 +1,52 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_SET_H
+#define GEOHEX_SET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Zone sets are sorted arrays of packed ids where no id descends from another.
+ * A coarse id stands for its whole code-prefix range of descendants, so sets
+ * of mixed levels combine correctly: a level 5 zone intersected with its level
+ * 10 descendants yields those descendants.
+ *
+ * The operations return the size of the result and write it to out, which
+ * must be large enough (na + nb suffices for union and intersection). Pass
+ * out as NULL to only compute the size.
+ */
+bool geohex_set_normalize(geohex_id_t *ids, size_t n, size_t *out_n);
+
+size_t geohex_set_union(const geohex_id_t *a, size_t na, const geohex_id_t *b, size_t nb, geohex_id_t *out);
+size_t geohex_set_intersection(const geohex_id_t *a, size_t na, const geohex_id_t *b, size_t nb, geohex_id_t *out);
+/* A coarse zone of a that is partly removed is split into its children. */
+size_t geohex_set_difference(const geohex_id_t *a, size_t na, const geohex_id_t *b, size_t nb, geohex_id_t *out);
+
+/* True when id or one of its ancestors is in the set. */
+bool geohex_set_contains(const geohex_id_t *set, size_t n, geohex_id_t id);
+/* True when every zone covered by a is also covered by b. */
+bool geohex_set_is_subset(const geohex_id_t *a, size_t na, const geohex_id_t *b, size_t nb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_SET_H */
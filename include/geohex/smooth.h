@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_SMOOTH_H
+#define GEOHEX_SMOOTH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Convolves per-zone values of one level with a hex kernel. kernel[0] to
+ * kernel[radius] are the taps of a symmetric filter run along each of the
+ * three lattice axes in turn, so the combined kernel reaches 2 * radius
+ * steps. out[i] receives the smoothed value at ids[i]. Zones missing from
+ * ids count as zero, so pass empty zones with value 0 to spread into them.
+ * Duplicate ids add up.
+ */
+bool geohex_smooth(const geohex_id_t *ids, const double *values, size_t n, const double *kernel, uint32_t radius, double *out);
+
+/* Taps whose three-axis product approximates a unit-sum Gaussian of sigma steps. */
+bool geohex_smooth_gaussian(double sigma, uint32_t radius, double *kernel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_SMOOTH_H */
@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_SORT_H
+#define GEOHEX_SORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+#include "geohex/parallel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Radix sorts for packed zone ids. Ids sort in code-prefix order, so every
+ * zone is directly followed by its descendants. scratch must hold n ids, or
+ * be NULL to have one allocated.
+ */
+bool geohex_sort_ids(geohex_id_t *ids, size_t n, geohex_id_t *scratch);
+void geohex_sort_ids_inplace(geohex_id_t *ids, size_t n);
+/* Sorts and drops duplicates; *out_n receives the unique count. */
+bool geohex_sort_unique_ids(geohex_id_t *ids, size_t n, geohex_id_t *scratch, size_t *out_n);
+bool geohex_sort_ids_parallel(const geohex_executor_t *executor, geohex_id_t *ids, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_SORT_H */
@@ -0,0 +1,58 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_TRACKER_H
+#define GEOHEX_TRACKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * An object left zone from and entered zone to. from is GEOHEX_ID_INVALID
+ * for an object seen the first time, to is GEOHEX_ID_INVALID on removal.
+ */
+typedef struct {
+    uint64_t object;
+    geohex_id_t from;
+    geohex_id_t to;
+} geohex_tracker_event_t;
+
+typedef void (*geohex_tracker_fn)(void *arg, const geohex_tracker_event_t *events, size_t n);
+
+typedef struct _geohex_tracker_t geohex_tracker_t;
+
+/*
+ * Current zone of every object at level. Each object keeps the lon/lat box
+ * inscribed in its zone, so an update inside the box costs one hash probe
+ * and four comparisons; only objects leaving it are encoded again.
+ */
+geohex_tracker_t *geohex_tracker_create(uint32_t level, size_t capacity_hint);
+void geohex_tracker_destroy(geohex_tracker_t *tracker);
+size_t geohex_tracker_size(const geohex_tracker_t *tracker);
+
+/* Zone changes are passed to fn in blocks, in input order; fn may be NULL. */
+bool geohex_tracker_update(geohex_tracker_t *tracker, const uint64_t *objects, const double *lon, const double *lat, size_t n, geohex_tracker_fn fn, void *arg);
+bool geohex_tracker_remove(geohex_tracker_t *tracker, const uint64_t *objects, size_t n, geohex_tracker_fn fn, void *arg);
+bool geohex_tracker_get(const geohex_tracker_t *tracker, uint64_t object, geohex_id_t *zone);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_TRACKER_H */
@@ -0,0 +1,58 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_TRAJECTORY_H
+#define GEOHEX_TRAJECTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Encodes an ordered point sequence, remembering the last zone. A point still
+ * inside the lon/lat box inscribed in that zone reuses it as is; a point that
+ * moved into a neighbouring zone is found by testing the six neighbours
+ * before falling back to get_zone_by_location(). Results are identical to
+ * get_zone_by_location() for every point.
+ */
+typedef struct {
+    uint32_t level;
+    double h_size;
+    bool valid;
+    zone_t zone;
+    double lon_min;
+    double lon_max;
+    double lat_min;
+    double lat_max;
+    uint64_t hits;
+    uint64_t steps;
+    uint64_t misses;
+} geohex_trajectory_t;
+
+bool geohex_trajectory_init(geohex_trajectory_t *trajectory, uint32_t level);
+/* Forgets the last zone, e.g. between unrelated traces. */
+void geohex_trajectory_reset(geohex_trajectory_t *trajectory);
+
+bool geohex_trajectory_encode(geohex_trajectory_t *trajectory, const loc_t *location, zone_t *out);
+bool geohex_trajectory_encode_batch(geohex_trajectory_t *trajectory, const double *lon, const double *lat, size_t n, zone_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_TRAJECTORY_H */
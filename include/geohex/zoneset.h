@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_ZONESET_H
+#define GEOHEX_ZONESET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Compressed set of packed zone ids. Zones are bucketed by level and code
+ * prefix; the last 5 code digits of a zone index into its bucket, which is
+ * stored as a sorted array, a bitmap or a list of runs, whichever is smallest.
+ * Membership is exact: a zone does not imply its descendants.
+ */
+typedef struct _geohex_zoneset_t geohex_zoneset_t;
+
+typedef struct {
+    const geohex_zoneset_t *set;
+    size_t container;
+    uint32_t position;
+    uint32_t offset;
+} geohex_zoneset_iter_t;
+
+geohex_zoneset_t *geohex_zoneset_create(void);
+void geohex_zoneset_destroy(geohex_zoneset_t *set);
+
+bool geohex_zoneset_add(geohex_zoneset_t *set, geohex_id_t id);
+bool geohex_zoneset_add_many(geohex_zoneset_t *set, const geohex_id_t *ids, size_t n);
+bool geohex_zoneset_contains(const geohex_zoneset_t *set, geohex_id_t id);
+size_t geohex_zoneset_size(const geohex_zoneset_t *set);
+/* Re-encodes every bucket with its smallest container, run lists included. */
+bool geohex_zoneset_optimize(geohex_zoneset_t *set);
+
+/* Iterates level by level, each level in id order. */
+void geohex_zoneset_iter_init(const geohex_zoneset_t *set, geohex_zoneset_iter_t *iter);
+bool geohex_zoneset_iter_next(geohex_zoneset_iter_t *iter, geohex_id_t *out);
+
+geohex_zoneset_t *geohex_zoneset_union(const geohex_zoneset_t *a, const geohex_zoneset_t *b);
+geohex_zoneset_t *geohex_zoneset_intersection(const geohex_zoneset_t *a, const geohex_zoneset_t *b);
+
+/* Little-endian byte format, identical on every host. */
+size_t geohex_zoneset_serialized_size(const geohex_zoneset_t *set);
+bool geohex_zoneset_serialize(const geohex_zoneset_t *set, uint8_t *buf, size_t capacity, size_t *written);
+geohex_zoneset_t *geohex_zoneset_deserialize(const uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GEOHEX_ZONESET_H */
@@ -0,0 +1,515 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "geohex/geohex.h"
+#include "geohex/agg.h"
+
+#include "idmap.h"
+
+#define AGG_BLOCK           256
+#define AGG_MAX_PARTITIONS  1024
+#define AGG_CACHE_LINE      64
+
+typedef struct {
+    geohex_idmap_t map;
+    geohex_agg_entry_t *entries;
+    size_t size;
+    size_t capacity;
+} agg_level_t;
+
+struct _geohex_agg_t {
+    uint32_t min_level;
+    uint32_t max_level;
+    bool dirty;
+    agg_level_t levels[MAX_LEVEL + 1];
+};
+
+typedef struct {
+    agg_level_t table;
+    geohex_agg_entry_t *scatter;
+    size_t *offsets;
+    geohex_agg_timings_t timings;
+    bool failed;
+    char pad[AGG_CACHE_LINE];
+} agg_shard_t;
+
+typedef struct {
+    const double *lon;
+    const double *lat;
+    const double *value;
+    uint32_t level;
+    agg_shard_t *shards;
+    uint32_t shard_count;
+    agg_level_t *parts;
+    uint32_t partition_bits;
+    agg_level_t *finest;
+    size_t *part_offsets;
+} agg_shard_job_t;
+
+static inline double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static inline void stats_merge(geohex_stats_t *dst, const geohex_stats_t *src) {
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->min < dst->min) {
+        dst->min = src->min;
+    }
+    if (src->max > dst->max) {
+        dst->max = src->max;
+    }
+}
+
+static geohex_stats_t *level_upsert(agg_level_t *lv, geohex_id_t id, bool *inserted) {
+    /* grow first, so a key in the map always indexes an assigned entry */
+    if (lv->size == lv->capacity) {
+        size_t capacity = lv->capacity ? lv->capacity * 2 : 64;
+        geohex_agg_entry_t *entries = realloc(lv->entries, capacity * sizeof(geohex_agg_entry_t));
+
+        if (!entries) {
+            return NULL;
+        }
+
+        lv->entries = entries;
+        lv->capacity = capacity;
+    }
+
+    size_t *index = geohex_idmap_insert(&lv->map, id, inserted);
+
+    if (!index) {
+        return NULL;
+    }
+
+    if (*inserted) {
+        *index = lv->size++;
+        lv->entries[*index].id = id;
+    }
+
+    return &lv->entries[*index].stats;
+}
+
+static bool level_merge(agg_level_t *lv, geohex_id_t id, const geohex_stats_t *stats) {
+    bool inserted;
+    geohex_stats_t *dst = level_upsert(lv, id, &inserted);
+
+    if (!dst) {
+        return false;
+    }
+
+    if (inserted) {
+        *dst = *stats;
+    } else {
+        stats_merge(dst, stats);
+    }
+
+    return true;
+}
+
+static bool level_add(agg_level_t *lv, geohex_id_t id, double value) {
+    geohex_stats_t stats = {1, value, value, value};
+
+    return level_merge(lv, id, &stats);
+}
+
+static void level_reset(agg_level_t *lv) {
+    geohex_idmap_clear(&lv->map);
+    lv->size = 0;
+}
+
+static void level_free(agg_level_t *lv) {
+    geohex_idmap_free(&lv->map);
+    free(lv->entries);
+}
+
+static bool rollup(geohex_agg_t *agg) {
+    if (!agg->dirty) {
+        return true;
+    }
+
+    for (uint32_t level = agg->max_level; level > agg->min_level; level--) {
+        agg_level_t *src = &agg->levels[level];
+        agg_level_t *dst = &agg->levels[level - 1];
+
+        level_reset(dst);
+
+        for (size_t i = 0; i < src->size; i++) {
+            geohex_id_t parent;
+
+            if (!get_parent_id(src->entries[i].id, level - 1, &parent) ||
+                !level_merge(dst, parent, &src->entries[i].stats)) {
+                return false;
+            }
+        }
+    }
+
+    agg->dirty = false;
+    return true;
+}
+
+static int compare_entry(const void *a, const void *b) {
+    geohex_id_t id_a = ((const geohex_agg_entry_t *) a)->id;
+    geohex_id_t id_b = ((const geohex_agg_entry_t *) b)->id;
+
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+geohex_agg_t *geohex_agg_create(uint32_t min_level, uint32_t max_level) {
+    if (min_level > max_level || max_level > MAX_LEVEL) {
+        return NULL;
+    }
+
+    geohex_agg_t *agg = calloc(1, sizeof(geohex_agg_t));
+    if (!agg) {
+        return NULL;
+    }
+
+    agg->min_level = min_level;
+    agg->max_level = max_level;
+
+    for (uint32_t level = min_level; level <= max_level; level++) {
+        if (!geohex_idmap_init(&agg->levels[level].map, 0)) {
+            geohex_agg_destroy(agg);
+            return NULL;
+        }
+    }
+
+    return agg;
+}
+
+void geohex_agg_destroy(geohex_agg_t *agg) {
+    if (!agg) {
+        return;
+    }
+
+    for (uint32_t level = agg->min_level; level <= agg->max_level; level++) {
+        level_free(&agg->levels[level]);
+    }
+
+    free(agg);
+}
+
+void geohex_agg_clear(geohex_agg_t *agg) {
+    if (!agg) {
+        return;
+    }
+
+    for (uint32_t level = agg->min_level; level <= agg->max_level; level++) {
+        level_reset(&agg->levels[level]);
+    }
+
+    agg->dirty = false;
+}
+
+bool geohex_agg_add(geohex_agg_t *agg, const loc_t *location, double value) {
+    if (!agg || !location) {
+        return false;
+    }
+
+    xy_t xy;
+    geohex_id_t id;
+
+    if (!get_xy_by_location(location, agg->max_level, &xy) ||
+        !get_id_by_xy(&xy, agg->max_level, &id)) {
+        return false;
+    }
+
+    agg->dirty = true;
+    return level_add(&agg->levels[agg->max_level], id, value);
+}
+
+bool geohex_agg_add_batch(geohex_agg_t *agg, const double *lon, const double *lat, const double *value, size_t n) {
+    if (!agg || (n && (!lon || !lat))) {
+        return false;
+    }
+
+    agg_level_t *lv = &agg->levels[agg->max_level];
+
+    agg->dirty = true;
+
+    for (size_t i = 0; i < n; i++) {
+        loc_t location = {lon[i], lat[i]};
+        xy_t xy;
+        geohex_id_t id;
+
+        if (!get_xy_by_location(&location, agg->max_level, &xy) ||
+            !get_id_by_xy(&xy, agg->max_level, &id) ||
+            !level_add(lv, id, value ? value[i] : 1.0)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static inline size_t partition_of(geohex_id_t id, uint32_t bits) {
+    return bits ? (size_t) (idmap_hash(id) >> (64 - bits)) : 0;
+}
+
+static void shard_accumulate_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    agg_shard_job_t *job = arg;
+    agg_shard_t *shard = &job->shards[worker];
+    geohex_id_t ids[AGG_BLOCK];
+
+    for (size_t base = begin; base < end && !shard->failed; base += AGG_BLOCK) {
+        size_t m = end - base < AGG_BLOCK ? end - base : AGG_BLOCK;
+        double t0 = now_seconds();
+
+        for (size_t i = 0; i < m; i++) {
+            loc_t location = {job->lon[base + i], job->lat[base + i]};
+            xy_t xy;
+
+            if (!get_xy_by_location(&location, job->level, &xy) ||
+                !get_id_by_xy(&xy, job->level, &ids[i])) {
+                shard->failed = true;
+                m = i;
+                break;
+            }
+        }
+
+        double t1 = now_seconds();
+
+        for (size_t i = 0; i < m; i++) {
+            if (!level_add(&shard->table, ids[i], job->value ? job->value[base + i] : 1.0)) {
+                shard->failed = true;
+                break;
+            }
+        }
+
+        shard->timings.encode += t1 - t0;
+        shard->timings.accumulate += now_seconds() - t1;
+    }
+}
+
+static void shard_scatter_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    agg_shard_job_t *job = arg;
+    size_t partitions = (size_t) 1 << job->partition_bits;
+    double t0 = now_seconds();
+
+    for (size_t s = begin; s < end; s++) {
+        agg_shard_t *shard = &job->shards[s];
+        agg_level_t *table = &shard->table;
+
+        shard->offsets = calloc(partitions + 1, sizeof(size_t));
+        shard->scatter = malloc((table->size ? table->size : 1) * sizeof(geohex_agg_entry_t));
+        if (!shard->offsets || !shard->scatter) {
+            shard->failed = true;
+            continue;
+        }
+
+        for (size_t i = 0; i < table->size; i++) {
+            shard->offsets[partition_of(table->entries[i].id, job->partition_bits) + 1]++;
+        }
+        for (size_t p = 0; p < partitions; p++) {
+            shard->offsets[p + 1] += shard->offsets[p];
+        }
+
+        size_t *cursor = malloc(partitions * sizeof(size_t));
+        if (!cursor) {
+            shard->failed = true;
+            continue;
+        }
+        memcpy(cursor, shard->offsets, partitions * sizeof(size_t));
+
+        for (size_t i = 0; i < table->size; i++) {
+            size_t p = partition_of(table->entries[i].id, job->partition_bits);
+            shard->scatter[cursor[p]++] = table->entries[i];
+        }
+
+        free(cursor);
+    }
+
+    job->shards[worker].timings.merge += now_seconds() - t0;
+}
+
+static void partition_merge_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    agg_shard_job_t *job = arg;
+    double t0 = now_seconds();
+
+    for (size_t p = begin; p < end; p++) {
+        agg_level_t *part = &job->parts[p];
+
+        for (uint32_t s = 0; s < job->shard_count; s++) {
+            agg_shard_t *shard = &job->shards[s];
+
+            for (size_t i = shard->offsets[p]; i < shard->offsets[p + 1]; i++) {
+                /* ids already in the finest level belong to this partition only, so merge them in place */
+                size_t *index = geohex_idmap_find(&job->finest->map, shard->scatter[i].id);
+
+                if (index) {
+                    stats_merge(&job->finest->entries[*index].stats, &shard->scatter[i].stats);
+                } else if (!level_merge(part, shard->scatter[i].id, &shard->scatter[i].stats)) {
+                    job->shards[worker].failed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    job->shards[worker].timings.merge += now_seconds() - t0;
+}
+
+static void partition_append_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    agg_shard_job_t *job = arg;
+    agg_level_t *finest = job->finest;
+    double t0 = now_seconds();
+
+    for (size_t p = begin; p < end; p++) {
+        agg_level_t *part = &job->parts[p];
+        size_t base = finest->size + job->part_offsets[p];
+
+        if (part->size) {
+            memcpy(&finest->entries[base], part->entries, part->size * sizeof(geohex_agg_entry_t));
+        }
+        for (size_t i = 0; i < part->size; i++) {
+            geohex_idmap_insert_concurrent(&finest->map, part->entries[i].id, base + i);
+        }
+    }
+
+    job->shards[worker].timings.merge += now_seconds() - t0;
+}
+
+bool geohex_agg_add_batch_parallel(geohex_agg_t *agg, const geohex_executor_t *executor, const double *lon, const double *lat, const double *value, size_t n, geohex_agg_timings_t *timings) {
+    if (!agg || !executor || executor->workers == 0 || (n && (!lon || !lat))) {
+        return false;
+    }
+
+    uint32_t partition_bits = 0;
+    while (((size_t) 1 << partition_bits) < (size_t) executor->workers * 4 &&
+           ((size_t) 1 << partition_bits) < AGG_MAX_PARTITIONS) {
+        partition_bits++;
+    }
+    size_t partitions = (size_t) 1 << partition_bits;
+
+    agg_shard_job_t job = {lon, lat, value, agg->max_level, NULL, executor->workers, NULL, partition_bits, &agg->levels[agg->max_level], NULL};
+    job.shards = calloc(job.shard_count, sizeof(agg_shard_t));
+    job.parts = calloc(partitions, sizeof(agg_level_t));
+    job.part_offsets = malloc((partitions + 1) * sizeof(size_t));
+    bool ok = job.shards && job.parts && job.part_offsets;
+
+    for (uint32_t s = 0; ok && s < job.shard_count; s++) {
+        ok = geohex_idmap_init(&job.shards[s].table.map, 0);
+    }
+    for (size_t p = 0; ok && p < partitions; p++) {
+        ok = geohex_idmap_init(&job.parts[p].map, 0);
+    }
+
+    if (ok) {
+        executor->parallel_for(executor->context, n, shard_accumulate_task, &job);
+        executor->parallel_for(executor->context, job.shard_count, shard_scatter_task, &job);
+
+        for (uint32_t s = 0; s < job.shard_count; s++) {
+            ok &= !job.shards[s].failed;
+        }
+    }
+
+    if (ok) {
+        executor->parallel_for(executor->context, partitions, partition_merge_task, &job);
+
+        for (uint32_t s = 0; s < job.shard_count; s++) {
+            ok &= !job.shards[s].failed;
+        }
+    }
+
+    if (ok) {
+        agg_level_t *finest = job.finest;
+
+        /* partitions hold disjoint new ids; lay them out back to back after the existing entries */
+        job.part_offsets[0] = 0;
+        for (size_t p = 0; p < partitions; p++) {
+            job.part_offsets[p + 1] = job.part_offsets[p] + job.parts[p].size;
+        }
+
+        size_t added = job.part_offsets[partitions];
+        size_t needed = finest->size + added;
+
+        if (needed > finest->capacity) {
+            geohex_agg_entry_t *entries = realloc(finest->entries, needed * sizeof(geohex_agg_entry_t));
+
+            ok = entries != NULL;
+            if (ok) {
+                finest->entries = entries;
+                finest->capacity = needed;
+            }
+        }
+        ok = ok && geohex_idmap_reserve(&finest->map, added);
+
+        if (ok) {
+            executor->parallel_for(executor->context, partitions, partition_append_task, &job);
+            finest->map.size += added;
+            finest->size = needed;
+        }
+    }
+
+    /* existing entries may have been merged in place even if a later stage failed */
+    agg->dirty = true;
+
+    if (timings) {
+        memset(timings, 0, sizeof(geohex_agg_timings_t));
+        for (uint32_t s = 0; job.shards && s < job.shard_count; s++) {
+            timings->encode += job.shards[s].timings.encode;
+            timings->accumulate += job.shards[s].timings.accumulate;
+            timings->merge += job.shards[s].timings.merge;
+        }
+    }
+
+    for (uint32_t s = 0; job.shards && s < job.shard_count; s++) {
+        level_free(&job.shards[s].table);
+        free(job.shards[s].scatter);
+        free(job.shards[s].offsets);
+    }
+    for (size_t p = 0; job.parts && p < partitions; p++) {
+        level_free(&job.parts[p]);
+    }
+    free(job.shards);
+    free(job.parts);
+    free(job.part_offsets);
+
+    return ok;
+}
+
+size_t geohex_agg_size(geohex_agg_t *agg, uint32_t level) {
+    if (!agg || level < agg->min_level || level > agg->max_level || !rollup(agg)) {
+        return 0;
+    }
+
+    return agg->levels[level].size;
+}
+
+bool geohex_agg_export(geohex_agg_t *agg, uint32_t level, geohex_agg_entry_t *out, size_t capacity, size_t *written) {
+    if (!agg || !written || level < agg->min_level || level > agg->max_level || !rollup(agg)) {
+        return false;
+    }
+
+    agg_level_t *lv = &agg->levels[level];
+
+    *written = lv->size;
+    if (capacity < lv->size || (lv->size && !out)) {
+        return false;
+    }
+
+    if (lv->size) {
+        memcpy(out, lv->entries, lv->size * sizeof(geohex_agg_entry_t));
+        qsort(out, lv->size, sizeof(geohex_agg_entry_t), compare_entry);
+    }
+
+    return true;
+}
@@ -0,0 +1,205 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "geohex/geohex.h"
+#include "geohex/codec.h"
+
+#include "geohex_internal.h"
+
+#define CODEC_MAGIC         "GHDV"
+#define CODEC_VERSION       1
+#define CODEC_HEADER_SIZE   16
+#define CODEC_GROUP         4
+#define CODEC_TAG_SIZE      2
+#define CODEC_UNIFORM       0x01
+
+/*
+ * Layout, all integers little-endian:
+ *   header: "GHDV", u8 version, u8 flags, u8 level, u8 reserved, u64 count
+ *   groups: u16 tag holding four 3 bit (byte length - 1) fields, followed by
+ *           the four deltas in 1 to 8 bytes each; the last group may be short
+ */
+static inline uint32_t byte_length(uint64_t v) {
+    uint32_t len = 1;
+
+    while (len < 8 && (v >> (len * 8)) != 0) {
+        len++;
+    }
+
+    return len;
+}
+
+static inline uint64_t to_value(geohex_id_t id, bool uniform, uint32_t level) {
+    return uniform ? (id >> GEOHEX_ID_LEVEL_BITS) / pow9_table[MAX_LEVEL - level] : id;
+}
+
+static inline geohex_id_t from_value(uint64_t value, bool uniform, uint32_t level) {
+    return uniform ? ((value * pow9_table[MAX_LEVEL - level]) << GEOHEX_ID_LEVEL_BITS) | level : value;
+}
+
+size_t geohex_codec_bound(size_t n) {
+    size_t groups = (n + CODEC_GROUP - 1) / CODEC_GROUP;
+
+    return CODEC_HEADER_SIZE + groups * (CODEC_TAG_SIZE + CODEC_GROUP * 8);
+}
+
+bool geohex_codec_encode(const geohex_id_t *ids, size_t n, uint8_t *buf, size_t capacity, size_t *written) {
+    if ((!ids && n) || !buf || !written || capacity < CODEC_HEADER_SIZE) {
+        return false;
+    }
+
+    bool uniform = n > 0;
+    uint32_t level = n > 0 ? get_level_by_id(ids[0]) : 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0 && ids[i - 1] > ids[i]) {
+            return false;
+        }
+        if (get_level_by_id(ids[i]) != level || level > MAX_LEVEL ||
+            ((ids[i] >> GEOHEX_ID_LEVEL_BITS) % pow9_table[MAX_LEVEL - level]) != 0) {
+            uniform = false;
+        }
+    }
+
+    memcpy(buf, CODEC_MAGIC, 4);
+    buf[4] = CODEC_VERSION;
+    buf[5] = uniform ? CODEC_UNIFORM : 0;
+    buf[6] = uniform ? (uint8_t) level : 0;
+    buf[7] = 0;
+    put_le64(buf + 8, (uint64_t) n);
+
+    uint8_t *p = buf + CODEC_HEADER_SIZE, *end = buf + capacity;
+    uint64_t previous = 0;
+
+    for (size_t base = 0; base < n; base += CODEC_GROUP) {
+        size_t m = n - base < CODEC_GROUP ? n - base : CODEC_GROUP;
+        uint64_t deltas[CODEC_GROUP] = {0};
+        uint32_t lengths[CODEC_GROUP] = {0};
+        uint16_t tag = 0;
+        size_t group_size = CODEC_TAG_SIZE;
+
+        for (size_t k = 0; k < m; k++) {
+            uint64_t value = to_value(ids[base + k], uniform, level);
+
+            deltas[k] = value - previous;
+            previous = value;
+            lengths[k] = byte_length(deltas[k]);
+            tag |= (uint16_t) ((lengths[k] - 1) << (k * 3));
+            group_size += lengths[k];
+        }
+
+        if ((size_t) (end - p) < group_size) {
+            return false;
+        }
+
+        put_le16(p, tag);
+        p += CODEC_TAG_SIZE;
+
+        for (size_t k = 0; k < m; k++) {
+            for (uint32_t b = 0; b < lengths[k]; b++) {
+                *p++ = (uint8_t) (deltas[k] >> (b * 8));
+            }
+        }
+    }
+
+    *written = (size_t) (p - buf);
+    return true;
+}
+
+bool geohex_decoder_init(geohex_decoder_t *decoder, const uint8_t *buf, size_t len) {
+    if (!decoder || !buf || len < CODEC_HEADER_SIZE || memcmp(buf, CODEC_MAGIC, 4) != 0 ||
+        buf[4] != CODEC_VERSION || (buf[5] & ~CODEC_UNIFORM) != 0 || buf[6] > MAX_LEVEL) {
+        return false;
+    }
+
+    memset(decoder, 0, sizeof(geohex_decoder_t));
+    decoder->cursor = buf + CODEC_HEADER_SIZE;
+    decoder->end = buf + len;
+    decoder->uniform = (buf[5] & CODEC_UNIFORM) != 0;
+    decoder->level = buf[6];
+    decoder->count = get_le64(buf + 8);
+    decoder->remaining = decoder->count;
+
+    return true;
+}
+
+static bool decode_group(geohex_decoder_t *decoder) {
+    const uint8_t *p = decoder->cursor;
+    uint32_t m = decoder->remaining < CODEC_GROUP ? (uint32_t) decoder->remaining : CODEC_GROUP;
+
+    if (decoder->end - p < CODEC_TAG_SIZE) {
+        decoder->error = true;
+        return false;
+    }
+
+    uint16_t tag = get_le16(p);
+    p += CODEC_TAG_SIZE;
+
+    for (uint32_t k = 0; k < m; k++) {
+        uint32_t len = ((tag >> (k * 3)) & 7) + 1;
+        uint64_t delta;
+
+        if ((size_t) (decoder->end - p) >= 8) {
+            /* one wide load, masked down to the field */
+            delta = get_le64(p);
+            if (len < 8) {
+                delta &= (1ULL << (len * 8)) - 1;
+            }
+        } else if ((size_t) (decoder->end - p) >= len) {
+            delta = 0;
+            for (uint32_t b = len; b > 0; b--) {
+                delta = (delta << 8) | p[b - 1];
+            }
+        } else {
+            decoder->error = true;
+            return false;
+        }
+
+        p += len;
+        decoder->previous += delta;
+        decoder->buffer[k] = from_value(decoder->previous, decoder->uniform, decoder->level);
+    }
+
+    decoder->cursor = p;
+    decoder->remaining -= m;
+    decoder->buffered = m;
+    decoder->position = 0;
+    return true;
+}
+
+bool geohex_decoder_next(geohex_decoder_t *decoder, geohex_id_t *out) {
+    if (!decoder || !out || decoder->error) {
+        return false;
+    }
+
+    if (decoder->position == decoder->buffered) {
+        if (decoder->remaining == 0 || !decode_group(decoder)) {
+            return false;
+        }
+    }
+
+    *out = decoder->buffer[decoder->position++];
+    return true;
+}
+
+size_t geohex_decoder_read(geohex_decoder_t *decoder, geohex_id_t *out, size_t capacity) {
+    size_t n = 0;
+
+    while (n < capacity && geohex_decoder_next(decoder, &out[n])) {
+        n++;
+    }
+
+    return n;
+}
@@ -0,0 +1,241 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "geohex/geohex.h"
+#include "geohex/parallel.h"
+#include "geohex/components.h"
+
+#include "idmap.h"
+
+#define COMPONENTS_PARALLEL_THRESHOLD   65536
+
+/* half of the neighbours; the other half find this zone themselves */
+static const int32_t forward_x[3] = {1, 1, 0};
+static const int32_t forward_y[3] = {0, 1, 1};
+
+typedef struct {
+    const geohex_id_t *ids;
+    uint32_t level;
+    uint64_t *keys;
+    int32_t *xs;
+    int32_t *ys;
+    geohex_idmap_t zones;
+    uint32_t *first;
+    uint32_t *parent;
+    bool failed;
+} components_job_t;
+
+/*
+ * Concurrent union-find: roots only ever link to a smaller root, so the root
+ * of a component is its first distinct zone, and finds halve paths with a
+ * compare-and-swap that may lose harmlessly.
+ */
+static uint32_t find_root(uint32_t *parent, uint32_t x) {
+    for (;;) {
+        uint32_t p = __atomic_load_n(&parent[x], __ATOMIC_RELAXED);
+
+        if (p == x) {
+            return x;
+        }
+
+        uint32_t g = __atomic_load_n(&parent[p], __ATOMIC_RELAXED);
+
+        if (g != p) {
+            __atomic_compare_exchange_n(&parent[x], &p, g, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        }
+        x = g;
+    }
+}
+
+static void unite(uint32_t *parent, uint32_t a, uint32_t b) {
+    for (;;) {
+        a = find_root(parent, a);
+        b = find_root(parent, b);
+        if (a == b) {
+            return;
+        }
+        if (a < b) {
+            uint32_t t = a;
+            a = b;
+            b = t;
+        }
+
+        uint32_t expected = a;
+
+        if (__atomic_compare_exchange_n(&parent[a], &expected, b, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+}
+
+static void key_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    components_job_t *job = arg;
+
+    (void) worker;
+
+    for (size_t i = begin; i < end; i++) {
+        xy_t xy;
+
+        if (get_level_by_id(job->ids[i]) != job->level || !get_xy_by_id(job->ids[i], &xy)) {
+            __atomic_store_n(&job->failed, true, __ATOMIC_RELAXED);
+            return;
+        }
+        job->keys[i] = idmap_xy_key(xy.x, xy.y);
+        /* seam zones flagged rev are swapped back so neighbours are plain steps */
+        job->xs[i] = xy.rev ? xy.y : xy.x;
+        job->ys[i] = xy.rev ? xy.x : xy.y;
+    }
+}
+
+static void union_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    components_job_t *job = arg;
+
+    (void) worker;
+
+    for (size_t d = begin; d < end; d++) {
+        uint32_t i = job->first[d];
+
+        for (int k = 0; k < 3; k++) {
+            xy_t neighbor;
+            size_t *other;
+
+            adjust_xy(job->xs[i] + forward_x[k], job->ys[i] + forward_y[k], job->level, &neighbor);
+            if ((other = geohex_idmap_find(&job->zones, idmap_xy_key(neighbor.x, neighbor.y)))) {
+                unite(job->parent, (uint32_t) d, (uint32_t) *other);
+            }
+        }
+    }
+}
+
+static void flatten_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    components_job_t *job = arg;
+
+    (void) worker;
+
+    for (size_t d = begin; d < end; d++) {
+        __atomic_store_n(&job->parent[d], find_root(job->parent, (uint32_t) d), __ATOMIC_RELAXED);
+    }
+}
+
+static void run(const geohex_executor_t *executor, size_t n, geohex_task_fn task, void *arg) {
+    if (executor) {
+        executor->parallel_for(executor->context, n, task, arg);
+    } else if (n) {
+        task(arg, 0, n, 0);
+    }
+}
+
+static bool label_components(const geohex_executor_t *executor, const geohex_id_t *ids, size_t n, uint32_t *labels, size_t *sizes, size_t *count) {
+    components_job_t job = {0};
+    size_t distinct = 0;
+
+    job.ids = ids;
+    job.level = get_level_by_id(ids[0]);
+    job.keys = malloc(n * sizeof(uint64_t));
+    job.xs = malloc(n * sizeof(int32_t));
+    job.ys = malloc(n * sizeof(int32_t));
+    job.first = malloc(n * sizeof(uint32_t));
+
+    bool ok = job.keys && job.xs && job.ys && job.first && geohex_idmap_init(&job.zones, n);
+
+    if (ok) {
+        run(executor, n, key_task, &job);
+        ok = !job.failed;
+    }
+
+    /* labels holds the distinct zone of each input until the end */
+    for (size_t i = 0; ok && i < n; i++) {
+        bool inserted;
+        size_t *slot = geohex_idmap_insert(&job.zones, job.keys[i], &inserted);
+
+        if (!(ok = slot != NULL)) {
+            break;
+        }
+        if (inserted) {
+            job.first[distinct] = (uint32_t) i;
+            *slot = distinct++;
+        }
+        labels[i] = (uint32_t) *slot;
+    }
+
+    if (ok) {
+        ok = (job.parent = malloc(distinct * sizeof(uint32_t))) != NULL;
+    }
+    if (ok) {
+        for (size_t d = 0; d < distinct; d++) {
+            job.parent[d] = (uint32_t) d;
+        }
+        run(executor, distinct, union_task, &job);
+        run(executor, distinct, flatten_task, &job);
+
+        /* roots are first zones, so numbering them in order follows ids */
+        *count = 0;
+        for (size_t d = 0; d < distinct; d++) {
+            if (job.parent[d] == d) {
+                job.first[d] = (uint32_t) (*count)++;
+            }
+        }
+        if (sizes) {
+            memset(sizes, 0, *count * sizeof(size_t));
+            for (size_t d = 0; d < distinct; d++) {
+                sizes[job.first[job.parent[d]]]++;
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            labels[i] = job.first[job.parent[labels[i]]];
+        }
+    }
+
+    geohex_idmap_free(&job.zones);
+    free(job.parent);
+    free(job.first);
+    free(job.ys);
+    free(job.xs);
+    free(job.keys);
+
+    return ok;
+}
+
+bool geohex_components(const geohex_id_t *ids, size_t n, uint32_t *labels, size_t *sizes, size_t *count) {
+    if ((!ids || !labels) && n) {
+        return false;
+    }
+    if (!count || n > UINT32_MAX) {
+        return false;
+    }
+
+    *count = 0;
+    if (n == 0) {
+        return true;
+    }
+
+    return label_components(NULL, ids, n, labels, sizes, count);
+}
+
+bool geohex_components_parallel(const geohex_executor_t *executor, const geohex_id_t *ids, size_t n, uint32_t *labels, size_t *sizes, size_t *count) {
+    if (!executor) {
+        return false;
+    }
+
+    if (executor->workers < 2 || n < COMPONENTS_PARALLEL_THRESHOLD) {
+        return geohex_components(ids, n, labels, sizes, count);
+    }
+
+    if (!ids || !labels || !count || n > UINT32_MAX) {
+        return false;
+    }
+
+    return label_components(executor, ids, n, labels, sizes, count);
+}
@@ -0,0 +1,228 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <math.h>
+
+#include "geohex/geohex.h"
+#include "geohex/corridor.h"
+
+#include "geohex_internal.h"
+#include "idmap.h"
+
+#define CORRIDOR_BLOCK  1024
+
+/*
+ * The walk runs on unwrapped lattice coordinates, so a segment crossing the
+ * antimeridian keeps stepping to plain neighbours; adjust_xy() folds each
+ * zone back only when it is emitted.
+ */
+typedef struct {
+    uint32_t level;
+    uint32_t buffer;
+    double h_size;
+    int32_t period;
+    int32_t x;
+    int32_t y;
+    geohex_idmap_t seen;
+    geohex_id_t ids[CORRIDOR_BLOCK];
+    size_t pending;
+    geohex_corridor_fn fn;
+    void *arg;
+} corridor_walk_t;
+
+static void flush(corridor_walk_t *walk) {
+    if (walk->pending) {
+        walk->fn(walk->arg, walk->ids, walk->pending);
+        walk->pending = 0;
+    }
+}
+
+static bool emit(corridor_walk_t *walk, int32_t x, int32_t y) {
+    xy_t xy;
+    geohex_id_t id;
+    bool inserted;
+
+    if (!adjust_xy(x, y, walk->level, &xy) || !get_id_by_xy(&xy, walk->level, &id) ||
+        !geohex_idmap_insert(&walk->seen, id, &inserted)) {
+        return false;
+    }
+    if (!inserted) {
+        return true;
+    }
+
+    walk->ids[walk->pending++] = id;
+    if (walk->pending == CORRIDOR_BLOCK) {
+        flush(walk);
+    }
+
+    return true;
+}
+
+/*
+ * Emits the buffer around (x, y). Coming from an adjacent cell only the ring
+ * cells one step further from it than the buffer can be new.
+ */
+static bool visit(corridor_walk_t *walk, int32_t x, int32_t y, bool from_neighbor) {
+    uint32_t radius = from_neighbor ? walk->buffer : 0;
+
+    for (; radius <= walk->buffer; radius++) {
+        int32_t rx = x + direction_x[4] * (int32_t) radius;
+        int32_t ry = y + direction_y[4] * (int32_t) radius;
+        size_t cells = radius == 0 ? 1 : 6 * (size_t) radius;
+
+        for (size_t i = 0; i < cells; i++) {
+            if (!from_neighbor || step_distance((int64_t) rx - walk->x, (int64_t) ry - walk->y) > walk->buffer) {
+                if (!emit(walk, rx, ry)) {
+                    return false;
+                }
+            }
+            if (radius) {
+                rx += direction_x[i / radius];
+                ry += direction_y[i / radius];
+            }
+        }
+    }
+
+    walk->x = x;
+    walk->y = y;
+
+    return true;
+}
+
+/*
+ * Zones split the plane into the cells of their centres, so the segment
+ * leaves the current zone through the bisector with a neighbour it reaches
+ * first. (ax, ay) lies in the current zone.
+ */
+static bool walk_segment(corridor_walk_t *walk, double ax, double ay, double bx, double by) {
+    double dx = bx - ax, dy = by - ay;
+
+    for (;;) {
+        double cx, cy, best_t = 1.0;
+        int best = -1;
+
+        lattice_center(walk->h_size, walk->x, walk->y, &cx, &cy);
+
+        for (int d = 0; d < 6; d++) {
+            double ox = 3.0 * walk->h_size * (direction_x[d] - direction_y[d]);
+            double oy = SQRT3 * walk->h_size * (direction_x[d] + direction_y[d]);
+            double along = dx * ox + dy * oy;
+
+            if (along <= 0) {
+                continue;
+            }
+
+            double t = ((ox * ox + oy * oy) / 2.0 - ((ax - cx) * ox + (ay - cy) * oy)) / along;
+
+            if (t < best_t) {
+                best_t = t;
+                best = d;
+            }
+        }
+
+        if (best < 0) {
+            return true;
+        }
+        if (!visit(walk, walk->x + direction_x[best], walk->y + direction_y[best], true)) {
+            return false;
+        }
+    }
+}
+
+static bool project(const loc_t *location, double *x, double *y) {
+    if (!(fabs(location->lat) < 90.0) || !isfinite(location->lon)) {
+        return false;
+    }
+    loc2xy(location->lon, location->lat, x, y);
+
+    return true;
+}
+
+bool geohex_corridor_cover(const loc_t *vertices, size_t n, uint32_t level, uint32_t buffer, geohex_corridor_fn fn, void *arg) {
+    if ((!vertices && n) || !fn || level > MAX_LEVEL) {
+        return false;
+    }
+    if (n == 0) {
+        return true;
+    }
+
+    corridor_walk_t *walk = calloc(1, sizeof(corridor_walk_t));
+    double ax, ay, cx, cy;
+    xy_t start;
+    bool ok;
+
+    if (!walk) {
+        return false;
+    }
+
+    walk->level = level;
+    walk->buffer = buffer;
+    walk->h_size = calc_hex_size(level);
+    walk->period = (int32_t) pow3_table[level + 2];
+    walk->fn = fn;
+    walk->arg = arg;
+
+    ok = geohex_idmap_init(&walk->seen, 64) && project(&vertices[0], &ax, &ay) &&
+         get_xy_by_location(&vertices[0], level, &start);
+
+    if (ok) {
+        /* undo the seam swap and the wrap, keeping the zone next to the point */
+        walk->x = start.rev ? start.y : start.x;
+        walk->y = start.rev ? start.x : start.y;
+        lattice_center(walk->h_size, walk->x, walk->y, &cx, &cy);
+        if (cx - ax > H_BASE) {
+            walk->x -= walk->period;
+            walk->y += walk->period;
+        } else if (ax - cx > H_BASE) {
+            walk->x += walk->period;
+            walk->y -= walk->period;
+        }
+        ok = visit(walk, walk->x, walk->y, false);
+    }
+
+    for (size_t i = 1; ok && i < n; i++) {
+        double bx, by;
+
+        if (!(ok = project(&vertices[i], &bx, &by))) {
+            break;
+        }
+
+        /* the shorter way around, then fold the walk back into one world */
+        if (bx - ax > H_BASE) {
+            bx -= 2.0 * H_BASE;
+        } else if (ax - bx > H_BASE) {
+            bx += 2.0 * H_BASE;
+        }
+        ok = walk_segment(walk, ax, ay, bx, by);
+
+        ax = bx;
+        ay = by;
+        if (ax > H_BASE) {
+            ax -= 2.0 * H_BASE;
+            walk->x -= walk->period;
+            walk->y += walk->period;
+        } else if (ax < -H_BASE) {
+            ax += 2.0 * H_BASE;
+            walk->x += walk->period;
+            walk->y -= walk->period;
+        }
+    }
+
+    if (ok) {
+        flush(walk);
+    }
+    geohex_idmap_free(&walk->seen);
+    free(walk);
+
+    return ok;
+}
@@ -0,0 +1,170 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+
+#include "geohex/geohex.h"
+#include "geohex/counter.h"
+
+#include "idmap.h"
+
+typedef struct {
+    geohex_id_t id;
+    uint64_t count;
+} counter_slot_t;
+
+struct _geohex_counter_t {
+    counter_slot_t *slots;
+    size_t mask;
+    size_t capacity;
+    size_t size;
+};
+
+geohex_counter_t *geohex_counter_create(size_t capacity) {
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    size_t slots = 16;
+    while (slots < capacity * 2) {
+        slots <<= 1;
+    }
+
+    geohex_counter_t *counter = malloc(sizeof(geohex_counter_t));
+    if (!counter) {
+        return NULL;
+    }
+
+    counter->slots = malloc(slots * sizeof(counter_slot_t));
+    if (!counter->slots) {
+        free(counter);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < slots; i++) {
+        counter->slots[i].id = GEOHEX_ID_INVALID;
+        counter->slots[i].count = 0;
+    }
+
+    counter->mask = slots - 1;
+    counter->capacity = capacity;
+    counter->size = 0;
+
+    return counter;
+}
+
+void geohex_counter_destroy(geohex_counter_t *counter) {
+    if (!counter) {
+        return;
+    }
+
+    free(counter->slots);
+    free(counter);
+}
+
+bool geohex_counter_add(geohex_counter_t *counter, geohex_id_t id, uint64_t delta) {
+    if (!counter || id == GEOHEX_ID_INVALID) {
+        return false;
+    }
+
+    size_t slot = idmap_hash(id) & counter->mask;
+
+    for (size_t probe = 0; probe <= counter->mask; probe++) {
+        counter_slot_t *s = &counter->slots[slot];
+        geohex_id_t current = __atomic_load_n(&s->id, __ATOMIC_ACQUIRE);
+
+        if (current == GEOHEX_ID_INVALID) {
+            /* adding nothing to a new zone must not take up a slot */
+            if (delta == 0) {
+                return true;
+            }
+
+            /* take a ticket before claiming, so at most capacity zones are stored */
+            if (__atomic_fetch_add(&counter->size, 1, __ATOMIC_RELAXED) >= counter->capacity) {
+                __atomic_fetch_sub(&counter->size, 1, __ATOMIC_RELAXED);
+                return false;
+            }
+
+            if (__atomic_compare_exchange_n(&s->id, &current, id, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                current = id;
+            } else {
+                __atomic_fetch_sub(&counter->size, 1, __ATOMIC_RELAXED);
+            }
+        }
+
+        if (current == id) {
+            __atomic_fetch_add(&s->count, delta, __ATOMIC_RELAXED);
+            return true;
+        }
+
+        slot = (slot + 1) & counter->mask;
+    }
+
+    return false;
+}
+
+uint64_t geohex_counter_get(const geohex_counter_t *counter, geohex_id_t id) {
+    if (!counter || id == GEOHEX_ID_INVALID) {
+        return 0;
+    }
+
+    size_t slot = idmap_hash(id) & counter->mask;
+
+    for (size_t probe = 0; probe <= counter->mask; probe++) {
+        const counter_slot_t *s = &counter->slots[slot];
+        geohex_id_t current = __atomic_load_n(&s->id, __ATOMIC_ACQUIRE);
+
+        if (current == id) {
+            return __atomic_load_n(&s->count, __ATOMIC_RELAXED);
+        }
+        if (current == GEOHEX_ID_INVALID) {
+            break;
+        }
+
+        slot = (slot + 1) & counter->mask;
+    }
+
+    return 0;
+}
+
+size_t geohex_counter_size(const geohex_counter_t *counter) {
+    return counter ? __atomic_load_n(&counter->size, __ATOMIC_RELAXED) : 0;
+}
+
+size_t geohex_counter_snapshot(const geohex_counter_t *counter, geohex_counter_entry_t *out, size_t capacity) {
+    if (!counter || !out) {
+        return 0;
+    }
+
+    size_t written = 0;
+
+    for (size_t i = 0; i <= counter->mask && written < capacity; i++) {
+        const counter_slot_t *s = &counter->slots[i];
+        geohex_id_t id = __atomic_load_n(&s->id, __ATOMIC_ACQUIRE);
+
+        if (id == GEOHEX_ID_INVALID) {
+            continue;
+        }
+
+        uint64_t count = __atomic_load_n(&s->count, __ATOMIC_RELAXED);
+        if (count == 0) {
+            /* claimed, but the first increment has not landed yet */
+            continue;
+        }
+
+        out[written].id = id;
+        out[written].count = count;
+        written++;
+    }
+
+    return written;
+}
@@ -0,0 +1,218 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "geohex/geohex.h"
+#include "geohex/dissolve.h"
+
+#include "geohex_internal.h"
+#include "idmap.h"
+
+/*
+ * Corners of the zone centred at (3x, 3y), counter-clockwise from the east,
+ * on a lattice three times finer: (u, v) lies at (u - v, (u + v) / sqrt(3))
+ * hex sizes. Edge i runs from corner i to corner i + 1 and borders the zone
+ * at xy + edge_x/y[i].
+ */
+static const int32_t corner_u[6] = {1, 2, 1, -1, -2, -1};
+static const int32_t corner_v[6] = {-1, 1, 2, 1, -1, -2};
+static const int32_t edge_x[6] = {1, 1, 0, -1, -1, 0};
+static const int32_t edge_y[6] = {0, 1, 1, 0, -1, -1};
+
+typedef struct {
+    int32_t u;
+    int32_t v;
+    uint64_t end;
+} dissolve_edge_t;
+
+/* one representative per corner; corners on the antimeridian have two */
+static inline void fold_corner(int32_t *u, int32_t *v, int32_t period) {
+    int64_t d = (int64_t) *u - *v;
+
+    if (d > period) {
+        *u -= period;
+        *v += period;
+    } else if (d <= -period) {
+        *u += period;
+        *v -= period;
+    }
+}
+
+static uint64_t corner_key(int32_t x, int32_t y, int corner, int32_t period, int32_t *u, int32_t *v) {
+    *u = 3 * x + corner_u[corner % 6];
+    *v = 3 * y + corner_v[corner % 6];
+    fold_corner(u, v, period);
+
+    return idmap_xy_key(*u, *v);
+}
+
+static bool collect_edges(const geohex_id_t *ids, size_t n, uint32_t level, dissolve_edge_t **edges, size_t *count) {
+    geohex_idmap_t zones = {0};
+    int32_t *xs = malloc(n * sizeof(int32_t)), *ys = malloc(n * sizeof(int32_t));
+    int32_t period = 3 * (int32_t) pow3_table[level + 2];
+    size_t distinct = 0;
+    bool ok = xs && ys && geohex_idmap_init(&zones, n);
+
+    *edges = NULL;
+    *count = 0;
+
+    for (size_t i = 0; ok && i < n; i++) {
+        xy_t xy;
+        bool inserted;
+
+        if (!(ok = get_level_by_id(ids[i]) == level && get_xy_by_id(ids[i], &xy) &&
+                   geohex_idmap_insert(&zones, idmap_xy_key(xy.x, xy.y), &inserted))) {
+            break;
+        }
+        if (inserted) {
+            /* seam zones flagged rev are swapped back to their own corners */
+            xs[distinct] = xy.rev ? xy.y : xy.x;
+            ys[distinct] = xy.rev ? xy.x : xy.y;
+            distinct++;
+        }
+    }
+
+    if (ok) {
+        ok = (*edges = malloc(6 * distinct * sizeof(dissolve_edge_t))) != NULL;
+    }
+
+    for (size_t i = 0; ok && i < distinct; i++) {
+        for (int e = 0; e < 6; e++) {
+            xy_t neighbor;
+            int32_t u, v;
+
+            adjust_xy(xs[i] + edge_x[e], ys[i] + edge_y[e], level, &neighbor);
+            if (geohex_idmap_find(&zones, idmap_xy_key(neighbor.x, neighbor.y))) {
+                continue;
+            }
+
+            dissolve_edge_t *edge = &(*edges)[(*count)++];
+
+            edge->end = corner_key(xs[i], ys[i], e + 1, period, &u, &v);
+            corner_key(xs[i], ys[i], e, period, &edge->u, &edge->v);
+        }
+    }
+
+    geohex_idmap_free(&zones);
+    free(ys);
+    free(xs);
+
+    return ok;
+}
+
+/*
+ * Every corner on the outline is shared by one or two member zones, so
+ * exactly one outline edge leaves it and the rings never touch. Each corner
+ * is projected once, when its ring reaches it.
+ */
+static bool trace_rings(const dissolve_edge_t *edges, size_t count, uint32_t level, geohex_outline_t *out) {
+    geohex_idmap_t starts = {0};
+    bool *used = calloc(count ? count : 1, sizeof(bool));
+    double h_size = calc_hex_size(level);
+    bool ok = used && geohex_idmap_init(&starts, count);
+
+    out->vertices = malloc((count ? count : 1) * sizeof(loc_t));
+    out->ring_sizes = malloc((count / 6 + 1) * sizeof(size_t));
+    ok = ok && out->vertices && out->ring_sizes;
+
+    for (size_t e = 0; ok && e < count; e++) {
+        bool inserted;
+        size_t *slot = geohex_idmap_insert(&starts, idmap_xy_key(edges[e].u, edges[e].v), &inserted);
+
+        if (!(ok = slot && inserted)) {
+            break;
+        }
+        *slot = e;
+    }
+
+    for (size_t first = 0; ok && first < count; first++) {
+        size_t e = first, size = 0;
+
+        if (used[first]) {
+            continue;
+        }
+
+        do {
+            loc_t *vertex = &out->vertices[out->vertex_count + size];
+            size_t *next;
+
+            used[e] = true;
+            xy2loc(h_size * ((double) edges[e].u - edges[e].v), h_size * ((double) edges[e].u + edges[e].v) / SQRT3, &vertex->lon, &vertex->lat);
+
+            /* keep crossing the antimeridian instead of jumping back */
+            if (size > 0) {
+                double previous = vertex[-1].lon;
+
+                if (vertex->lon - previous > 180.0) {
+                    vertex->lon -= 360.0;
+                } else if (previous - vertex->lon > 180.0) {
+                    vertex->lon += 360.0;
+                }
+            }
+            size++;
+
+            if (!(ok = (next = geohex_idmap_find(&starts, edges[e].end)) != NULL)) {
+                break;
+            }
+            e = *next;
+        } while (e != first);
+
+        out->ring_sizes[out->rings++] = size;
+        out->vertex_count += size;
+    }
+
+    geohex_idmap_free(&starts);
+    free(used);
+
+    return ok;
+}
+
+bool geohex_dissolve(const geohex_id_t *ids, size_t n, geohex_outline_t *out) {
+    if (!out || (!ids && n)) {
+        return false;
+    }
+
+    memset(out, 0, sizeof(geohex_outline_t));
+    if (n == 0) {
+        return true;
+    }
+
+    uint32_t level = get_level_by_id(ids[0]);
+    dissolve_edge_t *edges;
+    size_t count;
+
+    if (level > MAX_LEVEL) {
+        return false;
+    }
+
+    bool ok = collect_edges(ids, n, level, &edges, &count) && trace_rings(edges, count, level, out);
+
+    free(edges);
+    if (!ok) {
+        geohex_outline_free(out);
+    }
+
+    return ok;
+}
+
+void geohex_outline_free(geohex_outline_t *outline) {
+    if (!outline) {
+        return;
+    }
+
+    free(outline->ring_sizes);
+    free(outline->vertices);
+    memset(outline, 0, sizeof(geohex_outline_t));
+}
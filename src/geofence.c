@@ -0,0 +1,619 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "geohex/geohex.h"
+#include "geohex/geofence.h"
+
+#include "geohex_internal.h"
+#include "idmap.h"
+
+#define GF_BOUNDARY         0x1
+#define GF_CENTER_INSIDE    0x2
+/* reach of a boundary zone in hex sizes; a zone's circumradius is 2 */
+#define GF_RADIUS           2.5
+
+typedef struct {
+    double ax;
+    double ay;
+    double bx;
+    double by;
+} gf_edge_t;
+
+typedef struct {
+    size_t edge_begin;
+    size_t edge_count;
+} gf_fence_t;
+
+typedef struct {
+    uint64_t key;
+    uint32_t fence;
+    uint32_t flags;
+    size_t local_begin;
+    size_t local_count;
+    double cx;
+    double cy;
+} gf_ref_t;
+
+struct _geohex_geofence_t {
+    uint32_t level;
+    double unit_x;
+    double unit_y;
+    double radius;
+    bool compiled;
+    gf_edge_t *edges;
+    size_t edge_count;
+    size_t edge_capacity;
+    gf_fence_t *fences;
+    size_t fence_count;
+    size_t fence_capacity;
+    gf_ref_t *refs;
+    size_t ref_count;
+    size_t ref_capacity;
+    size_t *locals;
+    size_t local_count;
+    size_t local_capacity;
+    size_t *cells;
+    geohex_idmap_t map;
+};
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+} gf_cell_t;
+
+/* zones crossed by the outline of the fence being compiled */
+typedef struct {
+    geohex_idmap_t map;
+    gf_cell_t *cells;
+    size_t count;
+    size_t capacity;
+    size_t *pairs;
+    size_t pair_count;
+    size_t pair_capacity;
+    double *crossings;
+} gf_build_t;
+
+static void *grow(void *items, size_t *capacity, size_t need, size_t size) {
+    if (need <= *capacity) {
+        return items;
+    }
+
+    size_t new_capacity = *capacity ? *capacity : 16;
+    while (new_capacity < need) {
+        new_capacity *= 2;
+    }
+
+    void *grown = realloc(items, new_capacity * size);
+    if (grown) {
+        *capacity = new_capacity;
+    }
+
+    return grown;
+}
+
+static inline bool edge_crosses_row(const gf_edge_t *e, double y) {
+    return (e->ay > y) != (e->by > y);
+}
+
+static inline double edge_row_x(const gf_edge_t *e, double y) {
+    return e->ax + (y - e->ay) * (e->bx - e->ax) / (e->by - e->ay);
+}
+
+static inline double orient(double ax, double ay, double bx, double by, double px, double py) {
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+/* half-open on both lines, so a vertex on either one is counted once */
+static inline bool edge_crosses_segment(const gf_edge_t *e, double cx, double cy, double px, double py) {
+    return ((orient(cx, cy, px, py, e->ax, e->ay) > 0) != (orient(cx, cy, px, py, e->bx, e->by) > 0)) &&
+           ((orient(e->ax, e->ay, e->bx, e->by, cx, cy) > 0) != (orient(e->ax, e->ay, e->bx, e->by, px, py) > 0));
+}
+
+static double edge_distance2(const gf_edge_t *e, double x, double y) {
+    double dx = e->bx - e->ax, dy = e->by - e->ay;
+    double length2 = dx * dx + dy * dy;
+    double t = length2 > 0 ? ((x - e->ax) * dx + (y - e->ay) * dy) / length2 : 0;
+
+    t = t < 0 ? 0 : (t > 1 ? 1 : t);
+    dx = e->ax + t * dx - x;
+    dy = e->ay + t * dy - y;
+
+    return dx * dx + dy * dy;
+}
+
+static bool point_in_fence(const geohex_geofence_t *gf, const gf_fence_t *fence, double x, double y) {
+    bool inside = false;
+
+    for (size_t i = fence->edge_begin; i < fence->edge_begin + fence->edge_count; i++) {
+        const gf_edge_t *e = &gf->edges[i];
+
+        if (edge_crosses_row(e, y) && edge_row_x(e, y) > x) {
+            inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+static bool ref_contains(const geohex_geofence_t *gf, const gf_ref_t *ref, double x, double y) {
+    if (!(ref->flags & GF_BOUNDARY)) {
+        return true;
+    }
+
+    double dx = x - ref->cx, dy = y - ref->cy;
+
+    /* beyond the stored edges, e.g. across the antimeridian seam */
+    if (dx * dx + dy * dy > gf->radius * gf->radius) {
+        return point_in_fence(gf, &gf->fences[ref->fence], x, y);
+    }
+
+    bool inside = (ref->flags & GF_CENTER_INSIDE) != 0;
+
+    for (size_t i = ref->local_begin; i < ref->local_begin + ref->local_count; i++) {
+        if (edge_crosses_segment(&gf->edges[gf->locals[i]], ref->cx, ref->cy, x, y)) {
+            inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double da = *(const double *) a, db = *(const double *) b;
+
+    return (da > db) - (da < db);
+}
+
+static int compare_ref(const void *a, const void *b) {
+    const gf_ref_t *ra = a, *rb = b;
+
+    if (ra->key != rb->key) {
+        return (ra->key > rb->key) - (ra->key < rb->key);
+    }
+
+    return (ra->fence > rb->fence) - (ra->fence < rb->fence);
+}
+
+static bool push_ref(geohex_geofence_t *gf, uint32_t fence_id, int32_t x, int32_t y, uint32_t flags, size_t local_begin, size_t local_count) {
+    gf_ref_t *refs = grow(gf->refs, &gf->ref_capacity, gf->ref_count + 1, sizeof(gf_ref_t));
+    xy_t adjusted;
+
+    if (!refs) {
+        return false;
+    }
+    gf->refs = refs;
+
+    adjust_xy(x, y, gf->level, &adjusted);
+
+    gf_ref_t *ref = &gf->refs[gf->ref_count++];
+    ref->key = idmap_xy_key(adjusted.x, adjusted.y);
+    ref->fence = fence_id;
+    ref->flags = flags;
+    ref->local_begin = local_begin;
+    ref->local_count = local_count;
+    ref->cx = gf->unit_x * (double) (x - y);
+    ref->cy = gf->unit_y * (double) (x + y);
+
+    return true;
+}
+
+static bool mark_boundary(gf_build_t *b, int32_t x, int32_t y, size_t edge) {
+    bool inserted;
+    size_t *cell = geohex_idmap_insert(&b->map, idmap_xy_key(x, y), &inserted);
+
+    if (!cell) {
+        return false;
+    }
+
+    if (inserted) {
+        gf_cell_t *cells = grow(b->cells, &b->capacity, b->count + 1, sizeof(gf_cell_t));
+
+        if (!cells) {
+            return false;
+        }
+        b->cells = cells;
+
+        *cell = b->count;
+        b->cells[b->count].x = x;
+        b->cells[b->count].y = y;
+        b->count++;
+    }
+
+    size_t *pairs = grow(b->pairs, &b->pair_capacity, b->pair_count * 2 + 2, sizeof(size_t));
+    if (!pairs) {
+        return false;
+    }
+    b->pairs = pairs;
+    b->pairs[b->pair_count * 2] = *cell;
+    b->pairs[b->pair_count * 2 + 1] = edge;
+    b->pair_count++;
+
+    return true;
+}
+
+/* zones whose centre lies within radius of an edge */
+static bool trace_outline(geohex_geofence_t *gf, const gf_fence_t *fence, gf_build_t *b) {
+    double r = gf->radius;
+
+    for (size_t i = fence->edge_begin; i < fence->edge_begin + fence->edge_count; i++) {
+        const gf_edge_t *e = &gf->edges[i];
+        int64_t k_begin = (int64_t) ceil((fmin(e->ay, e->by) - r) / gf->unit_y);
+        int64_t k_end = (int64_t) floor((fmax(e->ay, e->by) + r) / gf->unit_y);
+
+        for (int64_t k = k_begin; k <= k_end; k++) {
+            double row_y = gf->unit_y * (double) k;
+            double t0 = 0, t1 = 1;
+
+            if (e->ay != e->by) {
+                t0 = (row_y - r - e->ay) / (e->by - e->ay);
+                t1 = (row_y + r - e->ay) / (e->by - e->ay);
+                if (t0 > t1) {
+                    double t = t0;
+                    t0 = t1;
+                    t1 = t;
+                }
+                t0 = fmax(t0, 0);
+                t1 = fmin(t1, 1);
+                if (t0 > t1) {
+                    continue;
+                }
+            }
+
+            double x0 = e->ax + t0 * (e->bx - e->ax), x1 = e->ax + t1 * (e->bx - e->ax);
+            int64_t x_begin = (int64_t) ceil(((fmin(x0, x1) - r) / gf->unit_x + (double) k) / 2);
+            int64_t x_end = (int64_t) floor(((fmax(x0, x1) + r) / gf->unit_x + (double) k) / 2);
+
+            for (int64_t x = x_begin; x <= x_end; x++) {
+                double cx = gf->unit_x * (double) (2 * x - k);
+
+                if (edge_distance2(e, cx, row_y) <= r * r &&
+                    !mark_boundary(b, (int32_t) x, (int32_t) (k - x), i)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool compile_fence(geohex_geofence_t *gf, uint32_t fence_id) {
+    const gf_fence_t *fence = &gf->fences[fence_id];
+    gf_build_t b = {0};
+    size_t *offsets = NULL, *rows = NULL, *row_offsets = NULL;
+    bool ok = false;
+
+    b.crossings = malloc(fence->edge_count * sizeof(double));
+    if (!b.crossings || !geohex_idmap_init(&b.map, fence->edge_count * 4) || !trace_outline(gf, fence, &b)) {
+        goto out;
+    }
+
+    /* group the traced edges by zone */
+    size_t *locals = grow(gf->locals, &gf->local_capacity, gf->local_count + b.pair_count, sizeof(size_t));
+    offsets = calloc(b.count + 1, sizeof(size_t));
+    if (!locals || !offsets) {
+        goto out;
+    }
+    gf->locals = locals;
+
+    for (size_t i = 0; i < b.pair_count; i++) {
+        offsets[b.pairs[i * 2] + 1]++;
+    }
+    for (size_t i = 0; i < b.count; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    for (size_t i = 0; i < b.pair_count; i++) {
+        gf->locals[gf->local_count + offsets[b.pairs[i * 2]]++] = b.pairs[i * 2 + 1];
+    }
+    for (size_t i = b.count; i > 0; i--) {
+        offsets[i] = offsets[i - 1];
+    }
+    offsets[0] = 0;
+
+    double y_min = HUGE_VAL, y_max = -HUGE_VAL;
+    for (size_t i = fence->edge_begin; i < fence->edge_begin + fence->edge_count; i++) {
+        y_min = fmin(y_min, gf->edges[i].ay);
+        y_max = fmax(y_max, gf->edges[i].ay);
+    }
+
+    int64_t k_begin = (int64_t) ceil(y_min / gf->unit_y), k_end = (int64_t) floor(y_max / gf->unit_y);
+    for (size_t i = 0; i < b.count; i++) {
+        int64_t k = (int64_t) b.cells[i].x + b.cells[i].y;
+
+        k_begin = k < k_begin ? k : k_begin;
+        k_end = k > k_end ? k : k_end;
+    }
+
+    /* bucket the boundary zones by row */
+    size_t row_count = k_end >= k_begin ? (size_t) (k_end - k_begin + 1) : 0;
+    rows = malloc((b.count ? b.count : 1) * sizeof(size_t));
+    row_offsets = calloc(row_count + 1, sizeof(size_t));
+    if (!rows || !row_offsets) {
+        goto out;
+    }
+
+    for (size_t i = 0; i < b.count; i++) {
+        row_offsets[(size_t) ((int64_t) b.cells[i].x + b.cells[i].y - k_begin) + 1]++;
+    }
+    for (size_t i = 0; i < row_count; i++) {
+        row_offsets[i + 1] += row_offsets[i];
+    }
+    for (size_t i = 0; i < b.count; i++) {
+        rows[row_offsets[(size_t) ((int64_t) b.cells[i].x + b.cells[i].y - k_begin)]++] = i;
+    }
+
+    for (size_t row = 0; row < row_count; row++) {
+        int64_t k = k_begin + (int64_t) row;
+        double row_y = gf->unit_y * (double) k;
+        size_t m = 0;
+
+        for (size_t i = fence->edge_begin; i < fence->edge_begin + fence->edge_count; i++) {
+            if (edge_crosses_row(&gf->edges[i], row_y)) {
+                b.crossings[m++] = edge_row_x(&gf->edges[i], row_y);
+            }
+        }
+        qsort(b.crossings, m, sizeof(double), compare_double);
+
+        /* an even-odd span [crossings[2j], crossings[2j + 1]) holds inside centres */
+        for (size_t j = 0; j + 1 < m; j += 2) {
+            int64_t x_begin = (int64_t) floor((b.crossings[j] / gf->unit_x + (double) k) / 2);
+            int64_t x_end = (int64_t) ceil((b.crossings[j + 1] / gf->unit_x + (double) k) / 2);
+
+            for (int64_t x = x_begin; x <= x_end; x++) {
+                double cx = gf->unit_x * (double) (2 * x - k);
+
+                if (cx < b.crossings[j] || cx >= b.crossings[j + 1] ||
+                    geohex_idmap_find(&b.map, idmap_xy_key((int32_t) x, (int32_t) (k - x)))) {
+                    continue;
+                }
+                if (!push_ref(gf, fence_id, (int32_t) x, (int32_t) (k - x), 0, 0, 0)) {
+                    goto out;
+                }
+            }
+        }
+
+        size_t row_begin = row > 0 ? row_offsets[row - 1] : 0;
+        for (size_t r = row_begin; r < row_offsets[row]; r++) {
+            size_t cell = rows[r];
+            double cx = gf->unit_x * (double) (b.cells[cell].x - b.cells[cell].y);
+            size_t right = 0;
+
+            for (size_t j = 0; j < m; j++) {
+                right += b.crossings[j] > cx;
+            }
+
+            uint32_t flags = GF_BOUNDARY | ((right & 1) ? GF_CENTER_INSIDE : 0);
+            if (!push_ref(gf, fence_id, b.cells[cell].x, b.cells[cell].y, flags,
+                          gf->local_count + offsets[cell], offsets[cell + 1] - offsets[cell])) {
+                goto out;
+            }
+        }
+    }
+
+    gf->local_count += b.pair_count;
+    ok = true;
+
+out:
+    free(row_offsets);
+    free(rows);
+    free(offsets);
+    free(b.crossings);
+    free(b.pairs);
+    free(b.cells);
+    geohex_idmap_free(&b.map);
+
+    return ok;
+}
+
+geohex_geofence_t *geohex_geofence_create(uint32_t level) {
+    if (level > MAX_LEVEL) {
+        return NULL;
+    }
+
+    geohex_geofence_t *gf = calloc(1, sizeof(geohex_geofence_t));
+    if (!gf) {
+        return NULL;
+    }
+
+    double h_size = calc_hex_size(level);
+
+    gf->level = level;
+    gf->unit_x = 3.0 * h_size;
+    gf->unit_y = sqrt(3.0) * h_size;
+    gf->radius = GF_RADIUS * h_size;
+
+    return gf;
+}
+
+void geohex_geofence_destroy(geohex_geofence_t *gf) {
+    if (!gf) {
+        return;
+    }
+
+    geohex_idmap_free(&gf->map);
+    free(gf->cells);
+    free(gf->locals);
+    free(gf->refs);
+    free(gf->fences);
+    free(gf->edges);
+    free(gf);
+}
+
+bool geohex_geofence_add(geohex_geofence_t *gf, const loc_t *vertices, const size_t *ring_sizes, size_t rings, uint32_t *fence_id) {
+    if (!gf || gf->compiled || !vertices || !ring_sizes || rings == 0 || !fence_id || gf->fence_count >= GEOHEX_GEOFENCE_NONE) {
+        return false;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < rings; i++) {
+        if (ring_sizes[i] < 3) {
+            return false;
+        }
+        total += ring_sizes[i];
+    }
+
+    gf_edge_t *edges = grow(gf->edges, &gf->edge_capacity, gf->edge_count + total, sizeof(gf_edge_t));
+    if (!edges) {
+        return false;
+    }
+    gf->edges = edges;
+
+    gf_fence_t *fences = grow(gf->fences, &gf->fence_capacity, gf->fence_count + 1, sizeof(gf_fence_t));
+    if (!fences) {
+        return false;
+    }
+    gf->fences = fences;
+
+    size_t edge = gf->edge_count;
+    for (size_t i = 0; i < rings; i++) {
+        for (size_t j = 0; j < ring_sizes[i]; j++) {
+            double x, y;
+
+            loc2xy(vertices[j].lon, vertices[j].lat, &x, &y);
+            gf->edges[edge + j].ax = x;
+            gf->edges[edge + j].ay = y;
+            gf->edges[edge + (j + ring_sizes[i] - 1) % ring_sizes[i]].bx = x;
+            gf->edges[edge + (j + ring_sizes[i] - 1) % ring_sizes[i]].by = y;
+        }
+        vertices += ring_sizes[i];
+        edge += ring_sizes[i];
+    }
+
+    uint32_t id = (uint32_t) gf->fence_count;
+    size_t ref_mark = gf->ref_count;
+
+    gf->fences[id].edge_begin = gf->edge_count;
+    gf->fences[id].edge_count = total;
+
+    if (!compile_fence(gf, id)) {
+        gf->ref_count = ref_mark;
+        return false;
+    }
+
+    gf->edge_count += total;
+    gf->fence_count++;
+    *fence_id = id;
+
+    return true;
+}
+
+bool geohex_geofence_compile(geohex_geofence_t *gf) {
+    if (!gf || gf->compiled) {
+        return false;
+    }
+
+    qsort(gf->refs, gf->ref_count, sizeof(gf_ref_t), compare_ref);
+
+    size_t cell_count = 0;
+    for (size_t i = 0; i < gf->ref_count; i++) {
+        cell_count += i == 0 || gf->refs[i].key != gf->refs[i - 1].key;
+    }
+
+    gf->cells = malloc((cell_count + 1) * sizeof(size_t));
+    if (!gf->cells || !geohex_idmap_init(&gf->map, cell_count)) {
+        free(gf->cells);
+        gf->cells = NULL;
+        return false;
+    }
+
+    size_t cell = 0;
+    for (size_t i = 0; i < gf->ref_count; i++) {
+        if (i == 0 || gf->refs[i].key != gf->refs[i - 1].key) {
+            bool inserted;
+            size_t *value = geohex_idmap_insert(&gf->map, gf->refs[i].key, &inserted);
+
+            if (!value) {
+                geohex_idmap_free(&gf->map);
+                free(gf->cells);
+                gf->cells = NULL;
+                return false;
+            }
+            *value = cell;
+            gf->cells[cell++] = i;
+        }
+    }
+    gf->cells[cell_count] = gf->ref_count;
+    gf->compiled = true;
+
+    return true;
+}
+
+/* fences containing location in id order, stopping after limit matches */
+static size_t match(const geohex_geofence_t *gf, const loc_t *location, uint32_t *out, size_t capacity, size_t limit) {
+    xy_t xy;
+    size_t *cell, count = 0;
+    double x = 0, y = 0;
+    bool projected = false;
+    uint32_t last = GEOHEX_GEOFENCE_NONE;
+
+    if (!get_xy_by_location(location, gf->level, &xy) ||
+        !(cell = geohex_idmap_find(&gf->map, idmap_xy_key(xy.x, xy.y)))) {
+        return 0;
+    }
+
+    for (size_t i = gf->cells[*cell]; i < gf->cells[*cell + 1] && count < limit; i++) {
+        const gf_ref_t *ref = &gf->refs[i];
+
+        /* a zone on the antimeridian seam may be listed twice */
+        if (ref->fence == last) {
+            continue;
+        }
+
+        if (ref->flags & GF_BOUNDARY) {
+            if (!projected) {
+                loc2xy(location->lon, location->lat, &x, &y);
+                projected = true;
+            }
+            if (!ref_contains(gf, ref, x, y)) {
+                continue;
+            }
+        }
+
+        if (count < capacity) {
+            out[count] = ref->fence;
+        }
+        count++;
+        last = ref->fence;
+    }
+
+    return count;
+}
+
+bool geohex_geofence_query(const geohex_geofence_t *gf, const loc_t *location, uint32_t *out, size_t capacity, size_t *found) {
+    if (!gf || !gf->compiled || !location || !found || (capacity && !out)) {
+        return false;
+    }
+
+    *found = match(gf, location, out, capacity, SIZE_MAX);
+
+    return *found <= capacity;
+}
+
+bool geohex_geofence_query_batch(const geohex_geofence_t *gf, const double *lon, const double *lat, size_t n, uint32_t *out) {
+    if (!gf || !gf->compiled || ((!lon || !lat || !out) && n)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        loc_t location = {lon[i], lat[i]};
+
+        if (match(gf, &location, &out[i], 1, 1) == 0) {
+            out[i] = GEOHEX_GEOFENCE_NONE;
+        }
+    }
+
+    return true;
+}
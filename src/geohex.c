@@ -19,8 +19,8 @@
 
 #include "geohex/geohex.h"
 
-#define GEOHEX_KEY  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
-#define H_BASE      20037508.34
+#include "geohex_internal.h"
+
 #define H_K         0.5773502691896257 /* tan(M_PI / 6.0) */
 
 const uint32_t pow3_table[] = {
@@ -47,15 +47,27 @@ const uint32_t pow3_table[] = {
     3486784401  /* pow(3, 20) */
 };
 
-static inline int char_to_index(char c) {
-    if (c >= 'A' && c <= 'Z') {
-        return c - 'A';
-    } else if (c >= 'a' && c <= 'z') {
-        return c - 'a' + 26;
-    } else {
-        return -1;
-    }
-}
+const uint64_t pow9_table[] = {
+    1ULL,                   /* pow(9, 0) */
+    9ULL,                   /* pow(9, 1) */
+    81ULL,                  /* pow(9, 2) */
+    729ULL,                 /* pow(9, 3) */
+    6561ULL,                /* pow(9, 4) */
+    59049ULL,               /* pow(9, 5) */
+    531441ULL,              /* pow(9, 6) */
+    4782969ULL,             /* pow(9, 7) */
+    43046721ULL,            /* pow(9, 8) */
+    387420489ULL,           /* pow(9, 9) */
+    3486784401ULL,          /* pow(9, 10) */
+    31381059609ULL,         /* pow(9, 11) */
+    282429536481ULL,        /* pow(9, 12) */
+    2541865828329ULL,       /* pow(9, 13) */
+    22876792454961ULL,      /* pow(9, 14) */
+    205891132094649ULL,     /* pow(9, 15) */
+    1853020188851841ULL,    /* pow(9, 16) */
+    16677181699666569ULL,   /* pow(9, 17) */
+    150094635296999121ULL   /* pow(9, 18) */
+};
 
 double calc_hex_size(uint32_t level) {
     return H_BASE / pow3_table[level + 3];
@@ -72,6 +84,75 @@ void xy2loc(double dx, double dy, double *lon, double *lat) {
     *lat = (2.0 * atan(exp(lat_rad)) - M_PI / 2.0) * 180.0 / M_PI;
 }
 
+/* the widest axis-aligned box inside the hexagon, |dx| < s and |dy| < sqrt(3)s */
+void zone_inner_box(const xy_t *xy, uint32_t level, loc_t *min, loc_t *max) {
+    double h_size = calc_hex_size(level);
+    double half_x = ZONE_INNER_MARGIN * h_size, half_y = ZONE_INNER_MARGIN * SQRT3 * h_size;
+    double cx, cy;
+
+    lattice_center(h_size, xy->rev ? xy->y : xy->x, xy->rev ? xy->x : xy->y, &cx, &cy);
+
+    xy2loc(cx - half_x, cy - half_y, &min->lon, &min->lat);
+    xy2loc(cx + half_x, cy + half_y, &max->lon, &max->lat);
+}
+
+
+/*
+ * Latitude is the Gudermannian of t = pi * dy / H_BASE. The fast decoders
+ * read it from cubic Hermite nodes over 0 <= t < LAT_TABLE_SPAN, built on
+ * first use; the interpolation error is below 1e-12 radians there, and
+ * rows beyond the span fall back to xy2loc().
+ */
+#define LAT_TABLE_SIZE  2048
+#define LAT_TABLE_SPAN  5.5
+
+static double lat_table[LAT_TABLE_SIZE + 1][2];
+/* 0 empty, 1 being built, 2 ready */
+static int lat_table_state;
+
+static bool lat_table_ready(void) {
+    int state = __atomic_load_n(&lat_table_state, __ATOMIC_ACQUIRE);
+
+    if (state == 2) {
+        return true;
+    }
+    if (state != 0 || !__atomic_compare_exchange_n(&lat_table_state, &state, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        /* another thread is building it; decode exactly meanwhile */
+        return false;
+    }
+
+    for (int i = 0; i <= LAT_TABLE_SIZE; i++) {
+        double t = LAT_TABLE_SPAN * i / LAT_TABLE_SIZE;
+
+        lat_table[i][0] = 2.0 * atan(exp(t)) - M_PI / 2.0;
+        lat_table[i][1] = 1.0 / cosh(t);
+    }
+    __atomic_store_n(&lat_table_state, 2, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+static double mercator_lat_fast(double dy) {
+    double t = fabs(dy) / H_BASE * M_PI;
+    double unused, lat;
+
+    if (!(t < LAT_TABLE_SPAN) || !lat_table_ready()) {
+        xy2loc(0.0, dy, &unused, &lat);
+        return lat;
+    }
+
+    double step = LAT_TABLE_SPAN / LAT_TABLE_SIZE;
+    double u = t / step;
+    int i = (int) u;
+    double f = u - i, f2 = f * f, f3 = f2 * f;
+    double rad = (2.0 * f3 - 3.0 * f2 + 1.0) * lat_table[i][0] +
+                 (f3 - 2.0 * f2 + f) * step * lat_table[i][1] +
+                 (3.0 * f2 - 2.0 * f3) * lat_table[i + 1][0] +
+                 (f3 - f2) * step * lat_table[i + 1][1];
+
+    lat = rad * 180.0 / M_PI;
+    return dy < 0 ? -lat : lat;
+}
 
 bool adjust_xy(int32_t x, int32_t y, uint32_t level, xy_t *out) {
     if (!out) {
@@ -117,15 +198,8 @@ bool adjust_xy(int32_t x, int32_t y, uint32_t level, xy_t *out) {
     return true;
 }
 
-bool get_xy_by_location(const loc_t *location, uint32_t level, xy_t *out) {
-    if (!location || !out) {
-        return false;
-    }
-
+static bool xy_by_mercator(double lon_grid, double lat_grid, uint32_t level, xy_t *out) {
     double h_size = calc_hex_size(level);
-    double lon_grid, lat_grid;
-    loc2xy(location->lon, location->lat, &lon_grid, &lat_grid);
-
     double unit_x = 6.0 * h_size;
     double unit_y = 6.0 * h_size * H_K;
 
@@ -153,6 +227,76 @@ bool get_xy_by_location(const loc_t *location, uint32_t level, xy_t *out) {
     return adjust_xy(h_x, h_y, level, out);
 }
 
+bool get_xy_by_location(const loc_t *location, uint32_t level, xy_t *out) {
+    if (!location || !out) {
+        return false;
+    }
+
+    double lon_grid, lat_grid;
+    loc2xy(location->lon, location->lat, &lon_grid, &lat_grid);
+
+    return xy_by_mercator(lon_grid, lat_grid, level, out);
+}
+
+bool get_xy_by_mercator(double dx, double dy, uint32_t level, xy_t *out) {
+    if (!out || level > MAX_LEVEL) {
+        return false;
+    }
+
+    return xy_by_mercator(dx, dy, level, out);
+}
+
+bool get_xys_by_mercator(const double *dx, const double *dy, size_t n, uint32_t level, xy_t *out) {
+    if (((!dx || !dy || !out) && n) || level > MAX_LEVEL) {
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        ok &= xy_by_mercator(dx[i], dy[i], level, &out[i]);
+    }
+
+    return ok;
+}
+
+/*
+ * E7 batches are projected a block at a time into Web Mercator on the
+ * stack: the longitude pass is straight-line arithmetic the compiler can
+ * vectorize, and no loc_t array is ever written.
+ */
+#define E7_BLOCK    64
+
+static bool xys_by_e7(const int32_t *lon_e7, const int32_t *lat_e7, size_t n, uint32_t level, xy_t *out) {
+    double lon_grid[E7_BLOCK], lat_grid[E7_BLOCK];
+    bool ok = true;
+
+    for (size_t begin = 0; begin < n; begin += E7_BLOCK) {
+        size_t count = n - begin < E7_BLOCK ? n - begin : E7_BLOCK;
+
+        for (size_t i = 0; i < count; i++) {
+            lon_grid[i] = (double) lon_e7[begin + i] / 1e7 * H_BASE / 180.0;
+        }
+        for (size_t i = 0; i < count; i++) {
+            double lat = (double) lat_e7[begin + i] / 1e7;
+
+            lat_grid[i] = log(tan((90.0 + lat) * M_PI / 360.0)) * (H_BASE / M_PI);
+        }
+        for (size_t i = 0; i < count; i++) {
+            ok &= xy_by_mercator(lon_grid[i], lat_grid[i], level, &out[begin + i]);
+        }
+    }
+
+    return ok;
+}
+
+bool get_xys_by_e7(const int32_t *lon_e7, const int32_t *lat_e7, size_t n, uint32_t level, xy_t *out) {
+    if (((!lon_e7 || !lat_e7 || !out) && n) || level > MAX_LEVEL) {
+        return false;
+    }
+
+    return xys_by_e7(lon_e7, lat_e7, n, level, out);
+}
+
 bool get_xy_by_code(const geohex_code_t code, xy_t *out) {
     if (!out) {
         return false;
@@ -248,29 +392,77 @@ bool get_zone_by_code(const geohex_code_t code, zone_t *out) {
     return get_zone_by_xy(&xy, level, out);
 }
 
-bool get_zone_by_xy(const xy_t *xy, uint32_t level, zone_t *out) {
-    if (!xy || !out) {
+/* get_xy_by_code() on integers, for well-formed codes only */
+static bool xy_by_code_digits(const geohex_code_t code, uint32_t *level, xy_t *out) {
+    size_t code_len = strlen(code);
+    if (code_len < 2 || code_len >= MAX_CODE_LEN) {
+        return false;
+    }
+
+    int32_t c1_idx = char_to_index(code[0]);
+    int32_t c2_idx = char_to_index(code[1]);
+    if (c1_idx == -1 || c2_idx == -1) {
+        return false;
+    }
+
+    int32_t h_1_int = c1_idx * 30 + c2_idx;
+    int32_t lead[3] = {h_1_int / 100, h_1_int / 10 % 10, h_1_int % 10};
+    if (h_1_int > 888 || lead[1] == 9 || lead[2] == 9) {
+        return false;
+    }
+    decode_prefix_digits(lead);
+
+    int32_t h_x = 0, h_y = 0;
+    for (size_t i = 0; i <= code_len; i++) {
+        int32_t digit = i < 3 ? lead[i] : code[i - 1] - '0';
+
+        if (digit < 0 || digit > 8) {
+            return false;
+        }
+        h_x = h_x * 3 + digit / 3 - 1;
+        h_y = h_y * 3 + digit % 3 - 1;
+    }
+
+    *level = (uint32_t) code_len - 2;
+    return adjust_xy(h_x, h_y, *level, out);
+}
+
+bool get_zone_by_code_fast(const geohex_code_t code, zone_t *out) {
+    if (!code || !out) {
+        return false;
+    }
+
+    uint32_t level;
+    xy_t xy;
+
+    if (!xy_by_code_digits(code, &level, &xy)) {
         return false;
     }
 
+    return get_zone_by_xy_fast(&xy, level, out);
+}
+
+static void xy_to_grid(int32_t h_x, int32_t h_y, uint32_t level, double *h_lon, double *h_lat) {
     double h_size = calc_hex_size(level);
-    int32_t h_x = xy->x, h_y = xy->y;
 
     double unit_x = 6.0 * h_size;
     double unit_y = 6.0 * h_size * H_K;
 
-    double h_lat = (H_K * h_x * unit_x + h_y * unit_y) / 2.0;
-    double h_lon = (h_lat - h_y * unit_y) / H_K;
+    *h_lat = (H_K * h_x * unit_x + h_y * unit_y) / 2.0;
+    *h_lon = (*h_lat - h_y * unit_y) / H_K;
+}
 
-    double z_loc_x, z_loc_y;
-    xy2loc(h_lon, h_lat, &z_loc_x, &z_loc_y);
+/* the zone straddling the antimeridian, reported on its -180 side */
+static inline bool on_seam(int32_t h_x, int32_t h_y, uint32_t level) {
+    return h_x - h_y == (int32_t) pow3_table[level + 2];
+}
 
-    int32_t max_hsteps = pow3_table[level + 2];
-    if (abs(h_x - h_y) == max_hsteps && h_x > h_y) {
+static void xy_to_digits(int32_t h_x, int32_t h_y, uint32_t level, double *z_loc_x, int32_t *h_code_digits) {
+    if (on_seam(h_x, h_y, level)) {
         int32_t tmp = h_x;
         h_x = h_y;
         h_y = tmp;
-        z_loc_x = -180.0;
+        *z_loc_x = -180.0;
     }
 
     int32_t code3_x[MAX_CODE_LEN + 2], code3_y[MAX_CODE_LEN + 2];
@@ -280,27 +472,14 @@ bool get_zone_by_xy(const xy_t *xy, uint32_t level, zone_t *out) {
         int32_t h_pow = pow3_table[level + 2 - i];
         int32_t half_h_pow = (h_pow + 1) / 2;
 
-        if (mod_x >= half_h_pow) {
-            code3_x[i] = 2;
-            mod_x -= h_pow;
-        } else if (mod_x <= -half_h_pow) {
-            code3_x[i] = 0;
-            mod_x += h_pow;
-        } else {
-            code3_x[i] = 1;
-        }
+        /* branch free: the digits of neighbouring zones are not predictable */
+        code3_x[i] = (mod_x >= half_h_pow) - (mod_x <= -half_h_pow) + 1;
+        mod_x -= (code3_x[i] - 1) * h_pow;
 
-        if (mod_y >= half_h_pow) {
-            code3_y[i] = 2;
-            mod_y -= h_pow;
-        } else if (mod_y <= -half_h_pow) {
-            code3_y[i] = 0;
-            mod_y += h_pow;
-        } else {
-            code3_y[i] = 1;
-        }
+        code3_y[i] = (mod_y >= half_h_pow) - (mod_y <= -half_h_pow) + 1;
+        mod_y -= (code3_y[i] - 1) * h_pow;
 
-        if (i == 2 && (z_loc_x == -180.0 || z_loc_x >= 0.0)) {
+        if (i == 2 && (*z_loc_x == -180.0 || *z_loc_x >= 0.0)) {
             if (code3_x[0] == 2 && code3_y[0] == 1 &&
                 code3_x[1] == code3_y[1] && code3_x[2] == code3_y[2]) {
                 code3_x[0] = 1;
@@ -313,17 +492,65 @@ bool get_zone_by_xy(const xy_t *xy, uint32_t level, zone_t *out) {
         }
     }
 
-    int32_t h_code_digits[MAX_CODE_LEN + 2];
     for (int32_t i = 0; i <= level + 2; i++) {
         h_code_digits[i] = code3_x[i] * 3 + code3_y[i];
     }
+}
+
+static inline void mercator_center(const xy_t *xy, uint32_t level, double *dx, double *dy) {
+    xy_to_grid(xy->x, xy->y, level, dx, dy);
+    /* match the -180 longitude get_zone_by_xy() gives a seam zone */
+    if (on_seam(xy->x, xy->y, level)) {
+        *dx = -H_BASE;
+    }
+}
+
+bool get_mercator_center_by_xy(const xy_t *xy, uint32_t level, double *dx, double *dy) {
+    if (!xy || !dx || !dy || level > MAX_LEVEL) {
+        return false;
+    }
+
+    mercator_center(xy, level, dx, dy);
+    return true;
+}
+
+bool get_mercator_centers_by_xys(const xy_t *xys, size_t n, uint32_t level, double *dx, double *dy) {
+    if (((!xys || !dx || !dy) && n) || level > MAX_LEVEL) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        mercator_center(&xys[i], level, &dx[i], &dy[i]);
+    }
+
+    return true;
+}
+
+static bool zone_by_xy(const xy_t *xy, uint32_t level, bool fast, zone_t *out) {
+    if (!xy || !out) {
+        return false;
+    }
+
+    double h_lon, h_lat;
+    xy_to_grid(xy->x, xy->y, level, &h_lon, &h_lat);
+
+    double z_loc_x, z_loc_y;
+    if (fast) {
+        z_loc_x = (h_lon / H_BASE) * 180.0;
+        z_loc_y = mercator_lat_fast(h_lat);
+    } else {
+        xy2loc(h_lon, h_lat, &z_loc_x, &z_loc_y);
+    }
+
+    int32_t h_code_digits[MAX_CODE_LEN + 2];
+    xy_to_digits(xy->x, xy->y, level, &z_loc_x, h_code_digits);
 
     int32_t h_1_int = h_code_digits[0] * 100 + h_code_digits[1] * 10 + h_code_digits[2];
     int32_t h_a1 = h_1_int / 30;
     int32_t h_a2 = h_1_int % 30;
 
-    out->code[0] = GEOHEX_KEY[h_a1];
-    out->code[1] = GEOHEX_KEY[h_a2];
+    out->code[0] = index_to_char(h_a1);
+    out->code[1] = index_to_char(h_a2);
 
     for (int32_t i = 3; i <= level + 2; i++) {
         out->code[i - 1] = '0' + h_code_digits[i];
@@ -336,3 +563,199 @@ bool get_zone_by_xy(const xy_t *xy, uint32_t level, zone_t *out) {
 
     return true;
 }
+
+bool get_zone_by_xy(const xy_t *xy, uint32_t level, zone_t *out) {
+    return zone_by_xy(xy, level, false, out);
+}
+
+bool get_zone_by_xy_fast(const xy_t *xy, uint32_t level, zone_t *out) {
+    return zone_by_xy(xy, level, true, out);
+}
+
+bool get_zones_by_locations(const loc_t *locations, size_t n, uint32_t level, zone_t *out) {
+    if ((!locations || !out) && n) {
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        ok &= get_zone_by_location(&locations[i], level, &out[i]);
+    }
+
+    return ok;
+}
+
+bool get_zones_by_codes(const geohex_code_t *codes, size_t n, zone_t *out) {
+    if ((!codes || !out) && n) {
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        ok &= get_zone_by_code(codes[i], &out[i]);
+    }
+
+    return ok;
+}
+
+bool get_zones_by_codes_fast(const geohex_code_t *codes, size_t n, zone_t *out) {
+    if ((!codes || !out) && n) {
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        ok &= get_zone_by_code_fast(codes[i], &out[i]);
+    }
+
+    return ok;
+}
+
+bool get_id_by_xy(const xy_t *xy, uint32_t level, geohex_id_t *out) {
+    if (!xy || !out || level > MAX_LEVEL) {
+        return false;
+    }
+
+    double h_lon, h_lat;
+    xy_to_grid(xy->x, xy->y, level, &h_lon, &h_lat);
+
+    double z_loc_x = (h_lon / H_BASE) * 180.0;
+
+    int32_t h_code_digits[MAX_CODE_LEN + 2];
+    xy_to_digits(xy->x, xy->y, level, &z_loc_x, h_code_digits);
+
+    uint64_t value = 0;
+    for (uint32_t i = 0; i <= level + 2; i++) {
+        value += (uint64_t) h_code_digits[i] * pow9_table[MAX_LEVEL + 2 - i];
+    }
+
+    *out = (value << GEOHEX_ID_LEVEL_BITS) | level;
+    return true;
+}
+
+bool get_ids_by_e7(const int32_t *lon_e7, const int32_t *lat_e7, size_t n, uint32_t level, geohex_id_t *out) {
+    if (((!lon_e7 || !lat_e7 || !out) && n) || level > MAX_LEVEL) {
+        return false;
+    }
+
+    xy_t xys[E7_BLOCK];
+    bool ok = true;
+
+    for (size_t begin = 0; begin < n; begin += E7_BLOCK) {
+        size_t count = n - begin < E7_BLOCK ? n - begin : E7_BLOCK;
+
+        ok &= xys_by_e7(lon_e7 + begin, lat_e7 + begin, count, level, xys);
+        for (size_t i = 0; i < count; i++) {
+            ok &= get_id_by_xy(&xys[i], level, &out[begin + i]);
+        }
+    }
+
+    return ok;
+}
+
+bool get_id_by_code(const geohex_code_t code, geohex_id_t *out) {
+    if (!code || !out) {
+        return false;
+    }
+
+    size_t code_len = strlen(code);
+    if (code_len < 2 || code_len >= MAX_CODE_LEN) {
+        return false;
+    }
+
+    int32_t c1_idx = char_to_index(code[0]);
+    int32_t c2_idx = char_to_index(code[1]);
+    if (c1_idx == -1 || c2_idx == -1) {
+        return false;
+    }
+
+    int32_t h_1_int = c1_idx * 30 + c2_idx;
+    if (h_1_int > 888 || h_1_int / 10 % 10 == 9 || h_1_int % 10 == 9) {
+        return false;
+    }
+
+    uint32_t level = code_len - 2;
+    uint64_t value = (uint64_t) (h_1_int / 100) * pow9_table[MAX_LEVEL + 2] +
+                     (uint64_t) (h_1_int / 10 % 10) * pow9_table[MAX_LEVEL + 1] +
+                     (uint64_t) (h_1_int % 10) * pow9_table[MAX_LEVEL];
+
+    for (uint32_t i = 2; i < code_len; i++) {
+        if (code[i] < '0' || code[i] > '8') {
+            return false;
+        }
+        value += (uint64_t) (code[i] - '0') * pow9_table[MAX_LEVEL + 1 - i];
+    }
+
+    *out = (value << GEOHEX_ID_LEVEL_BITS) | level;
+    return true;
+}
+
+bool get_code_by_id(geohex_id_t id, geohex_code_t out) {
+    if (!out) {
+        return false;
+    }
+
+    uint32_t level = get_level_by_id(id);
+    uint64_t value = id >> GEOHEX_ID_LEVEL_BITS;
+    if (level > MAX_LEVEL || value >= pow9_table[MAX_LEVEL + 3] ||
+        value % pow9_table[MAX_LEVEL - level] != 0) {
+        return false;
+    }
+
+    int32_t h_code_digits[MAX_CODE_LEN + 2];
+    for (uint32_t i = 0; i <= level + 2; i++) {
+        h_code_digits[i] = (int32_t) (value / pow9_table[MAX_LEVEL + 2 - i] % 9);
+    }
+
+    int32_t h_1_int = h_code_digits[0] * 100 + h_code_digits[1] * 10 + h_code_digits[2];
+    out[0] = index_to_char(h_1_int / 30);
+    out[1] = index_to_char(h_1_int % 30);
+
+    for (uint32_t i = 3; i <= level + 2; i++) {
+        out[i - 1] = '0' + h_code_digits[i];
+    }
+    out[level + 2] = '\0';
+
+    return true;
+}
+
+bool get_xy_by_id(geohex_id_t id, xy_t *out) {
+    geohex_code_t code;
+
+    if (!out || !get_code_by_id(id, code)) {
+        return false;
+    }
+
+    return get_xy_by_code(code, out);
+}
+
+bool get_zone_by_id(geohex_id_t id, zone_t *out) {
+    geohex_code_t code;
+
+    if (!out || !get_code_by_id(id, code)) {
+        return false;
+    }
+
+    return get_zone_by_code(code, out);
+}
+
+uint32_t get_level_by_id(geohex_id_t id) {
+    return (uint32_t) (id & ((1u << GEOHEX_ID_LEVEL_BITS) - 1));
+}
+
+bool get_parent_id(geohex_id_t id, uint32_t level, geohex_id_t *out) {
+    if (!out) {
+        return false;
+    }
+
+    uint32_t id_level = get_level_by_id(id);
+    if (id_level > MAX_LEVEL || level > id_level) {
+        return false;
+    }
+
+    uint64_t value = id >> GEOHEX_ID_LEVEL_BITS;
+    value -= value % pow9_table[MAX_LEVEL - level];
+
+    *out = (value << GEOHEX_ID_LEVEL_BITS) | level;
+    return true;
+}
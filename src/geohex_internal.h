@@ -0,0 +1,160 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_INTERNAL_H
+#define GEOHEX_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "geohex/geohex.h"
+
+/*
+ * get_xy_by_location() partitions Mercator into exact hexagons, so a zone is
+ * shrunk only to absorb floating point error, below 1e-7 of a zone even at
+ * MAX_LEVEL on the antimeridian.
+ */
+#define ZONE_INNER_MARGIN   0.999999
+
+/* the 52 letters of the two-letter code prefix */
+#define GEOHEX_KEY          "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+
+/* half the Web Mercator world width in metres */
+#define H_BASE              20037508.34
+#define SQRT3               1.7320508075688772
+
+extern const uint32_t pow3_table[];
+extern const uint64_t pow9_table[];
+/* counter-clockwise, starting upwards; a ring starts at radius * direction 4 */
+extern const int32_t direction_x[6];
+extern const int32_t direction_y[6];
+
+double calc_hex_size(uint32_t level);
+void loc2xy(double lon, double lat, double *dx, double *dy);
+void xy2loc(double dx, double dy, double *lon, double *lat);
+/* lon/lat box inside the zone at xy; any point in it rounds to that zone */
+void zone_inner_box(const xy_t *xy, uint32_t level, loc_t *min, loc_t *max);
+
+/* Position of a code prefix letter in GEOHEX_KEY, or -1. */
+static inline int char_to_index(char c) {
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A';
+    } else if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 26;
+    } else {
+        return -1;
+    }
+}
+
+static inline char index_to_char(int32_t index) {
+    return GEOHEX_KEY[index];
+}
+
+/*
+ * A zone is a flat-topped hexagon in Mercator centred on
+ * (3s(x - y), sqrt(3)s(x + y)) with circumradius 2s; x and y may be unwrapped.
+ */
+static inline void lattice_center(double h_size, int32_t x, int32_t y, double *cx, double *cy) {
+    *cx = 3.0 * h_size * ((double) x - (double) y);
+    *cy = SQRT3 * h_size * ((double) x + (double) y);
+}
+
+/* Lattice steps between two unwrapped zones. */
+static inline uint32_t step_distance(int64_t dx, int64_t dy) {
+    int64_t ax = dx < 0 ? -dx : dx, ay = dy < 0 ? -dy : dy;
+
+    if ((dx < 0) == (dy < 0)) {
+        return (uint32_t) (ax > ay ? ax : ay);
+    }
+
+    return (uint32_t) (ax + ay);
+}
+
+/* Exclusive upper bound of the ids of id and all of its descendants. */
+static inline geohex_id_t id_range_end(geohex_id_t id) {
+    uint32_t level = get_level_by_id(id);
+
+    return (id - level) + (pow9_table[MAX_LEVEL - level] << GEOHEX_ID_LEVEL_BITS);
+}
+
+static inline bool id_covers(geohex_id_t ancestor, geohex_id_t id) {
+    return ancestor <= id && id < id_range_end(ancestor);
+}
+
+/* The child_index-th (0 to 8) child of id, which must be below MAX_LEVEL. */
+static inline geohex_id_t id_child(geohex_id_t id, uint32_t child_index) {
+    uint32_t level = get_level_by_id(id);
+
+    return (id - level) + ((child_index * pow9_table[MAX_LEVEL - level - 1]) << GEOHEX_ID_LEVEL_BITS) + level + 1;
+}
+
+/*
+ * get_xy_by_code() reads the three leading code digits as the decimal
+ * string of the prefix and bumps a leading 1 or 5; this is that rule on
+ * the digits.
+ */
+static inline void decode_prefix_digits(int32_t lead[3]) {
+    int32_t first = lead[0] ? 0 : (lead[1] ? 1 : 2);
+    bool loose = true;
+
+    for (int32_t i = first + 1; i < 3; i++) {
+        loose &= lead[i] != 1 && lead[i] != 2 && lead[i] != 5;
+    }
+    if ((lead[first] == 1 || lead[first] == 5) && loose) {
+        lead[first] += 2;
+    }
+}
+
+/* Fixed little-endian accessors for the portable byte formats. */
+static inline void put_le16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t) v;
+    p[1] = (uint8_t) (v >> 8);
+}
+
+static inline void put_le32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (uint8_t) (v >> (i * 8));
+    }
+}
+
+static inline void put_le64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t) (v >> (i * 8));
+    }
+}
+
+static inline uint16_t get_le16(const uint8_t *p) {
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_le32(const uint8_t *p) {
+    uint32_t v = 0;
+
+    for (int i = 3; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+
+    return v;
+}
+
+static inline uint64_t get_le64(const uint8_t *p) {
+    uint64_t v = 0;
+
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+
+    return v;
+}
+
+#endif /* GEOHEX_INTERNAL_H */
@@ -0,0 +1,355 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/grid.h"
+
+#include "geohex_internal.h"
+
+#define GRID_BLOCK 256
+
+typedef struct {
+    uint32_t level;
+    int64_t period;
+    /* the largest magnitude level + 3 balanced ternary digits can hold */
+    int64_t limit;
+    int64_t sum_min;
+    int64_t diff_min;
+    /* zone centres by x + y and by x - y, the two axes of Web Mercator */
+    double *lat;
+    double *lon;
+    geohex_grid_fn fn;
+    void *arg;
+    size_t pending;
+    zone_t zones[GRID_BLOCK];
+} grid_t;
+
+static inline int64_t floor_div(int64_t a, int64_t b) {
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+static bool build_tables(grid_t *g, int64_t x_min, int64_t y_min, int64_t x_max, int64_t y_max) {
+    double h_size = calc_hex_size(g->level);
+    double unit_y = 6.0 * h_size * tan(M_PI / 6.0);
+    size_t sums = (size_t) (x_max + y_max - x_min - y_min + 1);
+    size_t diffs = (size_t) (x_max - y_min - x_min + y_max + 1);
+    double unused;
+
+    g->sum_min = x_min + y_min;
+    g->diff_min = x_min - y_max;
+    g->lat = malloc(sums * sizeof(double));
+    g->lon = malloc(diffs * sizeof(double));
+    if (!g->lat || !g->lon) {
+        return false;
+    }
+
+    for (size_t i = 0; i < sums; i++) {
+        xy2loc(0.0, unit_y * (double) (g->sum_min + (int64_t) i) / 2.0, &unused, &g->lat[i]);
+    }
+    for (size_t i = 0; i < diffs; i++) {
+        xy2loc(3.0 * h_size * (double) (g->diff_min + (int64_t) i), 0.0, &g->lon[i], &unused);
+    }
+
+    return true;
+}
+
+/* Same digits as the greedy split of get_zone_by_xy(), most significant first. */
+static void to_ternary(int64_t value, uint32_t top, uint8_t *code3) {
+    for (uint32_t i = 0; i <= top; i++) {
+        int64_t h_pow = pow3_table[top - i];
+
+        if (value >= (h_pow + 1) / 2) {
+            code3[i] = 2;
+            value -= h_pow;
+        } else if (value <= -(h_pow + 1) / 2) {
+            code3[i] = 0;
+            value += h_pow;
+        } else {
+            code3[i] = 1;
+        }
+    }
+}
+
+static void flush(grid_t *g) {
+    if (g->pending) {
+        g->fn(g->arg, g->zones, g->pending);
+        g->pending = 0;
+    }
+}
+
+/* The seam and the far polar rows go through the full conversion. */
+static void slow_zone(const grid_t *g, int64_t x, int64_t y, zone_t *zone) {
+    xy_t origin = {0, 0, false}, xy;
+    ij_t ij = {(int32_t) x, (int32_t) y};
+
+    get_xy_by_local_ij(&origin, &ij, g->level, &xy);
+    get_zone_by_xy(&xy, g->level, zone);
+}
+
+static inline void emit(grid_t *g) {
+    if (++g->pending == GRID_BLOCK) {
+        flush(g);
+    }
+}
+
+/*
+ * Walks x_begin..x_end along row y in lap k, every cell holding digits.
+ * Stepping x adds one to the balanced ternary digits of x, so only the
+ * digits the carry reaches are rewritten in the code, and the centre is two
+ * table lookups.
+ */
+static void walk_lap(grid_t *g, int64_t y, int64_t x_begin, int64_t x_end, int64_t k) {
+    uint32_t top = g->level + 2;
+    int64_t cy = y + k * g->period;
+    uint8_t code3_x[MAX_CODE_LEN + 2], code3_y[MAX_CODE_LEN + 2];
+    char code[MAX_CODE_LEN] = {0};
+    const double *lat = g->lat + (x_begin + y - g->sum_min);
+    const double *lon = g->lon + (x_begin - y - g->diff_min);
+    double lon_shift = 360.0 * (double) k;
+
+    to_ternary(x_begin - k * g->period, top, code3_x);
+    to_ternary(cy, top, code3_y);
+
+    for (int64_t x = x_begin; x <= x_end; x++) {
+        zone_t *zone = &g->zones[g->pending];
+        int64_t cx = x - k * g->period;
+        uint32_t changed = 0;
+
+        if (x != x_begin) {
+            changed = top;
+            while (code3_x[changed] == 2) {
+                code3_x[changed--] = 0;
+            }
+            code3_x[changed]++;
+        }
+
+        for (uint32_t i = changed < 3 ? 3 : changed; i <= top; i++) {
+            code[i - 1] = (char) ('0' + code3_x[i] * 3 + code3_y[i]);
+        }
+
+        /* the prefix only moves with the top digits or the sign of x - y */
+        if (changed < 3 || cx == cy) {
+            int32_t h_0x = code3_x[0], h_0y = code3_y[0];
+
+            if (cx >= cy && code3_x[1] == code3_y[1] && code3_x[2] == code3_y[2]) {
+                if (h_0x == 2 && h_0y == 1) {
+                    h_0x = 1;
+                    h_0y = 2;
+                } else if (h_0x == 1 && h_0y == 0) {
+                    h_0x = 0;
+                    h_0y = 1;
+                }
+            }
+            int32_t h_1_int = (h_0x * 3 + h_0y) * 100 + (code3_x[1] * 3 + code3_y[1]) * 10 + code3_x[2] * 3 + code3_y[2];
+
+            code[0] = index_to_char(h_1_int / 30);
+            code[1] = index_to_char(h_1_int % 30);
+        }
+        memcpy(zone->code, code, MAX_CODE_LEN);
+
+        zone->latlon.lat = lat[x - x_begin];
+        zone->latlon.lon = lon[x - x_begin] - lon_shift;
+        zone->xy.x = (int32_t) cx;
+        zone->xy.y = (int32_t) cy;
+        zone->xy.rev = false;
+        emit(g);
+    }
+}
+
+/*
+ * Splits row y into laps around the globe. Inside a lap the digits carry
+ * from cell to cell; the seam cell closing each lap and the far polar cells
+ * the digits cannot hold take the full conversion.
+ */
+static void walk_row(grid_t *g, int64_t y, int64_t x_begin, int64_t x_end) {
+    int64_t period = g->period;
+
+    for (int64_t x = x_begin; x <= x_end;) {
+        /* the lap that brings x - y into (-period, period] */
+        int64_t k = floor_div(x - y + period - 1, 2 * period);
+        int64_t seam = y + k * 2 * period + period;
+        int64_t cy = y + k * period;
+        int64_t lap_end = seam < x_end ? seam : x_end;
+        int64_t fast_begin = x, fast_end = lap_end;
+
+        if (fast_end == seam) {
+            fast_end--;
+        }
+        if (llabs(cy) > g->limit) {
+            fast_end = fast_begin - 1;
+        } else {
+            int64_t lo = k * period - g->limit, hi = k * period + g->limit;
+
+            fast_begin = fast_begin > lo ? fast_begin : lo;
+            fast_end = fast_end < hi ? fast_end : hi;
+        }
+
+        if (fast_begin > fast_end) {
+            fast_begin = lap_end + 1;
+            fast_end = lap_end;
+        }
+        for (; x < fast_begin; x++) {
+            slow_zone(g, x, y, &g->zones[g->pending]);
+            emit(g);
+        }
+        if (fast_begin <= fast_end) {
+            walk_lap(g, y, fast_begin, fast_end, k);
+            x = fast_end + 1;
+        }
+        for (; x <= lap_end; x++) {
+            slow_zone(g, x, y, &g->zones[g->pending]);
+            emit(g);
+        }
+    }
+}
+
+static grid_t *grid_create(uint32_t level, geohex_grid_fn fn, void *arg) {
+    grid_t *g = malloc(sizeof(grid_t));
+
+    if (!g) {
+        return NULL;
+    }
+
+    g->level = level;
+    g->period = pow3_table[level + 2];
+    g->limit = ((int64_t) pow3_table[level + 3] - 1) / 2;
+    g->lat = NULL;
+    g->lon = NULL;
+    g->fn = fn;
+    g->arg = arg;
+    g->pending = 0;
+
+    return g;
+}
+
+static void grid_destroy(grid_t *g) {
+    free(g->lon);
+    free(g->lat);
+    free(g);
+}
+
+bool geohex_grid_rect(int32_t x_min, int32_t y_min, int32_t x_max, int32_t y_max, uint32_t level, geohex_grid_fn fn, void *arg) {
+    if (!fn || level > MAX_LEVEL || x_min > x_max || y_min > y_max) {
+        return false;
+    }
+
+    grid_t *g = grid_create(level, fn, arg);
+    if (!g || !build_tables(g, x_min, y_min, x_max, y_max)) {
+        if (g) {
+            grid_destroy(g);
+        }
+        return false;
+    }
+
+    for (int64_t y = y_min; y <= y_max; y++) {
+        walk_row(g, y, x_min, x_max);
+    }
+    flush(g);
+
+    grid_destroy(g);
+    return true;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double da = *(const double *) a, db = *(const double *) b;
+
+    return (da > db) - (da < db);
+}
+
+bool geohex_grid_polygon(const loc_t *vertices, const size_t *ring_sizes, size_t rings, uint32_t level, geohex_grid_fn fn, void *arg) {
+    if (!vertices || !ring_sizes || rings == 0 || !fn || level > MAX_LEVEL) {
+        return false;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < rings; i++) {
+        if (ring_sizes[i] < 3) {
+            return false;
+        }
+        total += ring_sizes[i];
+    }
+    for (size_t i = 0; i < total; i++) {
+        if (!(fabs(vertices[i].lon) <= 180.0) || !(fabs(vertices[i].lat) < 90.0)) {
+            return false;
+        }
+    }
+
+    /*
+     * Lattice coordinates are linear in Web Mercator: a centre sits at
+     * (3s(x - y), sqrt(3)s(x + y)), so the polygon stays a polygon in (x, y)
+     * and each row of y crosses it in plain intervals of x.
+     */
+    double h_size = calc_hex_size(level);
+    double *u = malloc(total * sizeof(double));
+    double *v = malloc(total * sizeof(double));
+    double *crossings = malloc(total * sizeof(double));
+    double u_min = INFINITY, u_max = -INFINITY, v_min = INFINITY, v_max = -INFINITY;
+    grid_t *g = grid_create(level, fn, arg);
+    bool ok = u && v && crossings && g;
+
+    for (size_t i = 0; ok && i < total; i++) {
+        double mx, my;
+
+        loc2xy(vertices[i].lon, vertices[i].lat, &mx, &my);
+        u[i] = (mx / (3.0 * h_size) + my / (sqrt(3.0) * h_size)) / 2.0;
+        v[i] = (my / (sqrt(3.0) * h_size) - mx / (3.0 * h_size)) / 2.0;
+        u_min = fmin(u_min, u[i]);
+        u_max = fmax(u_max, u[i]);
+        v_min = fmin(v_min, v[i]);
+        v_max = fmax(v_max, v[i]);
+    }
+
+    int64_t x_min = (int64_t) ceil(u_min), x_max = (int64_t) floor(u_max);
+    int64_t y_min = (int64_t) ceil(v_min), y_max = (int64_t) floor(v_max);
+
+    if (ok && x_min <= x_max && y_min <= y_max) {
+        ok = build_tables(g, x_min, y_min, x_max, y_max);
+
+        for (int64_t y = y_min; ok && y <= y_max; y++) {
+            size_t count = 0;
+
+            for (size_t r = 0, start = 0; r < rings; start += ring_sizes[r++]) {
+                for (size_t i = 0; i < ring_sizes[r]; i++) {
+                    size_t a = start + i, b = start + (i + 1) % ring_sizes[r];
+
+                    /* half-open in v, so a vertex on the row counts once */
+                    if ((v[a] <= (double) y) != (v[b] <= (double) y)) {
+                        crossings[count++] = u[a] + ((double) y - v[a]) * (u[b] - u[a]) / (v[b] - v[a]);
+                    }
+                }
+            }
+            qsort(crossings, count, sizeof(double), compare_double);
+
+            /* x is inside when crossings[2i] <= x < crossings[2i + 1] */
+            for (size_t i = 0; i + 1 < count; i += 2) {
+                int64_t begin = (int64_t) ceil(crossings[i]), end = (int64_t) ceil(crossings[i + 1]) - 1;
+
+                walk_row(g, y, begin < x_min ? x_min : begin, end > x_max ? x_max : end);
+            }
+        }
+        flush(g);
+    }
+
+    if (g) {
+        grid_destroy(g);
+    }
+    free(crossings);
+    free(v);
+    free(u);
+
+    return ok;
+}
@@ -0,0 +1,223 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "idmap.h"
+
+#define IDMAP_MIN_CAPACITY  16
+
+static size_t capacity_for(size_t hint) {
+    size_t capacity = IDMAP_MIN_CAPACITY;
+
+    /* keep the load factor at or below 1/2 */
+    while (capacity < hint * 2) {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
+static bool alloc_slots(geohex_idmap_t *map, size_t capacity) {
+    uint64_t *keys = malloc(capacity * sizeof(uint64_t));
+    size_t *values = malloc(capacity * sizeof(size_t));
+
+    if (!keys || !values) {
+        free(keys);
+        free(values);
+        return false;
+    }
+
+    memset(keys, 0xff, capacity * sizeof(uint64_t));
+
+    map->keys = keys;
+    map->values = values;
+    map->capacity = capacity;
+    return true;
+}
+
+static bool grow(geohex_idmap_t *map) {
+    uint64_t *old_keys = map->keys;
+    size_t *old_values = map->values;
+    size_t old_capacity = map->capacity;
+
+    if (!alloc_slots(map, old_capacity * 2)) {
+        return false;
+    }
+
+    size_t mask = map->capacity - 1;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_keys[i] == IDMAP_EMPTY_KEY) {
+            continue;
+        }
+
+        size_t slot = idmap_hash(old_keys[i]) & mask;
+        while (map->keys[slot] != IDMAP_EMPTY_KEY) {
+            slot = (slot + 1) & mask;
+        }
+        map->keys[slot] = old_keys[i];
+        map->values[slot] = old_values[i];
+    }
+
+    free(old_keys);
+    free(old_values);
+    return true;
+}
+
+bool geohex_idmap_init(geohex_idmap_t *map, size_t hint) {
+    if (!map) {
+        return false;
+    }
+
+    map->size = 0;
+    map->has_empty_key = false;
+    map->empty_key_value = 0;
+
+    return alloc_slots(map, capacity_for(hint));
+}
+
+void geohex_idmap_free(geohex_idmap_t *map) {
+    if (!map) {
+        return;
+    }
+
+    free(map->keys);
+    free(map->values);
+    map->keys = NULL;
+    map->values = NULL;
+    map->capacity = 0;
+    map->size = 0;
+    map->has_empty_key = false;
+}
+
+void geohex_idmap_clear(geohex_idmap_t *map) {
+    memset(map->keys, 0xff, map->capacity * sizeof(uint64_t));
+    map->size = 0;
+    map->has_empty_key = false;
+}
+
+size_t *geohex_idmap_find(const geohex_idmap_t *map, uint64_t key) {
+    if (key == IDMAP_EMPTY_KEY) {
+        return map->has_empty_key ? (size_t *) &map->empty_key_value : NULL;
+    }
+
+    size_t mask = map->capacity - 1;
+    size_t slot = idmap_hash(key) & mask;
+
+    while (map->keys[slot] != IDMAP_EMPTY_KEY) {
+        if (map->keys[slot] == key) {
+            return &map->values[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return NULL;
+}
+
+size_t *geohex_idmap_insert(geohex_idmap_t *map, uint64_t key, bool *inserted) {
+    if (key == IDMAP_EMPTY_KEY) {
+        *inserted = !map->has_empty_key;
+        if (*inserted) {
+            map->has_empty_key = true;
+            map->size++;
+        }
+        return &map->empty_key_value;
+    }
+
+    if ((map->size + 1) * 2 > map->capacity && !grow(map)) {
+        return NULL;
+    }
+
+    size_t mask = map->capacity - 1;
+    size_t slot = idmap_hash(key) & mask;
+
+    while (map->keys[slot] != IDMAP_EMPTY_KEY) {
+        if (map->keys[slot] == key) {
+            *inserted = false;
+            return &map->values[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    map->keys[slot] = key;
+    map->size++;
+    *inserted = true;
+    return &map->values[slot];
+}
+
+bool geohex_idmap_remove(geohex_idmap_t *map, uint64_t key) {
+    if (key == IDMAP_EMPTY_KEY) {
+        if (!map->has_empty_key) {
+            return false;
+        }
+        map->has_empty_key = false;
+        map->size--;
+        return true;
+    }
+
+    size_t mask = map->capacity - 1;
+    size_t hole = idmap_hash(key) & mask;
+
+    while (map->keys[hole] != key) {
+        if (map->keys[hole] == IDMAP_EMPTY_KEY) {
+            return false;
+        }
+        hole = (hole + 1) & mask;
+    }
+
+    /* pull back every later key in the run whose home slot is not between the hole and it */
+    for (size_t slot = (hole + 1) & mask; map->keys[slot] != IDMAP_EMPTY_KEY; slot = (slot + 1) & mask) {
+        size_t home = idmap_hash(map->keys[slot]) & mask;
+
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            map->keys[hole] = map->keys[slot];
+            map->values[hole] = map->values[slot];
+            hole = slot;
+        }
+    }
+
+    map->keys[hole] = IDMAP_EMPTY_KEY;
+    map->size--;
+    return true;
+}
+
+bool geohex_idmap_reserve(geohex_idmap_t *map, size_t n) {
+    while ((map->size + n) * 2 > map->capacity) {
+        if (!grow(map)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void geohex_idmap_insert_concurrent(geohex_idmap_t *map, uint64_t key, size_t value) {
+    if (key == IDMAP_EMPTY_KEY) {
+        map->has_empty_key = true;
+        map->empty_key_value = value;
+        return;
+    }
+
+    size_t mask = map->capacity - 1;
+    size_t slot = idmap_hash(key) & mask;
+
+    for (;;) {
+        uint64_t expected = IDMAP_EMPTY_KEY;
+
+        if (__atomic_compare_exchange_n(&map->keys[slot], &expected, key, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            map->values[slot] = value;
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#ifndef GEOHEX_IDMAP_H
+#define GEOHEX_IDMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Open addressing (linear probing) map from a 64 bit key to a size_t value.
+ * Used internally to key per-zone state by geohex_id_t or by a packed xy.
+ */
+#define IDMAP_EMPTY_KEY UINT64_MAX
+
+typedef struct _geohex_idmap_t {
+    uint64_t *keys;
+    size_t *values;
+    size_t capacity;
+    size_t size;
+    bool has_empty_key;
+    size_t empty_key_value;
+} geohex_idmap_t;
+
+static inline uint64_t idmap_hash(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+static inline uint64_t idmap_xy_key(int32_t x, int32_t y) {
+    return ((uint64_t) (uint32_t) x << 32) | (uint32_t) y;
+}
+
+bool geohex_idmap_init(geohex_idmap_t *map, size_t hint);
+void geohex_idmap_free(geohex_idmap_t *map);
+void geohex_idmap_clear(geohex_idmap_t *map);
+size_t *geohex_idmap_find(const geohex_idmap_t *map, uint64_t key);
+size_t *geohex_idmap_insert(geohex_idmap_t *map, uint64_t key, bool *inserted);
+/* Removes key by shifting its probe run back, so no tombstones are left. */
+bool geohex_idmap_remove(geohex_idmap_t *map, uint64_t key);
+
+/*
+ * Bulk loading from several threads: reserve room for n more keys first, then
+ * insert keys known to be absent concurrently. insert_concurrent never grows
+ * the map and leaves map->size alone; the caller adds the number of inserted
+ * keys once every writer has finished.
+ */
+bool geohex_idmap_reserve(geohex_idmap_t *map, size_t n);
+void geohex_idmap_insert_concurrent(geohex_idmap_t *map, uint64_t key, size_t value);
+
+#endif /* GEOHEX_IDMAP_H */
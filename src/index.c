@@ -0,0 +1,313 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "geohex/geohex.h"
+#include "geohex/index.h"
+
+#include "geohex_internal.h"
+
+#define INDEX_MAGIC         "GHIX"
+#define INDEX_VERSION       1
+#define INDEX_HEADER_SIZE   80
+#define INDEX_FENCE_STRIDE  1024
+
+/*
+ * Layout, all integers little-endian and every section 8 byte aligned:
+ *   header:   "GHIX", u32 version, u64 count, u32 fence stride, u32 reserved,
+ *             u64 fence count, u64 offsets of the id, payload offset, fence
+ *             and payload sections, u64 payload size, u64 reserved
+ *   ids:      count x u64, ascending
+ *   offsets:  (count + 1) x u64 into the payload section
+ *   fences:   every fence stride-th id, small enough to stay in cache
+ *   payload:  concatenated entry data
+ */
+struct _geohex_index_t {
+    const uint8_t *map;
+    size_t map_size;
+    size_t count;
+    size_t fence_stride;
+    size_t fence_count;
+    const uint8_t *ids;
+    const uint8_t *offsets;
+    const uint8_t *fences;
+    const uint8_t *payload;
+    uint64_t payload_size;
+};
+
+static int compare_entry(const void *a, const void *b) {
+    geohex_id_t id_a = (*(const geohex_index_entry_t *const *) a)->id;
+    geohex_id_t id_b = (*(const geohex_index_entry_t *const *) b)->id;
+
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+static bool write_le64(FILE *fp, uint64_t v) {
+    uint8_t buf[8];
+
+    put_le64(buf, v);
+    return fwrite(buf, 1, sizeof(buf), fp) == sizeof(buf);
+}
+
+bool geohex_index_write(const char *path, const geohex_index_entry_t *entries, size_t n) {
+    if (!path || (!entries && n)) {
+        return false;
+    }
+
+    const geohex_index_entry_t **sorted = malloc((n ? n : 1) * sizeof(geohex_index_entry_t *));
+    if (!sorted) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (entries[i].size && !entries[i].data) {
+            free(sorted);
+            return false;
+        }
+        sorted[i] = &entries[i];
+    }
+    qsort(sorted, n, sizeof(geohex_index_entry_t *), compare_entry);
+
+    for (size_t i = 1; i < n; i++) {
+        if (sorted[i - 1]->id == sorted[i]->id) {
+            free(sorted);
+            return false;
+        }
+    }
+
+    uint64_t fence_count = (n + INDEX_FENCE_STRIDE - 1) / INDEX_FENCE_STRIDE;
+    uint64_t ids_offset = INDEX_HEADER_SIZE;
+    uint64_t offsets_offset = ids_offset + (uint64_t) n * 8;
+    uint64_t fences_offset = offsets_offset + ((uint64_t) n + 1) * 8;
+    uint64_t payload_offset = fences_offset + fence_count * 8;
+    uint64_t payload_size = 0;
+    uint8_t header[INDEX_HEADER_SIZE] = {0};
+    FILE *fp;
+    bool ok;
+
+    for (size_t i = 0; i < n; i++) {
+        payload_size += sorted[i]->size;
+    }
+
+    memcpy(header, INDEX_MAGIC, 4);
+    put_le32(header + 4, INDEX_VERSION);
+    put_le64(header + 8, (uint64_t) n);
+    put_le32(header + 16, INDEX_FENCE_STRIDE);
+    put_le64(header + 24, fence_count);
+    put_le64(header + 32, ids_offset);
+    put_le64(header + 40, offsets_offset);
+    put_le64(header + 48, fences_offset);
+    put_le64(header + 56, payload_offset);
+    put_le64(header + 64, payload_size);
+
+    fp = fopen(path, "wb");
+    if (!fp) {
+        free(sorted);
+        return false;
+    }
+
+    ok = fwrite(header, 1, sizeof(header), fp) == sizeof(header);
+
+    for (size_t i = 0; ok && i < n; i++) {
+        ok = write_le64(fp, sorted[i]->id);
+    }
+
+    payload_size = 0;
+    for (size_t i = 0; ok && i <= n; i++) {
+        ok = write_le64(fp, payload_size);
+        if (i < n) {
+            payload_size += sorted[i]->size;
+        }
+    }
+
+    for (size_t i = 0; ok && i < n; i += INDEX_FENCE_STRIDE) {
+        ok = write_le64(fp, sorted[i]->id);
+    }
+
+    for (size_t i = 0; ok && i < n; i++) {
+        if (sorted[i]->size) {
+            ok = fwrite(sorted[i]->data, 1, sorted[i]->size, fp) == sorted[i]->size;
+        }
+    }
+
+    ok = (fclose(fp) == 0) && ok;
+    free(sorted);
+
+    if (!ok) {
+        remove(path);
+    }
+
+    return ok;
+}
+
+static bool section_fits(uint64_t offset, uint64_t entries, uint64_t file_size) {
+    return offset <= file_size && (offset & 7) == 0 && entries <= (file_size - offset) / 8;
+}
+
+geohex_index_t *geohex_index_open(const char *path) {
+    geohex_index_t *index;
+    struct stat st;
+    void *map;
+    int fd;
+
+    if (!path) {
+        return NULL;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (fstat(fd, &st) != 0 || st.st_size < INDEX_HEADER_SIZE || (uint64_t) st.st_size > SIZE_MAX) {
+        close(fd);
+        return NULL;
+    }
+
+    map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    /* lookups are random probes; do not let readahead inflate the page cache */
+    posix_madvise(map, (size_t) st.st_size, POSIX_MADV_RANDOM);
+
+    const uint8_t *header = map;
+    uint64_t file_size = (uint64_t) st.st_size;
+    uint64_t count = get_le64(header + 8);
+    uint64_t fence_stride = get_le32(header + 16);
+    uint64_t fence_count = get_le64(header + 24);
+    uint64_t ids_offset = get_le64(header + 32);
+    uint64_t offsets_offset = get_le64(header + 40);
+    uint64_t fences_offset = get_le64(header + 48);
+    uint64_t payload_offset = get_le64(header + 56);
+    uint64_t payload_size = get_le64(header + 64);
+
+    if (memcmp(header, INDEX_MAGIC, 4) != 0 || get_le32(header + 4) != INDEX_VERSION || fence_stride == 0 ||
+        count >= SIZE_MAX / 8 || fence_count != (count + fence_stride - 1) / fence_stride ||
+        !section_fits(ids_offset, count, file_size) || !section_fits(offsets_offset, count + 1, file_size) ||
+        !section_fits(fences_offset, fence_count, file_size) || payload_offset > file_size ||
+        payload_size > file_size - payload_offset) {
+        munmap(map, (size_t) st.st_size);
+        return NULL;
+    }
+
+    index = malloc(sizeof(geohex_index_t));
+    if (!index) {
+        munmap(map, (size_t) st.st_size);
+        return NULL;
+    }
+
+    index->map = map;
+    index->map_size = (size_t) st.st_size;
+    index->count = (size_t) count;
+    index->fence_stride = (size_t) fence_stride;
+    index->fence_count = (size_t) fence_count;
+    index->ids = index->map + ids_offset;
+    index->offsets = index->map + offsets_offset;
+    index->fences = index->map + fences_offset;
+    index->payload = index->map + payload_offset;
+    index->payload_size = payload_size;
+
+    return index;
+}
+
+void geohex_index_close(geohex_index_t *index) {
+    if (!index) {
+        return;
+    }
+
+    munmap((void *) index->map, index->map_size);
+    free(index);
+}
+
+size_t geohex_index_size(const geohex_index_t *index) {
+    return index ? index->count : 0;
+}
+
+/* number of the first n u64 values at base that are <= key */
+static size_t upper_bound(const uint8_t *base, size_t n, uint64_t key) {
+    size_t lo = 0;
+
+    while (n > 0) {
+        size_t half = n / 2;
+
+        if (get_le64(base + (lo + half) * 8) <= key) {
+            lo += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+
+    return lo;
+}
+
+bool geohex_index_lookup_id(const geohex_index_t *index, geohex_id_t id, const void **data, size_t *size) {
+    if (!index || !data || !size) {
+        return false;
+    }
+
+    size_t fence = upper_bound(index->fences, index->fence_count, id);
+    if (fence == 0) {
+        return false;
+    }
+
+    size_t begin = (fence - 1) * index->fence_stride;
+    size_t n = index->count - begin < index->fence_stride ? index->count - begin : index->fence_stride;
+    size_t pos = begin + upper_bound(index->ids + begin * 8, n, id);
+
+    if (pos == begin || get_le64(index->ids + (pos - 1) * 8) != id) {
+        return false;
+    }
+
+    /* offsets are only checked when used, so opening never walks the file */
+    uint64_t start = get_le64(index->offsets + (pos - 1) * 8);
+    uint64_t end = get_le64(index->offsets + pos * 8);
+    if (start > end || end > index->payload_size) {
+        return false;
+    }
+
+    *data = index->payload + start;
+    *size = (size_t) (end - start);
+    return true;
+}
+
+bool geohex_index_lookup(const geohex_index_t *index, const geohex_code_t code, const void **data, size_t *size) {
+    geohex_id_t id;
+
+    if (!get_id_by_code(code, &id)) {
+        return false;
+    }
+
+    return geohex_index_lookup_id(index, id, data, size);
+}
+
+bool geohex_index_lookup_xy(const geohex_index_t *index, const xy_t *xy, uint32_t level, const void **data, size_t *size) {
+    geohex_id_t id;
+
+    if (!get_id_by_xy(xy, level, &id)) {
+        return false;
+    }
+
+    return geohex_index_lookup_id(index, id, data, size);
+}
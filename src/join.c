@@ -0,0 +1,409 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/join.h"
+
+#include "geohex_internal.h"
+#include "idmap.h"
+
+#define JOIN_EARTH_RADIUS   6371008.8
+/* Web Mercator is projected from the equatorial radius */
+#define JOIN_MERCATOR_RADIUS 6378137.0
+#define JOIN_MAX_LAT        89.0
+#define JOIN_BLOCK          256
+
+typedef struct {
+    const double *a_lon;
+    const double *a_lat;
+    const double *b_lon;
+    const double *b_lat;
+    uint32_t level;
+    uint32_t radius;
+    double chord2;
+    double polar_lat;
+    uint64_t *keys;
+    geohex_idmap_t buckets;
+    size_t *offsets;
+    size_t *order;
+    double *ux;
+    double *uy;
+    double *uz;
+    size_t *near_a;
+    size_t near_a_polar;
+    size_t near_a_count;
+    double *near_ux;
+    double *near_uy;
+    double *near_uz;
+    size_t *near_b;
+    geohex_join_fn fn;
+    void *arg;
+    bool failed;
+} join_job_t;
+
+static inline void unit_vector(double lon, double lat, double *x, double *y, double *z) {
+    double lon_rad = lon * M_PI / 180.0, lat_rad = lat * M_PI / 180.0;
+
+    *x = cos(lat_rad) * cos(lon_rad);
+    *y = cos(lat_rad) * sin(lon_rad);
+    *z = sin(lat_rad);
+}
+
+/* points this close to a pole are joined by a full scan of their latitude band */
+static inline bool is_polar(const join_job_t *job, double lat) {
+    return fabs(lat) > job->polar_lat;
+}
+
+static inline void push_pair(join_job_t *job, geohex_join_pair_t *pairs, size_t *pending, size_t a, size_t b, double chord2, uint32_t worker) {
+    pairs[*pending].a = a;
+    pairs[*pending].b = b;
+    pairs[*pending].distance = 2.0 * JOIN_EARTH_RADIUS * asin(fmin(1.0, sqrt(chord2) / 2.0));
+    if (++*pending == JOIN_BLOCK) {
+        job->fn(job->arg, pairs, *pending, worker);
+        *pending = 0;
+    }
+}
+
+/*
+ * Two points within meters are at most scale * meters apart in Mercator,
+ * scale being the Mercator stretch at the highest latitude either can reach.
+ * Zones whose centres are further apart than that plus two circumradii (4s)
+ * cannot hold a pair, and zones k steps apart have centres at least 3ks
+ * apart. Pick the finest level that keeps the probe within two steps.
+ */
+static void choose_level(double meters, double max_abs_lat, uint32_t *level, uint32_t *radius) {
+    double lat = fmin(max_abs_lat + meters / JOIN_EARTH_RADIUS * 180.0 / M_PI, JOIN_MAX_LAT);
+    double reach = meters * (JOIN_MERCATOR_RADIUS / JOIN_EARTH_RADIUS) / cos(lat * M_PI / 180.0) * (1.0 + 1e-9);
+    uint32_t l = MAX_LEVEL;
+
+    while (l > 0 && calc_hex_size(l) * 5.0 <= reach) {
+        l--;
+    }
+
+    double h_size = calc_hex_size(l);
+
+    *level = l;
+    *radius = (uint32_t) floor((reach + 4.0 * h_size) / (3.0 * h_size));
+}
+
+static void key_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    join_job_t *job = arg;
+
+    (void) worker;
+
+    for (size_t i = begin; i < end; i++) {
+        loc_t location = {job->a_lon[i], job->a_lat[i]};
+        xy_t xy;
+
+        if (is_polar(job, location.lat)) {
+            continue;
+        }
+        if (!get_xy_by_location(&location, job->level, &xy)) {
+            __atomic_store_n(&job->failed, true, __ATOMIC_RELAXED);
+            return;
+        }
+        job->keys[i] = idmap_xy_key(xy.x, xy.y);
+    }
+}
+
+static bool build_buckets(join_job_t *job, size_t na) {
+    size_t bucket_count = 0;
+    size_t *bucket_of = malloc((na ? na : 1) * sizeof(size_t));
+
+    if (!bucket_of || !geohex_idmap_init(&job->buckets, na)) {
+        free(bucket_of);
+        return false;
+    }
+
+    for (size_t i = 0; i < na; i++) {
+        bool inserted;
+        size_t *bucket;
+
+        if (is_polar(job, job->a_lat[i])) {
+            bucket_of[i] = SIZE_MAX;
+            continue;
+        }
+        bucket = geohex_idmap_insert(&job->buckets, job->keys[i], &inserted);
+
+        if (!bucket) {
+            free(bucket_of);
+            return false;
+        }
+        if (inserted) {
+            *bucket = bucket_count++;
+        }
+        bucket_of[i] = *bucket;
+    }
+
+    job->offsets = calloc(bucket_count + 1, sizeof(size_t));
+    job->order = malloc((na ? na : 1) * sizeof(size_t));
+    job->ux = malloc((na ? na : 1) * sizeof(double));
+    job->uy = malloc((na ? na : 1) * sizeof(double));
+    job->uz = malloc((na ? na : 1) * sizeof(double));
+    if (!job->offsets || !job->order || !job->ux || !job->uy || !job->uz) {
+        free(bucket_of);
+        return false;
+    }
+
+    for (size_t i = 0; i < na; i++) {
+        if (bucket_of[i] != SIZE_MAX) {
+            job->offsets[bucket_of[i] + 1]++;
+        }
+    }
+    for (size_t i = 0; i < bucket_count; i++) {
+        job->offsets[i + 1] += job->offsets[i];
+    }
+
+    /* bucket-major unit vectors, so a probe streams through contiguous arrays */
+    for (size_t i = 0; i < na; i++) {
+        if (bucket_of[i] == SIZE_MAX) {
+            continue;
+        }
+
+        size_t slot = job->offsets[bucket_of[i]]++;
+
+        job->order[slot] = i;
+        unit_vector(job->a_lon[i], job->a_lat[i], &job->ux[slot], &job->uy[slot], &job->uz[slot]);
+    }
+    for (size_t i = bucket_count; i > 0; i--) {
+        job->offsets[i] = job->offsets[i - 1];
+    }
+    job->offsets[0] = 0;
+
+    free(bucket_of);
+    return true;
+}
+
+static void probe_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    join_job_t *job = arg;
+    size_t disk_size = GEOHEX_DISK_SIZE(job->radius);
+    xy_t *disk = malloc(disk_size * sizeof(xy_t));
+    uint64_t *seen = malloc(disk_size * sizeof(uint64_t));
+    geohex_join_pair_t pairs[JOIN_BLOCK];
+    size_t pending = 0;
+
+    if (!disk || !seen) {
+        __atomic_store_n(&job->failed, true, __ATOMIC_RELAXED);
+        free(seen);
+        free(disk);
+        return;
+    }
+
+    for (size_t b = begin; b < end; b++) {
+        loc_t location = {job->b_lon[b], job->b_lat[b]};
+        double bx, by, bz;
+        size_t zones, unique = 0;
+        xy_t xy;
+
+        if (is_polar(job, location.lat)) {
+            continue;
+        }
+        if (!get_xy_by_location(&location, job->level, &xy)) {
+            __atomic_store_n(&job->failed, true, __ATOMIC_RELAXED);
+            continue;
+        }
+        unit_vector(location.lon, location.lat, &bx, &by, &bz);
+        zones = get_xy_disk(&xy, job->level, job->radius, disk);
+
+        for (size_t z = 0; z < zones; z++) {
+            uint64_t key = idmap_xy_key(disk[z].x, disk[z].y);
+            size_t *bucket;
+            bool duplicate = false;
+
+            /* a disk wider than the globe meets itself */
+            for (size_t k = 0; k < unique && !duplicate; k++) {
+                duplicate = seen[k] == key;
+            }
+            if (duplicate || !(bucket = geohex_idmap_find(&job->buckets, key))) {
+                continue;
+            }
+            seen[unique++] = key;
+
+            for (size_t j = job->offsets[*bucket]; j < job->offsets[*bucket + 1]; j++) {
+                double dx = job->ux[j] - bx, dy = job->uy[j] - by, dz = job->uz[j] - bz;
+                double chord2 = dx * dx + dy * dy + dz * dz;
+
+                if (chord2 <= job->chord2) {
+                    push_pair(job, pairs, &pending, job->order[j], b, chord2, worker);
+                }
+            }
+        }
+    }
+
+    if (pending) {
+        job->fn(job->arg, pairs, pending, worker);
+    }
+
+    free(seen);
+    free(disk);
+}
+
+/*
+ * Pairs with a polar point: a polar b against every a within the band,
+ * and any other b in the band against the polar a only, so no pair the
+ * grid already found is reported twice.
+ */
+static void polar_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    join_job_t *job = arg;
+    geohex_join_pair_t pairs[JOIN_BLOCK];
+    size_t pending = 0;
+
+    for (size_t k = begin; k < end; k++) {
+        size_t b = job->near_b[k];
+        size_t limit = is_polar(job, job->b_lat[b]) ? job->near_a_count : job->near_a_polar;
+        double bx, by, bz;
+
+        unit_vector(job->b_lon[b], job->b_lat[b], &bx, &by, &bz);
+        for (size_t j = 0; j < limit; j++) {
+            double dx = job->near_ux[j] - bx, dy = job->near_uy[j] - by, dz = job->near_uz[j] - bz;
+            double chord2 = dx * dx + dy * dy + dz * dz;
+
+            if (chord2 <= job->chord2) {
+                push_pair(job, pairs, &pending, job->near_a[j], b, chord2, worker);
+            }
+        }
+    }
+
+    if (pending) {
+        job->fn(job->arg, pairs, pending, worker);
+    }
+}
+
+/* Lists the a points of the polar band, polar ones first, and the b points that can pair with them. */
+static bool build_polar(join_job_t *job, size_t na, size_t nb, double band_lat, size_t *nb_near) {
+    size_t count = 0;
+
+    job->near_a = malloc((na ? na : 1) * sizeof(size_t));
+    job->near_ux = malloc((na ? na : 1) * sizeof(double));
+    job->near_uy = malloc((na ? na : 1) * sizeof(double));
+    job->near_uz = malloc((na ? na : 1) * sizeof(double));
+    job->near_b = malloc((nb ? nb : 1) * sizeof(size_t));
+    if (!job->near_a || !job->near_ux || !job->near_uy || !job->near_uz || !job->near_b) {
+        return false;
+    }
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t i = 0; i < na; i++) {
+            double lat = fabs(job->a_lat[i]);
+
+            if (pass == 0 ? lat > job->polar_lat : (lat > band_lat && lat <= job->polar_lat)) {
+                job->near_a[count] = i;
+                unit_vector(job->a_lon[i], job->a_lat[i], &job->near_ux[count], &job->near_uy[count], &job->near_uz[count]);
+                count++;
+            }
+        }
+        if (pass == 0) {
+            job->near_a_polar = count;
+        }
+    }
+    job->near_a_count = count;
+
+    *nb_near = 0;
+    for (size_t i = 0; i < nb; i++) {
+        if (fabs(job->b_lat[i]) > band_lat) {
+            job->near_b[(*nb_near)++] = i;
+        }
+    }
+
+    return true;
+}
+
+static void run(const geohex_executor_t *executor, size_t n, geohex_task_fn task, void *arg) {
+    if (executor) {
+        executor->parallel_for(executor->context, n, task, arg);
+    } else if (n) {
+        task(arg, 0, n, 0);
+    }
+}
+
+bool geohex_join_within(const geohex_executor_t *executor, const double *a_lon, const double *a_lat, size_t na, const double *b_lon, const double *b_lat, size_t nb, double meters, geohex_join_fn fn, void *arg) {
+    if (!fn || !(meters >= 0) || ((!a_lon || !a_lat) && na) || ((!b_lon || !b_lat) && nb)) {
+        return false;
+    }
+
+    /*
+     * The grid only serves points below polar_lat, whose partners stay
+     * under JOIN_MAX_LAT; anything beyond falls back to a full scan of the
+     * band within reach of the polar points.
+     */
+    double reach_lat = meters / JOIN_EARTH_RADIUS * 180.0 / M_PI * (1.0 + 1e-9);
+    double polar_lat = JOIN_MAX_LAT - reach_lat;
+    double max_abs_lat = 0;
+    bool polar = false;
+
+    for (size_t i = 0; i < na; i++) {
+        polar |= fabs(a_lat[i]) > polar_lat;
+        if (fabs(a_lat[i]) <= polar_lat) {
+            max_abs_lat = fmax(max_abs_lat, fabs(a_lat[i]));
+        }
+    }
+    for (size_t i = 0; i < nb; i++) {
+        polar |= fabs(b_lat[i]) > polar_lat;
+        if (fabs(b_lat[i]) <= polar_lat) {
+            max_abs_lat = fmax(max_abs_lat, fabs(b_lat[i]));
+        }
+    }
+
+    /* compare squared chords instead of evaluating haversine per pair */
+    double angle = fmin(meters / JOIN_EARTH_RADIUS, M_PI);
+    double chord = 2.0 * sin(angle / 2.0);
+    join_job_t job = {0};
+    size_t nb_near = 0;
+
+    job.a_lon = a_lon;
+    job.a_lat = a_lat;
+    job.b_lon = b_lon;
+    job.b_lat = b_lat;
+    job.chord2 = chord * chord * (1.0 + 1e-12);
+    job.polar_lat = polar_lat;
+    job.fn = fn;
+    job.arg = arg;
+    choose_level(meters, max_abs_lat, &job.level, &job.radius);
+
+    job.keys = malloc((na ? na : 1) * sizeof(uint64_t));
+    bool ok = job.keys != NULL;
+
+    if (ok) {
+        run(executor, na, key_task, &job);
+        ok = !job.failed && build_buckets(&job, na);
+    }
+    if (ok) {
+        run(executor, nb, probe_task, &job);
+        ok = !job.failed;
+    }
+    if (ok && polar) {
+        ok = build_polar(&job, na, nb, polar_lat - reach_lat, &nb_near);
+        if (ok) {
+            run(executor, nb_near, polar_task, &job);
+        }
+    }
+
+    free(job.near_b);
+    free(job.near_uz);
+    free(job.near_uy);
+    free(job.near_ux);
+    free(job.near_a);
+    free(job.uz);
+    free(job.uy);
+    free(job.ux);
+    free(job.order);
+    free(job.offsets);
+    free(job.keys);
+    geohex_idmap_free(&job.buckets);
+
+    return ok;
+}
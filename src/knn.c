@@ -0,0 +1,228 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/knn.h"
+
+#include "geohex_internal.h"
+#include "idmap.h"
+
+struct _geohex_knn_t {
+    uint32_t level;
+    double h_size;
+    geohex_idmap_t map;
+    geohex_id_t *ids;
+    double *cx;
+    double *cy;
+    size_t count;
+};
+
+geohex_knn_t *geohex_knn_create(uint32_t level, const geohex_id_t *ids, size_t n) {
+    if (level > MAX_LEVEL || (!ids && n)) {
+        return NULL;
+    }
+
+    geohex_knn_t *knn = calloc(1, sizeof(geohex_knn_t));
+    if (!knn) {
+        return NULL;
+    }
+
+    knn->level = level;
+    knn->h_size = calc_hex_size(level);
+    knn->ids = malloc((n ? n : 1) * sizeof(geohex_id_t));
+    knn->cx = malloc((n ? n : 1) * sizeof(double));
+    knn->cy = malloc((n ? n : 1) * sizeof(double));
+
+    if (!knn->ids || !knn->cx || !knn->cy || !geohex_idmap_init(&knn->map, n)) {
+        geohex_knn_destroy(knn);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        xy_t xy;
+        bool inserted;
+        size_t *entry;
+
+        if (get_level_by_id(ids[i]) != level || !get_xy_by_id(ids[i], &xy) ||
+            !(entry = geohex_idmap_insert(&knn->map, idmap_xy_key(xy.x, xy.y), &inserted))) {
+            geohex_knn_destroy(knn);
+            return NULL;
+        }
+        if (!inserted) {
+            continue;
+        }
+
+        *entry = knn->count;
+        knn->ids[knn->count] = ids[i];
+        lattice_center(knn->h_size, xy.x, xy.y, &knn->cx[knn->count], &knn->cy[knn->count]);
+        knn->count++;
+    }
+
+    return knn;
+}
+
+void geohex_knn_destroy(geohex_knn_t *knn) {
+    if (!knn) {
+        return;
+    }
+
+    geohex_idmap_free(&knn->map);
+    free(knn->cy);
+    free(knn->cx);
+    free(knn->ids);
+    free(knn);
+}
+
+size_t geohex_knn_size(const geohex_knn_t *knn) {
+    return knn ? knn->count : 0;
+}
+
+static double entry_distance(const geohex_knn_t *knn, size_t entry, double x, double y) {
+    double dx = knn->cx[entry] - x, dy = knn->cy[entry] - y;
+
+    /* the world is 2 * H_BASE wide */
+    if (dx > H_BASE) {
+        dx -= 2.0 * H_BASE;
+    } else if (dx < -H_BASE) {
+        dx += 2.0 * H_BASE;
+    }
+
+    return sqrt(dx * dx + dy * dy);
+}
+
+static inline bool result_before(const geohex_knn_result_t *a, const geohex_knn_result_t *b) {
+    return a->distance < b->distance || (a->distance == b->distance && a->id < b->id);
+}
+
+/* out[0, n) is a max-heap on (distance, id) holding the best candidates so far */
+static void offer(geohex_knn_result_t *heap, size_t *n, size_t k, geohex_id_t id, double distance, bool check_duplicates) {
+    geohex_knn_result_t candidate = {id, distance};
+    size_t i;
+
+    for (i = 0; check_duplicates && i < *n; i++) {
+        if (heap[i].id == id) {
+            return;
+        }
+    }
+
+    if (*n < k) {
+        i = (*n)++;
+        while (i > 0 && result_before(&heap[(i - 1) / 2], &candidate)) {
+            heap[i] = heap[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap[i] = candidate;
+        return;
+    }
+
+    if (!result_before(&candidate, &heap[0])) {
+        return;
+    }
+
+    i = 0;
+    for (;;) {
+        size_t child = i * 2 + 1;
+
+        if (child >= *n) {
+            break;
+        }
+        if (child + 1 < *n && result_before(&heap[child], &heap[child + 1])) {
+            child++;
+        }
+        if (!result_before(&candidate, &heap[child])) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = candidate;
+}
+
+static int compare_result(const void *a, const void *b) {
+    const geohex_knn_result_t *ra = a, *rb = b;
+
+    return result_before(ra, rb) ? -1 : (result_before(rb, ra) ? 1 : 0);
+}
+
+bool geohex_knn_search(const geohex_knn_t *knn, const loc_t *location, size_t k, geohex_knn_result_t *out, size_t *found) {
+    if (!knn || !location || !found || (k && !out)) {
+        return false;
+    }
+
+    xy_t center, *ring = NULL;
+    double x, y;
+    size_t n = 0, probed = 0, ring_capacity = 0;
+
+    if (!get_xy_by_location(location, knn->level, &center)) {
+        return false;
+    }
+    loc2xy(location->lon, location->lat, &x, &y);
+
+    if (k > knn->count) {
+        k = knn->count;
+    }
+
+    for (uint32_t r = 0; k > 0; r++) {
+        /*
+         * Centres r steps away are at least 3rs from the centre of the query
+         * zone and the query lies within 2s of it, so ring r and beyond
+         * cannot come nearer than (3r - 2)s.
+         */
+        if (n == k && out[0].distance <= (3.0 * r - 2.0) * knn->h_size) {
+            break;
+        }
+
+        size_t ring_size = r == 0 ? 1 : 6 * (size_t) r;
+
+        /* once the rings cost more than the whole index, scan it instead */
+        if (probed + ring_size > knn->count) {
+            n = 0;
+            for (size_t e = 0; e < knn->count; e++) {
+                offer(out, &n, k, knn->ids[e], entry_distance(knn, e, x, y), false);
+            }
+            break;
+        }
+
+        if (ring_size > ring_capacity) {
+            xy_t *grown = realloc(ring, ring_size * 2 * sizeof(xy_t));
+
+            if (!grown) {
+                free(ring);
+                return false;
+            }
+            ring = grown;
+            ring_capacity = ring_size * 2;
+        }
+
+        get_xy_ring(&center, knn->level, r, ring);
+        for (size_t i = 0; i < ring_size; i++) {
+            size_t *entry = geohex_idmap_find(&knn->map, idmap_xy_key(ring[i].x, ring[i].y));
+
+            /* a ring wider than the globe meets zones seen before */
+            if (entry) {
+                offer(out, &n, k, knn->ids[*entry], entry_distance(knn, *entry, x, y), true);
+            }
+        }
+        probed += ring_size;
+    }
+
+    free(ring);
+    qsort(out, n, sizeof(geohex_knn_result_t), compare_result);
+    *found = n;
+
+    return true;
+}
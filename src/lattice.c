@@ -0,0 +1,318 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+
+#include "geohex_internal.h"
+
+const int32_t direction_x[6] = {1, 0, -1, -1, 0, 1};
+const int32_t direction_y[6] = {1, 1, 0, -1, -1, 0};
+
+/* undo the swap adjust_xy() applies to seam zones flagged rev */
+static inline void base_xy(const xy_t *xy, int32_t *x, int32_t *y) {
+    *x = xy->rev ? xy->y : xy->x;
+    *y = xy->rev ? xy->x : xy->y;
+}
+
+bool get_xy_neighbors(const xy_t *xy, uint32_t level, xy_t out[6]) {
+    if (!xy || !out || level > MAX_LEVEL) {
+        return false;
+    }
+
+    int32_t x, y;
+    base_xy(xy, &x, &y);
+
+    for (int i = 0; i < 6; i++) {
+        adjust_xy(x + direction_x[i], y + direction_y[i], level, &out[i]);
+    }
+
+    return true;
+}
+
+size_t get_xy_ring(const xy_t *xy, uint32_t level, uint32_t radius, xy_t *out) {
+    if (!xy || !out || level > MAX_LEVEL) {
+        return 0;
+    }
+
+    int32_t x, y;
+    base_xy(xy, &x, &y);
+
+    if (radius == 0) {
+        adjust_xy(x, y, level, &out[0]);
+        return 1;
+    }
+
+    size_t n = 0;
+
+    x += direction_x[4] * (int32_t) radius;
+    y += direction_y[4] * (int32_t) radius;
+
+    for (int side = 0; side < 6; side++) {
+        for (uint32_t i = 0; i < radius; i++) {
+            adjust_xy(x, y, level, &out[n++]);
+            x += direction_x[side];
+            y += direction_y[side];
+        }
+    }
+
+    return n;
+}
+
+size_t get_xy_disk(const xy_t *xy, uint32_t level, uint32_t radius, xy_t *out) {
+    if (!xy || !out || level > MAX_LEVEL) {
+        return 0;
+    }
+
+    size_t n = 0;
+
+    for (uint32_t r = 0; r <= radius; r++) {
+        n += get_xy_ring(xy, level, r, out + n);
+    }
+
+    return n;
+}
+
+bool get_xy_distance(const xy_t *a, const xy_t *b, uint32_t level, uint32_t *out) {
+    ij_t ij;
+
+    if (!out || !get_local_ij(a, b, level, &ij)) {
+        return false;
+    }
+
+    *out = step_distance(ij.i, ij.j);
+    return true;
+}
+
+bool get_local_ij(const xy_t *anchor, const xy_t *xy, uint32_t level, ij_t *out) {
+    if (!anchor || !xy || !out || level > MAX_LEVEL) {
+        return false;
+    }
+
+    int32_t ax, ay, bx, by;
+    int64_t period = pow3_table[level + 2];
+
+    base_xy(anchor, &ax, &ay);
+    base_xy(xy, &bx, &by);
+
+    int64_t di = (int64_t) bx - ax, dj = (int64_t) by - ay;
+    int64_t best_i = di, best_j = dj;
+    uint32_t best = step_distance(di, dj);
+
+    /* going around the antimeridian moves x - y by a whole period */
+    for (int k = -1; k <= 1; k += 2) {
+        uint32_t d = step_distance(di - k * period, dj + k * period);
+
+        if (d < best) {
+            best = d;
+            best_i = di - k * period;
+            best_j = dj + k * period;
+        }
+    }
+
+    out->i = (int32_t) best_i;
+    out->j = (int32_t) best_j;
+    return true;
+}
+
+bool get_xy_by_local_ij(const xy_t *anchor, const ij_t *ij, uint32_t level, xy_t *out) {
+    if (!anchor || !ij || !out || level > MAX_LEVEL) {
+        return false;
+    }
+
+    int32_t ax, ay;
+    int64_t period = pow3_table[level + 2];
+
+    base_xy(anchor, &ax, &ay);
+
+    int64_t x = (int64_t) ax + ij->i, y = (int64_t) ay + ij->j, d = x - y;
+
+    /* fold whole laps around the globe first; adjust_xy() settles the seam */
+    if (d > period) {
+        int64_t laps = (d - period + 2 * period - 1) / (2 * period);
+
+        x -= laps * period;
+        y += laps * period;
+    } else if (d < -period) {
+        int64_t laps = (-d - period + 2 * period - 1) / (2 * period);
+
+        x += laps * period;
+        y -= laps * period;
+    }
+
+    return adjust_xy((int32_t) x, (int32_t) y, level, out);
+}
+
+/*
+ * Adds step (-1 to 1) to balanced ternary digits, most significant first.
+ * The caller keeps the sum in range, so the carry stops at digit 0.
+ */
+static void carry_digits(uint8_t *code3, uint32_t top, int32_t step) {
+    uint32_t i = top;
+
+    if (step > 0) {
+        while (i > 0 && code3[i] == 2) {
+            code3[i--] = 0;
+        }
+        code3[i]++;
+    } else if (step < 0) {
+        while (i > 0 && code3[i] == 0) {
+            code3[i--] = 2;
+        }
+        code3[i]--;
+    }
+}
+
+/*
+ * Steps the base-9 code digits h[0..level + 2] in place by a carry on the
+ * x and y digits, redoing the prefix rules of get_xy_by_code() and
+ * get_zone_by_xy(). Fails when the step leaves the range the carry can
+ * settle alone: the seam, where adjust_xy() takes over, and digit overflow.
+ */
+static bool step_digits(uint32_t level, uint8_t *h, int32_t dx, int32_t dy) {
+    if (level > MAX_LEVEL) {
+        return false;
+    }
+
+    uint32_t top = level + 2;
+    int64_t period = pow3_table[top], limit = ((int64_t) pow3_table[level + 3] - 1) / 2;
+    int32_t lead[3] = {h[0], h[1], h[2]};
+    uint8_t code3_x[MAX_CODE_LEN + 2], code3_y[MAX_CODE_LEN + 2];
+    int64_t x = 0, y = 0;
+
+    decode_prefix_digits(lead);
+    for (uint32_t i = 0; i <= top; i++) {
+        int32_t digit = i < 3 ? lead[i] : h[i];
+
+        code3_x[i] = (uint8_t) (digit / 3);
+        code3_y[i] = (uint8_t) (digit % 3);
+        x = x * 3 + code3_x[i] - 1;
+        y = y * 3 + code3_y[i] - 1;
+    }
+
+    int64_t nx = x + dx, ny = y + dy;
+    if (llabs(x - y) > period || llabs(nx - ny) >= period || llabs(nx) > limit || llabs(ny) > limit) {
+        return false;
+    }
+
+    carry_digits(code3_x, top, dx);
+    carry_digits(code3_y, top, dy);
+
+    /* the prefix fix-up of get_zone_by_xy(), east of the prime meridian */
+    if (nx >= ny && code3_x[1] == code3_y[1] && code3_x[2] == code3_y[2]) {
+        if (code3_x[0] == 2 && code3_y[0] == 1) {
+            code3_x[0] = 1;
+            code3_y[0] = 2;
+        } else if (code3_x[0] == 1 && code3_y[0] == 0) {
+            code3_x[0] = 0;
+            code3_y[0] = 1;
+        }
+    }
+
+    for (uint32_t i = 0; i <= top; i++) {
+        h[i] = (uint8_t) (code3_x[i] * 3 + code3_y[i]);
+    }
+
+    return true;
+}
+
+static inline bool unit_step(int32_t dx, int32_t dy) {
+    return dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1;
+}
+
+/* The round trip the digit carry stands in for, integers only. */
+static bool step_by_xy(const xy_t *xy, uint32_t level, int32_t dx, int32_t dy, geohex_id_t *out) {
+    ij_t ij = {dx, dy};
+    xy_t next;
+
+    return get_xy_by_local_ij(xy, &ij, level, &next) && get_id_by_xy(&next, level, out);
+}
+
+bool get_code_step(const geohex_code_t code, int32_t dx, int32_t dy, geohex_code_t out) {
+    if (!code || !out || !unit_step(dx, dy)) {
+        return false;
+    }
+
+    size_t code_len = strlen(code);
+    if (code_len < 2 || code_len >= MAX_CODE_LEN) {
+        return false;
+    }
+
+    uint32_t level = (uint32_t) code_len - 2;
+    int32_t c1_idx = char_to_index(code[0]), c2_idx = char_to_index(code[1]);
+    int32_t h_1_int = c1_idx * 30 + c2_idx;
+    uint8_t h[MAX_CODE_LEN + 2];
+
+    if (c1_idx < 0 || c2_idx < 0 || h_1_int > 888 || h_1_int / 10 % 10 == 9 || h_1_int % 10 == 9) {
+        return false;
+    }
+    h[0] = (uint8_t) (h_1_int / 100);
+    h[1] = (uint8_t) (h_1_int / 10 % 10);
+    h[2] = (uint8_t) (h_1_int % 10);
+    for (uint32_t i = 2; i < code_len; i++) {
+        if (code[i] < '0' || code[i] > '8') {
+            return false;
+        }
+        h[i + 1] = (uint8_t) (code[i] - '0');
+    }
+
+    if (!step_digits(level, h, dx, dy)) {
+        geohex_id_t id;
+        xy_t xy;
+
+        return get_xy_by_code(code, &xy) && step_by_xy(&xy, level, dx, dy, &id) && get_code_by_id(id, out);
+    }
+
+    h_1_int = h[0] * 100 + h[1] * 10 + h[2];
+    out[0] = index_to_char(h_1_int / 30);
+    out[1] = index_to_char(h_1_int % 30);
+    for (uint32_t i = 3; i <= level + 2; i++) {
+        out[i - 1] = (char) ('0' + h[i]);
+    }
+    out[level + 2] = '\0';
+
+    return true;
+}
+
+bool get_id_step(geohex_id_t id, int32_t dx, int32_t dy, geohex_id_t *out) {
+    if (!out || !unit_step(dx, dy)) {
+        return false;
+    }
+
+    uint32_t level = get_level_by_id(id);
+    uint64_t value = id >> GEOHEX_ID_LEVEL_BITS;
+    if (level > MAX_LEVEL || value >= pow9_table[MAX_LEVEL + 3] || value % pow9_table[MAX_LEVEL - level] != 0) {
+        return false;
+    }
+
+    uint8_t h[MAX_CODE_LEN + 2];
+    for (uint32_t i = 0; i <= level + 2; i++) {
+        h[i] = (uint8_t) (value / pow9_table[MAX_LEVEL + 2 - i] % 9);
+    }
+
+    if (!step_digits(level, h, dx, dy)) {
+        xy_t xy;
+
+        return get_xy_by_id(id, &xy) && step_by_xy(&xy, level, dx, dy, out);
+    }
+
+    value = 0;
+    for (uint32_t i = 0; i <= level + 2; i++) {
+        value += h[i] * pow9_table[MAX_LEVEL + 2 - i];
+    }
+    *out = (value << GEOHEX_ID_LEVEL_BITS) | level;
+
+    return true;
+}
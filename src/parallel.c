@@ -0,0 +1,291 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "geohex/geohex.h"
+#include "geohex/parallel.h"
+
+#define POOL_MAX_THREADS        256
+#define POOL_CHUNKS_PER_WORKER  16
+#define POOL_CACHE_LINE         64
+
+/*
+ * Every worker owns a contiguous run of chunks and claims them from its own
+ * cursor. Once that run is exhausted it steals the remaining chunks of the
+ * other workers from their cursors, so a slow range never stalls the batch.
+ */
+typedef struct {
+    size_t next;
+    size_t end;
+    char pad[POOL_CACHE_LINE - 2 * sizeof(size_t)];
+} pool_queue_t;
+
+struct _geohex_pool_t {
+    uint32_t threads;
+    pthread_t *handles;
+    pool_queue_t *queues;
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    uint64_t generation;
+    uint32_t active;
+    bool shutdown;
+
+    size_t n;
+    size_t chunk;
+    geohex_task_fn task;
+    void *arg;
+};
+
+typedef struct {
+    geohex_pool_t *pool;
+    uint32_t worker;
+} pool_worker_t;
+
+static void pool_work(geohex_pool_t *pool, uint32_t worker) {
+    for (uint32_t k = 0; k < pool->threads; k++) {
+        pool_queue_t *queue = &pool->queues[(worker + k) % pool->threads];
+
+        for (;;) {
+            size_t index = __atomic_fetch_add(&queue->next, 1, __ATOMIC_RELAXED);
+            if (index >= queue->end) {
+                break;
+            }
+
+            size_t begin = index * pool->chunk;
+            size_t end = begin + pool->chunk < pool->n ? begin + pool->chunk : pool->n;
+            pool->task(pool->arg, begin, end, worker);
+        }
+    }
+}
+
+static void *pool_main(void *data) {
+    pool_worker_t *self = data;
+    geohex_pool_t *pool = self->pool;
+    uint32_t worker = self->worker;
+    uint64_t seen = 0;
+
+    free(self);
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->shutdown && pool->generation == seen) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->shutdown) {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool_work(pool, worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->active == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+geohex_pool_t *geohex_pool_create(uint32_t threads) {
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (uint32_t) online : 1;
+    }
+    if (threads > POOL_MAX_THREADS) {
+        threads = POOL_MAX_THREADS;
+    }
+
+    geohex_pool_t *pool = calloc(1, sizeof(geohex_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->threads = threads;
+    pool->handles = calloc(threads, sizeof(pthread_t));
+    pool->queues = calloc(threads, sizeof(pool_queue_t));
+    if (!pool->handles || !pool->queues) {
+        free(pool->handles);
+        free(pool->queues);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    /* the calling thread acts as worker 0 */
+    for (uint32_t i = 1; i < threads; i++) {
+        pool_worker_t *self = malloc(sizeof(pool_worker_t));
+
+        if (!self) {
+            pool->threads = i;
+            geohex_pool_destroy(pool);
+            return NULL;
+        }
+
+        self->pool = pool;
+        self->worker = i;
+
+        if (pthread_create(&pool->handles[i], NULL, pool_main, self) != 0) {
+            free(self);
+            pool->threads = i;
+            geohex_pool_destroy(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+void geohex_pool_destroy(geohex_pool_t *pool) {
+    if (!pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (uint32_t i = 1; i < pool->threads; i++) {
+        pthread_join(pool->handles[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+
+    free(pool->handles);
+    free(pool->queues);
+    free(pool);
+}
+
+uint32_t geohex_pool_size(const geohex_pool_t *pool) {
+    return pool ? pool->threads : 0;
+}
+
+void geohex_pool_run(geohex_pool_t *pool, size_t n, geohex_task_fn task, void *arg) {
+    if (!pool || !task || n == 0) {
+        return;
+    }
+
+    if (pool->threads == 1) {
+        task(arg, 0, n, 0);
+        return;
+    }
+
+    size_t chunk = n / ((size_t) pool->threads * POOL_CHUNKS_PER_WORKER);
+    if (chunk == 0) {
+        chunk = 1;
+    }
+    size_t chunks = (n + chunk - 1) / chunk;
+
+    for (uint32_t i = 0; i < pool->threads; i++) {
+        pool->queues[i].next = chunks * i / pool->threads;
+        pool->queues[i].end = chunks * (i + 1) / pool->threads;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->n = n;
+    pool->chunk = chunk;
+    pool->task = task;
+    pool->arg = arg;
+    pool->active = pool->threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    pool_work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->active > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static void pool_parallel_for(void *context, size_t n, geohex_task_fn task, void *arg) {
+    geohex_pool_run(context, n, task, arg);
+}
+
+bool geohex_pool_executor(geohex_pool_t *pool, geohex_executor_t *out) {
+    if (!pool || !out) {
+        return false;
+    }
+
+    out->workers = pool->threads;
+    out->parallel_for = pool_parallel_for;
+    out->context = pool;
+    return true;
+}
+
+typedef struct {
+    const loc_t *locations;
+    const geohex_code_t *codes;
+    uint32_t level;
+    zone_t *out;
+    bool failed;
+} batch_job_t;
+
+static void encode_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    batch_job_t *job = arg;
+
+    (void) worker;
+
+    if (!get_zones_by_locations(job->locations + begin, end - begin, job->level, job->out + begin)) {
+        __atomic_store_n(&job->failed, true, __ATOMIC_RELAXED);
+    }
+}
+
+static void decode_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    batch_job_t *job = arg;
+
+    (void) worker;
+
+    if (!get_zones_by_codes(job->codes + begin, end - begin, job->out + begin)) {
+        __atomic_store_n(&job->failed, true, __ATOMIC_RELAXED);
+    }
+}
+
+bool get_zones_by_locations_parallel(const geohex_executor_t *executor, const loc_t *locations, size_t n, uint32_t level, zone_t *out) {
+    if (!executor || ((!locations || !out) && n)) {
+        return false;
+    }
+
+    batch_job_t job = {locations, NULL, level, out, false};
+    executor->parallel_for(executor->context, n, encode_task, &job);
+
+    return !job.failed;
+}
+
+bool get_zones_by_codes_parallel(const geohex_executor_t *executor, const geohex_code_t *codes, size_t n, zone_t *out) {
+    if (!executor || ((!codes || !out) && n)) {
+        return false;
+    }
+
+    batch_job_t job = {NULL, codes, 0, out, false};
+    executor->parallel_for(executor->context, n, decode_task, &job);
+
+    return !job.failed;
+}
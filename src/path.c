@@ -0,0 +1,310 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/path.h"
+
+#include "idmap.h"
+
+#define PATH_NO_PARENT  UINT32_MAX
+
+typedef struct {
+    xy_t xy;
+    double g;
+    uint32_t parent;
+    bool closed;
+} path_node_t;
+
+typedef struct {
+    double f;
+    double g;
+    uint32_t node;
+} path_open_t;
+
+struct _geohex_path_t {
+    uint32_t level;
+    double min_cost;
+    geohex_idmap_t costs;
+    double *cost_values;
+    size_t cost_count;
+    size_t cost_capacity;
+    /* search arena, reused by every call */
+    geohex_idmap_t visited;
+    path_node_t *nodes;
+    size_t node_count;
+    size_t node_capacity;
+    path_open_t *open;
+    size_t open_count;
+    size_t open_capacity;
+};
+
+/* doubles capacity; NULL leaves items untouched */
+static void *grow(void *items, size_t *capacity, size_t size) {
+    size_t next = *capacity ? *capacity * 2 : 256;
+    void *grown = realloc(items, next * size);
+
+    if (grown) {
+        *capacity = next;
+    }
+
+    return grown;
+}
+
+geohex_path_t *geohex_path_create(uint32_t level) {
+    if (level > MAX_LEVEL) {
+        return NULL;
+    }
+
+    geohex_path_t *path = calloc(1, sizeof(geohex_path_t));
+    if (!path) {
+        return NULL;
+    }
+
+    path->level = level;
+    path->min_cost = 1.0;
+    if (!geohex_idmap_init(&path->costs, 0) || !geohex_idmap_init(&path->visited, 0)) {
+        geohex_path_destroy(path);
+        return NULL;
+    }
+
+    return path;
+}
+
+void geohex_path_destroy(geohex_path_t *path) {
+    if (!path) {
+        return;
+    }
+
+    geohex_idmap_free(&path->visited);
+    geohex_idmap_free(&path->costs);
+    free(path->open);
+    free(path->nodes);
+    free(path->cost_values);
+    free(path);
+}
+
+bool geohex_path_set_cost(geohex_path_t *path, geohex_id_t id, double cost) {
+    xy_t xy;
+    bool inserted;
+    size_t *slot;
+
+    if (!path || !(cost > 0) || get_level_by_id(id) != path->level || !get_xy_by_id(id, &xy)) {
+        return false;
+    }
+    if (path->cost_count == path->cost_capacity) {
+        double *grown = grow(path->cost_values, &path->cost_capacity, sizeof(double));
+
+        if (!grown) {
+            return false;
+        }
+        path->cost_values = grown;
+    }
+    if (!(slot = geohex_idmap_insert(&path->costs, idmap_xy_key(xy.x, xy.y), &inserted))) {
+        return false;
+    }
+    if (inserted) {
+        *slot = path->cost_count++;
+    }
+
+    path->cost_values[*slot] = cost;
+    path->min_cost = fmin(path->min_cost, cost);
+
+    return true;
+}
+
+static inline double zone_cost(const geohex_path_t *path, const xy_t *xy) {
+    size_t *slot = geohex_idmap_find(&path->costs, idmap_xy_key(xy->x, xy->y));
+
+    return slot ? path->cost_values[*slot] : 1.0;
+}
+
+/* lower f first, ties to the deeper entry */
+static inline bool open_before(const path_open_t *a, const path_open_t *b) {
+    return a->f < b->f || (a->f == b->f && a->g > b->g);
+}
+
+static bool open_push(geohex_path_t *path, double f, double g, uint32_t node) {
+    if (path->open_count == path->open_capacity) {
+        path_open_t *grown = grow(path->open, &path->open_capacity, sizeof(path_open_t));
+
+        if (!grown) {
+            return false;
+        }
+        path->open = grown;
+    }
+
+    path_open_t entry = {f, g, node};
+    size_t i = path->open_count++;
+
+    while (i > 0 && open_before(&entry, &path->open[(i - 1) / 2])) {
+        path->open[i] = path->open[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    path->open[i] = entry;
+
+    return true;
+}
+
+static path_open_t open_pop(geohex_path_t *path) {
+    path_open_t top = path->open[0], last = path->open[--path->open_count];
+    size_t i = 0;
+
+    for (;;) {
+        size_t child = i * 2 + 1;
+
+        if (child >= path->open_count) {
+            break;
+        }
+        if (child + 1 < path->open_count && open_before(&path->open[child + 1], &path->open[child])) {
+            child++;
+        }
+        if (!open_before(&path->open[child], &last)) {
+            break;
+        }
+        path->open[i] = path->open[child];
+        i = child;
+    }
+    if (path->open_count) {
+        path->open[i] = last;
+    }
+
+    return top;
+}
+
+/* the node of xy, created unvisited on first sight */
+static bool visit(geohex_path_t *path, const xy_t *xy, uint32_t *node) {
+    bool inserted;
+    size_t *slot = geohex_idmap_insert(&path->visited, idmap_xy_key(xy->x, xy->y), &inserted);
+
+    if (!slot) {
+        return false;
+    }
+    if (inserted) {
+        if (path->node_count == path->node_capacity) {
+            path_node_t *grown = grow(path->nodes, &path->node_capacity, sizeof(path_node_t));
+
+            if (!grown) {
+                return false;
+            }
+            path->nodes = grown;
+        }
+        *slot = path->node_count;
+        path->nodes[path->node_count++] = (path_node_t) {*xy, INFINITY, PATH_NO_PARENT, false};
+    }
+    *node = (uint32_t) *slot;
+
+    return true;
+}
+
+static bool write_path(const geohex_path_t *path, uint32_t goal, geohex_id_t *out, size_t capacity, size_t *length) {
+    size_t n = 0;
+
+    for (uint32_t node = goal; node != PATH_NO_PARENT; node = path->nodes[node].parent) {
+        n++;
+    }
+    *length = n;
+    if (n > capacity) {
+        return false;
+    }
+
+    for (uint32_t node = goal; node != PATH_NO_PARENT; node = path->nodes[node].parent) {
+        get_id_by_xy(&path->nodes[node].xy, path->level, &out[--n]);
+    }
+
+    return true;
+}
+
+bool geohex_path_find(geohex_path_t *path, geohex_id_t from, geohex_id_t to, size_t max_expansions, geohex_id_t *out, size_t capacity, size_t *length, double *cost) {
+    xy_t start, goal;
+
+    if (!path || !length || !cost || (!out && capacity) ||
+        get_level_by_id(from) != path->level || get_level_by_id(to) != path->level ||
+        !get_xy_by_id(from, &start) || !get_xy_by_id(to, &goal)) {
+        return false;
+    }
+
+    uint32_t start_node, goal_node, distance;
+    size_t expansions = 0;
+
+    geohex_idmap_clear(&path->visited);
+    path->node_count = 0;
+    path->open_count = 0;
+    *length = 0;
+    *cost = INFINITY;
+
+    if (!visit(path, &start, &start_node) || !visit(path, &goal, &goal_node)) {
+        return false;
+    }
+    if (isinf(zone_cost(path, &start)) || isinf(zone_cost(path, &goal))) {
+        return true;
+    }
+
+    get_xy_distance(&start, &goal, path->level, &distance);
+    path->nodes[start_node].g = 0;
+    if (!open_push(path, distance * path->min_cost, 0, start_node)) {
+        return false;
+    }
+
+    while (path->open_count) {
+        path_open_t entry = open_pop(path);
+        path_node_t *current = &path->nodes[entry.node];
+        xy_t neighbors[6];
+
+        /* stale entries were superseded by a cheaper push */
+        if (current->closed || entry.g > current->g) {
+            continue;
+        }
+        if (entry.node == goal_node) {
+            *cost = current->g;
+            return write_path(path, goal_node, out, capacity, length);
+        }
+        if (max_expansions && expansions++ == max_expansions) {
+            break;
+        }
+        current->closed = true;
+
+        get_xy_neighbors(&current->xy, path->level, neighbors);
+        for (int k = 0; k < 6; k++) {
+            double step = zone_cost(path, &neighbors[k]);
+            uint32_t node;
+
+            if (isinf(step)) {
+                continue;
+            }
+            if (!visit(path, &neighbors[k], &node)) {
+                return false;
+            }
+
+            /* visit() may have moved the arena */
+            path_node_t *next = &path->nodes[node];
+            double g = path->nodes[entry.node].g + step;
+
+            if (next->closed || g >= next->g) {
+                continue;
+            }
+            next->g = g;
+            next->parent = entry.node;
+            get_xy_distance(&neighbors[k], &goal, path->level, &distance);
+            if (!open_push(path, g + distance * path->min_cost, g, node)) {
+                return false;
+            }
+        }
+    }
+
+    *cost = INFINITY;
+    return true;
+}
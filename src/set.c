@@ -0,0 +1,241 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "geohex/geohex.h"
+#include "geohex/set.h"
+#include "geohex/sort.h"
+
+#include "geohex_internal.h"
+
+#define GALLOP_BLOCK    8
+
+/*
+ * Galloping search from `from`: doubles the step until the bound is passed,
+ * bisects down to a small block, and counts that block branch-free so the
+ * compiler can vectorize the tail.
+ */
+static size_t gallop_lower(const geohex_id_t *ids, size_t from, size_t n, geohex_id_t key) {
+    size_t lo = from, hi = from, step = 1;
+
+    while (hi < n && ids[hi] < key) {
+        lo = hi + 1;
+        hi += step;
+        step <<= 1;
+    }
+    if (hi > n) {
+        hi = n;
+    }
+
+    while (hi - lo > GALLOP_BLOCK) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (ids[mid] < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    size_t count = 0;
+    for (size_t i = lo; i < hi; i++) {
+        count += ids[i] < key;
+    }
+
+    return lo + count;
+}
+
+/* First index whose descendant range ends after key; sets are disjoint, so range ends are sorted too. */
+static size_t gallop_past(const geohex_id_t *ids, size_t from, size_t n, geohex_id_t key) {
+    size_t lo = from, hi = from, step = 1;
+
+    while (hi < n && id_range_end(ids[hi]) <= key) {
+        lo = hi + 1;
+        hi += step;
+        step <<= 1;
+    }
+    if (hi > n) {
+        hi = n;
+    }
+
+    while (hi - lo > GALLOP_BLOCK) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (id_range_end(ids[mid]) <= key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    size_t count = 0;
+    for (size_t i = lo; i < hi; i++) {
+        count += id_range_end(ids[i]) <= key;
+    }
+
+    return lo + count;
+}
+
+static inline size_t emit_run(geohex_id_t *out, size_t m, const geohex_id_t *src, size_t len) {
+    if (out && len) {
+        memcpy(out + m, src, len * sizeof(geohex_id_t));
+    }
+
+    return m + len;
+}
+
+bool geohex_set_normalize(geohex_id_t *ids, size_t n, size_t *out_n) {
+    size_t unique_n;
+
+    if (!out_n || !geohex_sort_unique_ids(ids, n, NULL, &unique_n)) {
+        return false;
+    }
+
+    size_t m = 0;
+    for (size_t i = 0; i < unique_n; i++) {
+        if (m == 0 || !id_covers(ids[m - 1], ids[i])) {
+            ids[m++] = ids[i];
+        }
+    }
+
+    *out_n = m;
+    return true;
+}
+
+size_t geohex_set_union(const geohex_id_t *a, size_t na, const geohex_id_t *b, size_t nb, geohex_id_t *out) {
+    size_t i = 0, j = 0, m = 0;
+
+    while (i < na && j < nb) {
+        geohex_id_t x = a[i], y = b[j];
+
+        if (x <= y) {
+            if (y < id_range_end(x)) {
+                j = gallop_lower(b, j + 1, nb, id_range_end(x));
+            } else {
+                size_t k = gallop_past(a, i + 1, na, y);
+                m = emit_run(out, m, a + i, k - i);
+                i = k;
+            }
+        } else {
+            if (x < id_range_end(y)) {
+                i = gallop_lower(a, i + 1, na, id_range_end(y));
+            } else {
+                size_t k = gallop_past(b, j + 1, nb, x);
+                m = emit_run(out, m, b + j, k - j);
+                j = k;
+            }
+        }
+    }
+
+    m = emit_run(out, m, a + i, na - i);
+    m = emit_run(out, m, b + j, nb - j);
+
+    return m;
+}
+
+size_t geohex_set_intersection(const geohex_id_t *a, size_t na, const geohex_id_t *b, size_t nb, geohex_id_t *out) {
+    size_t i = 0, j = 0, m = 0;
+
+    while (i < na && j < nb) {
+        geohex_id_t x = a[i], y = b[j];
+
+        if (x <= y) {
+            if (y < id_range_end(x)) {
+                /* the descendants of x in b, or x itself */
+                size_t k = gallop_lower(b, j + 1, nb, id_range_end(x));
+                m = emit_run(out, m, b + j, k - j);
+                j = k;
+                i++;
+            } else {
+                i = gallop_past(a, i + 1, na, y);
+            }
+        } else {
+            if (x < id_range_end(y)) {
+                size_t k = gallop_lower(a, i + 1, na, id_range_end(y));
+                m = emit_run(out, m, a + i, k - i);
+                i = k;
+                j++;
+            } else {
+                j = gallop_past(b, j + 1, nb, x);
+            }
+        }
+    }
+
+    return m;
+}
+
+/* Emits node minus sub, where every id of sub lies strictly below node. */
+static size_t subtract(geohex_id_t node, const geohex_id_t *sub, size_t n, geohex_id_t *out, size_t m) {
+    size_t j = 0;
+
+    for (uint32_t c = 0; c < 9; c++) {
+        geohex_id_t child = id_child(node, c);
+        size_t k = gallop_lower(sub, j, n, id_range_end(child));
+
+        if (k == j) {
+            if (out) {
+                out[m] = child;
+            }
+            m++;
+        } else if (sub[j] != child) {
+            m = subtract(child, sub + j, k - j, out, m);
+        }
+
+        j = k;
+    }
+
+    return m;
+}
+
+size_t geohex_set_difference(const geohex_id_t *a, size_t na, const geohex_id_t *b, size_t nb, geohex_id_t *out) {
+    size_t j = 0, m = 0;
+
+    for (size_t i = 0; i < na; i++) {
+        geohex_id_t x = a[i];
+
+        j = gallop_past(b, j, nb, x);
+        if (j < nb && b[j] <= x) {
+            /* an ancestor of x, or x itself, is removed */
+            continue;
+        }
+
+        size_t k = gallop_lower(b, j, nb, id_range_end(x));
+        if (k == j) {
+            if (out) {
+                out[m] = x;
+            }
+            m++;
+        } else {
+            m = subtract(x, b + j, k - j, out, m);
+        }
+
+        j = k;
+    }
+
+    return m;
+}
+
+bool geohex_set_contains(const geohex_id_t *set, size_t n, geohex_id_t id) {
+    if (!set || n == 0 || id == GEOHEX_ID_INVALID) {
+        return false;
+    }
+
+    size_t k = gallop_lower(set, 0, n, id + 1);
+
+    return k > 0 && id_covers(set[k - 1], id);
+}
+
+bool geohex_set_is_subset(const geohex_id_t *a, size_t na, const geohex_id_t *b, size_t nb) {
+    return geohex_set_difference(a, na, b, nb, NULL) == 0;
+}
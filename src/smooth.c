@@ -0,0 +1,427 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "geohex/geohex.h"
+#include "geohex/smooth.h"
+
+#include "geohex_internal.h"
+#include "idmap.h"
+
+#define SMOOTH_TILE 128
+/* multiply-adds a dense pass does in the time of one hash probe or one pair test */
+#define SMOOTH_PROBE_COST   32
+#define SMOOTH_PAIR_COST    4
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+    uint64_t key;
+} smooth_cell_t;
+
+typedef struct {
+    int32_t dx;
+    int32_t dy;
+    double weight;
+} smooth_tap_t;
+
+/*
+ * Zones are bucketed into square tiles of xy. Each tile is copied into a
+ * dense array with a margin of 2 * radius, convolved there and read back,
+ * so the kernel runs on contiguous rows instead of hash lookups. Tiles too
+ * sparse to pay for that test their zones against those of the nearby
+ * tiles with the combined 2D kernel. Next to the antimeridian, where tiles
+ * do not line up, sparse zones probe a zone-keyed map of the values, built
+ * only when needed.
+ */
+typedef struct {
+    uint32_t level;
+    uint32_t radius;
+    int32_t period;
+    const double *kernel;
+    const double *values;
+    size_t n;
+    smooth_cell_t *cells;
+    geohex_idmap_t tiles;
+    size_t *offsets;
+    size_t *order;
+    geohex_idmap_t keys;
+    double *sums;
+    double *weights;
+    smooth_tap_t *taps;
+    size_t tap_count;
+    size_t width;
+    double *a;
+    double *b;
+} smooth_job_t;
+
+static inline int32_t tile_of(int32_t v) {
+    return v >= 0 ? v / SMOOTH_TILE : (int32_t) -((-(int64_t) v + SMOOTH_TILE - 1) / SMOOTH_TILE);
+}
+
+/*
+ * One axis of the separable kernel. A step along x, y or x = y is a fixed
+ * offset in the array, so every tap is a plain multiply-add over the whole
+ * array that the compiler vectorizes. Rows bleed into each other at the
+ * edges, which only the outer margin ever sees.
+ */
+static void convolve_axis(const double *restrict in, double *restrict out, size_t size, size_t stride, const double *kernel, uint32_t radius) {
+    for (size_t i = 0; i < size; i++) {
+        out[i] = kernel[0] * in[i];
+    }
+
+    for (uint32_t k = 1; k <= radius; k++) {
+        size_t offset = k * stride;
+        double w = kernel[k];
+
+        if (offset >= size) {
+            break;
+        }
+        for (size_t i = 0; i < size - offset; i++) {
+            out[i] += w * in[i + offset];
+        }
+        for (size_t i = offset; i < size; i++) {
+            out[i] += w * in[i - offset];
+        }
+    }
+}
+
+static bool decode_cells(smooth_job_t *job, const geohex_id_t *ids) {
+    for (size_t i = 0; i < job->n; i++) {
+        xy_t xy;
+
+        if (get_level_by_id(ids[i]) != job->level || !get_xy_by_id(ids[i], &xy)) {
+            return false;
+        }
+        /* seam zones flagged rev are swapped back so the axes stay straight */
+        job->cells[i].x = xy.rev ? xy.y : xy.x;
+        job->cells[i].y = xy.rev ? xy.x : xy.y;
+        job->cells[i].key = idmap_xy_key(xy.x, xy.y);
+    }
+
+    return true;
+}
+
+static bool bucket_tiles(smooth_job_t *job) {
+    size_t tile_count = 0;
+    size_t *tile = malloc(job->n * sizeof(size_t));
+
+    if (!tile || !geohex_idmap_init(&job->tiles, job->n / 64 + 1)) {
+        free(tile);
+        return false;
+    }
+
+    for (size_t i = 0; i < job->n; i++) {
+        bool inserted;
+        size_t *slot = geohex_idmap_insert(&job->tiles, idmap_xy_key(tile_of(job->cells[i].x), tile_of(job->cells[i].y)), &inserted);
+
+        if (!slot) {
+            free(tile);
+            return false;
+        }
+        if (inserted) {
+            *slot = tile_count++;
+        }
+        tile[i] = *slot;
+    }
+
+    job->offsets = calloc(tile_count + 1, sizeof(size_t));
+    job->order = malloc(job->n * sizeof(size_t));
+    if (!job->offsets || !job->order) {
+        free(tile);
+        return false;
+    }
+
+    for (size_t i = 0; i < job->n; i++) {
+        job->offsets[tile[i] + 1]++;
+    }
+    for (size_t t = 0; t < tile_count; t++) {
+        job->offsets[t + 1] += job->offsets[t];
+    }
+    for (size_t i = 0; i < job->n; i++) {
+        job->order[job->offsets[tile[i]]++] = i;
+    }
+    for (size_t t = tile_count; t > 0; t--) {
+        job->offsets[t] = job->offsets[t - 1];
+    }
+    job->offsets[0] = 0;
+
+    free(tile);
+    return true;
+}
+
+/* the three passes folded into one kernel over xy offsets */
+static bool build_taps(smooth_job_t *job) {
+    int32_t r = (int32_t) job->radius, side = 4 * r + 1;
+    double *weights = job->weights = calloc((size_t) side * side, sizeof(double));
+
+    job->taps = malloc((size_t) side * side * sizeof(smooth_tap_t));
+    if (!weights || !job->taps) {
+        return false;
+    }
+
+    for (int32_t a = -r; a <= r; a++) {
+        for (int32_t b = -r; b <= r; b++) {
+            for (int32_t c = -r; c <= r; c++) {
+                weights[(size_t) (b + c + 2 * r) * side + (a + c + 2 * r)] += job->kernel[abs(a)] * job->kernel[abs(b)] * job->kernel[abs(c)];
+            }
+        }
+    }
+
+    for (int32_t dy = -2 * r; dy <= 2 * r; dy++) {
+        for (int32_t dx = -2 * r; dx <= 2 * r; dx++) {
+            double weight = weights[(size_t) (dy + 2 * r) * side + (dx + 2 * r)];
+
+            if (weight != 0) {
+                job->taps[job->tap_count++] = (smooth_tap_t) {dx, dy, weight};
+            }
+        }
+    }
+
+    return true;
+}
+
+/* summed value per distinct zone, for the probes and the antimeridian */
+static bool build_keys(smooth_job_t *job) {
+    size_t count = 0;
+
+    if (job->sums) {
+        return true;
+    }
+    if (!(job->sums = malloc(job->n * sizeof(double))) || !geohex_idmap_init(&job->keys, job->n)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < job->n; i++) {
+        bool inserted;
+        size_t *slot = geohex_idmap_insert(&job->keys, job->cells[i].key, &inserted);
+
+        if (!slot) {
+            return false;
+        }
+        if (inserted) {
+            job->sums[count] = 0;
+            *slot = count++;
+        }
+        job->sums[*slot] += job->values[i];
+    }
+
+    return true;
+}
+
+static inline double value_at(const smooth_job_t *job, int32_t x, int32_t y) {
+    xy_t xy;
+    size_t *slot;
+
+    adjust_xy(x, y, job->level, &xy);
+    slot = geohex_idmap_find(&job->keys, idmap_xy_key(xy.x, xy.y));
+
+    return slot ? job->sums[*slot] : 0;
+}
+
+static double probe_cell(const smooth_job_t *job, const smooth_cell_t *cell) {
+    double sum = 0;
+
+    for (size_t k = 0; k < job->tap_count; k++) {
+        sum += job->taps[k].weight * value_at(job, cell->x + job->taps[k].dx, cell->y + job->taps[k].dy);
+    }
+
+    return sum;
+}
+
+static void pair_tile(const smooth_job_t *job, size_t t, int32_t tx, int32_t ty, int32_t reach, double *out) {
+    int32_t r2 = 2 * (int32_t) job->radius, side = 2 * r2 + 1;
+
+    for (size_t j = job->offsets[t]; j < job->offsets[t + 1]; j++) {
+        out[job->order[j]] = 0;
+    }
+
+    for (int32_t dy = -reach; dy <= reach; dy++) {
+        for (int32_t dx = -reach; dx <= reach; dx++) {
+            size_t *slot = geohex_idmap_find(&job->tiles, idmap_xy_key(tx + dx, ty + dy));
+
+            if (!slot) {
+                continue;
+            }
+            for (size_t c = job->offsets[*slot]; c < job->offsets[*slot + 1]; c++) {
+                const smooth_cell_t *other = &job->cells[job->order[c]];
+                double value = job->values[job->order[c]];
+
+                for (size_t j = job->offsets[t]; j < job->offsets[t + 1]; j++) {
+                    const smooth_cell_t *cell = &job->cells[job->order[j]];
+                    int64_t ox = (int64_t) other->x - cell->x + r2, oy = (int64_t) other->y - cell->y + r2;
+
+                    if (ox >= 0 && ox < side && oy >= 0 && oy < side) {
+                        out[job->order[j]] += job->weights[oy * side + ox] * value;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void fill_tile(smooth_job_t *job, int32_t tx, int32_t ty, int32_t x0, int32_t y0) {
+    int32_t width = (int32_t) job->width;
+
+    memset(job->a, 0, job->width * job->width * sizeof(double));
+
+    /* near the antimeridian neighbours sit a period away: look each cell up */
+    if ((int64_t) x0 + width - 1 - y0 >= job->period || (int64_t) x0 - (y0 + width - 1) <= -job->period) {
+        for (int32_t y = 0; y < width; y++) {
+            for (int32_t x = 0; x < width; x++) {
+                job->a[(size_t) y * job->width + x] = value_at(job, x0 + x, y0 + y);
+            }
+        }
+        return;
+    }
+
+    int32_t reach = (int32_t) ((2 * job->radius + SMOOTH_TILE - 1) / SMOOTH_TILE);
+
+    for (int32_t dy = -reach; dy <= reach; dy++) {
+        for (int32_t dx = -reach; dx <= reach; dx++) {
+            size_t *slot = geohex_idmap_find(&job->tiles, idmap_xy_key(tx + dx, ty + dy));
+
+            if (!slot) {
+                continue;
+            }
+            /* duplicates add up in place */
+            for (size_t j = job->offsets[*slot]; j < job->offsets[*slot + 1]; j++) {
+                const smooth_cell_t *cell = &job->cells[job->order[j]];
+                int64_t x = (int64_t) cell->x - x0, y = (int64_t) cell->y - y0;
+
+                if (x >= 0 && x < width && y >= 0 && y < width) {
+                    job->a[(size_t) y * job->width + (size_t) x] += job->values[job->order[j]];
+                }
+            }
+        }
+    }
+}
+
+static bool smooth_tiles(smooth_job_t *job, double *out) {
+    size_t size = job->width * job->width;
+    int32_t margin = 2 * (int32_t) job->radius;
+    double dense_cost = 3.0 * (2 * job->radius + 1) * (double) size;
+    int32_t reach = (int32_t) ((2 * job->radius + SMOOTH_TILE - 1) / SMOOTH_TILE);
+
+    for (size_t t = 0; job->offsets[t] < job->n; t++) {
+        const smooth_cell_t *first = &job->cells[job->order[job->offsets[t]]];
+        int32_t tx = tile_of(first->x), ty = tile_of(first->y);
+        int32_t x0 = tx * SMOOTH_TILE - margin, y0 = ty * SMOOTH_TILE - margin;
+        size_t zones = job->offsets[t + 1] - job->offsets[t];
+        bool seam = (int64_t) x0 + (int32_t) job->width - 1 - y0 >= job->period ||
+                    (int64_t) x0 - (y0 + (int32_t) job->width - 1) <= -job->period;
+
+        size_t candidates = 0;
+
+        for (int32_t dy = -reach; dy <= reach && !seam; dy++) {
+            for (int32_t dx = -reach; dx <= reach; dx++) {
+                size_t *slot = geohex_idmap_find(&job->tiles, idmap_xy_key(tx + dx, ty + dy));
+
+                candidates += slot ? job->offsets[*slot + 1] - job->offsets[*slot] : 0;
+            }
+        }
+
+        if (!seam && (double) zones * candidates * SMOOTH_PAIR_COST < dense_cost) {
+            pair_tile(job, t, tx, ty, reach, out);
+            continue;
+        }
+        if (seam && (double) zones * job->tap_count * SMOOTH_PROBE_COST < dense_cost) {
+            if (!build_keys(job)) {
+                return false;
+            }
+            for (size_t j = job->offsets[t]; j < job->offsets[t + 1]; j++) {
+                out[job->order[j]] = probe_cell(job, &job->cells[job->order[j]]);
+            }
+            continue;
+        }
+
+        if (seam && !build_keys(job)) {
+            return false;
+        }
+        fill_tile(job, tx, ty, x0, y0);
+        convolve_axis(job->a, job->b, size, 1, job->kernel, job->radius);
+        convolve_axis(job->b, job->a, size, job->width, job->kernel, job->radius);
+        convolve_axis(job->a, job->b, size, job->width + 1, job->kernel, job->radius);
+
+        for (size_t j = job->offsets[t]; j < job->offsets[t + 1]; j++) {
+            const smooth_cell_t *cell = &job->cells[job->order[j]];
+
+            out[job->order[j]] = job->b[(size_t) (cell->y - y0) * job->width + (size_t) (cell->x - x0)];
+        }
+    }
+
+    return true;
+}
+
+bool geohex_smooth(const geohex_id_t *ids, const double *values, size_t n, const double *kernel, uint32_t radius, double *out) {
+    if (((!ids || !values || !out) && n) || !kernel) {
+        return false;
+    }
+    if (n == 0) {
+        return true;
+    }
+
+    smooth_job_t job = {0};
+
+    job.level = get_level_by_id(ids[0]);
+    job.radius = radius;
+    job.kernel = kernel;
+    job.values = values;
+    job.n = n;
+    job.width = SMOOTH_TILE + 4 * (size_t) radius;
+
+    bool ok = job.level <= MAX_LEVEL;
+
+    if (ok) {
+        job.period = (int32_t) pow3_table[job.level + 2];
+        job.cells = malloc(n * sizeof(smooth_cell_t));
+        job.a = malloc(job.width * job.width * sizeof(double));
+        job.b = malloc(job.width * job.width * sizeof(double));
+        ok = job.cells && job.a && job.b && decode_cells(&job, ids) && bucket_tiles(&job) &&
+             build_taps(&job) && smooth_tiles(&job, out);
+    }
+
+    geohex_idmap_free(&job.keys);
+    geohex_idmap_free(&job.tiles);
+    free(job.sums);
+    free(job.taps);
+    free(job.weights);
+    free(job.b);
+    free(job.a);
+    free(job.order);
+    free(job.offsets);
+    free(job.cells);
+
+    return ok;
+}
+
+bool geohex_smooth_gaussian(double sigma, uint32_t radius, double *kernel) {
+    if (!kernel || !(sigma > 0)) {
+        return false;
+    }
+
+    /* three axes 60 degrees apart each add 3/2 of their variance on every direction */
+    double variance = 2.0 * sigma * sigma / 3.0, sum = 0;
+
+    for (uint32_t k = 0; k <= radius; k++) {
+        kernel[k] = exp(-(double) k * k / (2.0 * variance));
+        sum += k ? 2.0 * kernel[k] : kernel[k];
+    }
+    for (uint32_t k = 0; k <= radius; k++) {
+        kernel[k] /= sum;
+    }
+
+    return true;
+}
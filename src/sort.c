@@ -0,0 +1,389 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "geohex/geohex.h"
+#include "geohex/sort.h"
+
+#define RADIX_BITS          8
+#define RADIX_SIZE          (1 << RADIX_BITS)
+#define RADIX_PASSES        (64 / RADIX_BITS)
+#define INSERTION_THRESHOLD 64
+
+static inline uint32_t digit_of(geohex_id_t id, uint32_t pass) {
+    return (uint32_t) (id >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1);
+}
+
+static void insertion_sort(geohex_id_t *ids, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        geohex_id_t key = ids[i];
+        size_t j = i;
+
+        while (j > 0 && ids[j - 1] > key) {
+            ids[j] = ids[j - 1];
+            j--;
+        }
+        ids[j] = key;
+    }
+}
+
+/*
+ * Counts every digit of every pass in one read. A pass whose digit is the
+ * same for all ids is skipped; the ids only use 62 bits, so the top pass
+ * always is.
+ */
+static uint32_t build_histograms(const geohex_id_t *ids, size_t n, size_t hist[RADIX_PASSES][RADIX_SIZE], uint32_t *passes) {
+    uint32_t count = 0;
+
+    memset(hist, 0, sizeof(size_t) * RADIX_PASSES * RADIX_SIZE);
+
+    for (size_t i = 0; i < n; i++) {
+        geohex_id_t id = ids[i];
+
+        for (uint32_t pass = 0; pass < RADIX_PASSES; pass++) {
+            hist[pass][digit_of(id, pass)]++;
+        }
+    }
+
+    for (uint32_t pass = 0; pass < RADIX_PASSES; pass++) {
+        if (hist[pass][digit_of(ids[0], pass)] != n) {
+            passes[count++] = pass;
+        }
+    }
+
+    return count;
+}
+
+static void scatter_pass(const geohex_id_t *src, geohex_id_t *dst, size_t n, uint32_t pass, const size_t *hist) {
+    size_t offsets[RADIX_SIZE];
+    size_t sum = 0;
+
+    for (uint32_t d = 0; d < RADIX_SIZE; d++) {
+        offsets[d] = sum;
+        sum += hist[d];
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        dst[offsets[digit_of(src[i], pass)]++] = src[i];
+    }
+}
+
+static bool lsd_sort(geohex_id_t *ids, size_t n, geohex_id_t *scratch, bool unique, size_t *out_n) {
+    size_t hist[RADIX_PASSES][RADIX_SIZE];
+    uint32_t passes[RADIX_PASSES];
+    bool owned = false;
+
+    if (n < 2) {
+        if (out_n) {
+            *out_n = n;
+        }
+        return true;
+    }
+
+    if (n <= INSERTION_THRESHOLD) {
+        insertion_sort(ids, n);
+        if (unique) {
+            size_t m = 1;
+            for (size_t i = 1; i < n; i++) {
+                if (ids[i] != ids[m - 1]) {
+                    ids[m++] = ids[i];
+                }
+            }
+            *out_n = m;
+        }
+        return true;
+    }
+
+    if (!scratch) {
+        scratch = malloc(n * sizeof(geohex_id_t));
+        if (!scratch) {
+            return false;
+        }
+        owned = true;
+    }
+
+    uint32_t pass_count = build_histograms(ids, n, hist, passes);
+    geohex_id_t *src = ids, *dst = scratch;
+
+    if (pass_count == 0) {
+        /* all ids are equal */
+        if (unique) {
+            *out_n = 1;
+        }
+        if (owned) {
+            free(scratch);
+        }
+        return true;
+    }
+
+    for (uint32_t p = 0; p + 1 < pass_count; p++) {
+        geohex_id_t *tmp;
+
+        scatter_pass(src, dst, n, passes[p], hist[passes[p]]);
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    uint32_t last = passes[pass_count - 1];
+
+    if (!unique) {
+        scatter_pass(src, dst, n, last, hist[last]);
+        if (dst != ids) {
+            memcpy(ids, dst, n * sizeof(geohex_id_t));
+        }
+    } else {
+        /*
+         * Within a bucket of the last pass ids arrive in sorted order, so a
+         * duplicate always equals the id written just before it into the same
+         * bucket. Buckets are compacted afterwards.
+         */
+        size_t begin[RADIX_SIZE], cursor[RADIX_SIZE];
+        size_t sum = 0;
+
+        for (uint32_t d = 0; d < RADIX_SIZE; d++) {
+            begin[d] = cursor[d] = sum;
+            sum += hist[last][d];
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            uint32_t d = digit_of(src[i], last);
+
+            if (cursor[d] == begin[d] || dst[cursor[d] - 1] != src[i]) {
+                dst[cursor[d]++] = src[i];
+            }
+        }
+
+        size_t m = 0;
+        for (uint32_t d = 0; d < RADIX_SIZE; d++) {
+            size_t len = cursor[d] - begin[d];
+
+            memmove(ids + m, dst + begin[d], len * sizeof(geohex_id_t));
+            m += len;
+        }
+
+        *out_n = m;
+    }
+
+    if (owned) {
+        free(scratch);
+    }
+
+    return true;
+}
+
+bool geohex_sort_ids(geohex_id_t *ids, size_t n, geohex_id_t *scratch) {
+    if (!ids && n) {
+        return false;
+    }
+
+    return lsd_sort(ids, n, scratch, false, NULL);
+}
+
+bool geohex_sort_unique_ids(geohex_id_t *ids, size_t n, geohex_id_t *scratch, size_t *out_n) {
+    if ((!ids && n) || !out_n) {
+        return false;
+    }
+
+    return lsd_sort(ids, n, scratch, true, out_n);
+}
+
+static void msd_sort(geohex_id_t *ids, size_t n, int32_t pass) {
+    while (pass >= 0 && n > INSERTION_THRESHOLD) {
+        size_t count[RADIX_SIZE] = {0};
+
+        for (size_t i = 0; i < n; i++) {
+            count[digit_of(ids[i], pass)]++;
+        }
+
+        if (count[digit_of(ids[0], pass)] == n) {
+            pass--;
+            continue;
+        }
+
+        /* American flag sort: cycle every id into its bucket in place */
+        size_t head[RADIX_SIZE], tail[RADIX_SIZE];
+        size_t sum = 0;
+
+        for (uint32_t d = 0; d < RADIX_SIZE; d++) {
+            head[d] = sum;
+            sum += count[d];
+            tail[d] = sum;
+        }
+
+        for (uint32_t d = 0; d < RADIX_SIZE; d++) {
+            while (head[d] < tail[d]) {
+                geohex_id_t id = ids[head[d]];
+                uint32_t target = digit_of(id, pass);
+
+                while (target != d) {
+                    geohex_id_t swap = ids[head[target]];
+
+                    ids[head[target]++] = id;
+                    id = swap;
+                    target = digit_of(id, pass);
+                }
+
+                ids[head[d]++] = id;
+            }
+        }
+
+        size_t begin = 0;
+        for (uint32_t d = 0; d < RADIX_SIZE; d++) {
+            if (count[d] > 1) {
+                msd_sort(ids + begin, count[d], pass - 1);
+            }
+            begin += count[d];
+        }
+
+        return;
+    }
+
+    if (pass >= 0) {
+        insertion_sort(ids, n);
+    }
+}
+
+void geohex_sort_ids_inplace(geohex_id_t *ids, size_t n) {
+    if (!ids || n < 2) {
+        return;
+    }
+
+    msd_sort(ids, n, RADIX_PASSES - 1);
+}
+
+typedef struct {
+    geohex_id_t *ids;
+    geohex_id_t *scratch;
+    size_t n;
+    size_t blocks;
+    uint32_t shift;
+    size_t (*counts)[RADIX_SIZE];
+    size_t bucket_begin[RADIX_SIZE + 1];
+    bool failed;
+} parallel_sort_job_t;
+
+static inline size_t block_begin(const parallel_sort_job_t *job, size_t block) {
+    return job->n * block / job->blocks;
+}
+
+static inline uint32_t top_digit(const parallel_sort_job_t *job, geohex_id_t id) {
+    return (uint32_t) (id >> job->shift) & (RADIX_SIZE - 1);
+}
+
+static void count_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    parallel_sort_job_t *job = arg;
+
+    (void) worker;
+
+    for (size_t b = begin; b < end; b++) {
+        size_t *count = job->counts[b];
+
+        for (size_t i = block_begin(job, b); i < block_begin(job, b + 1); i++) {
+            count[top_digit(job, job->ids[i])]++;
+        }
+    }
+}
+
+static void scatter_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    parallel_sort_job_t *job = arg;
+
+    (void) worker;
+
+    for (size_t b = begin; b < end; b++) {
+        size_t *offset = job->counts[b];
+
+        for (size_t i = block_begin(job, b); i < block_begin(job, b + 1); i++) {
+            geohex_id_t id = job->ids[i];
+
+            job->scratch[offset[top_digit(job, id)]++] = id;
+        }
+    }
+}
+
+static void bucket_task(void *arg, size_t begin, size_t end, uint32_t worker) {
+    parallel_sort_job_t *job = arg;
+
+    (void) worker;
+
+    for (size_t d = begin; d < end; d++) {
+        size_t first = job->bucket_begin[d];
+        size_t len = job->bucket_begin[d + 1] - first;
+
+        if (!lsd_sort(job->scratch + first, len, job->ids + first, false, NULL)) {
+            __atomic_store_n(&job->failed, true, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+bool geohex_sort_ids_parallel(const geohex_executor_t *executor, geohex_id_t *ids, size_t n) {
+    if (!executor || (!ids && n)) {
+        return false;
+    }
+
+    if (executor->workers < 2 || n < RADIX_SIZE * INSERTION_THRESHOLD) {
+        return geohex_sort_ids(ids, n, NULL);
+    }
+
+    /* partition on the most significant byte that is in use */
+    geohex_id_t max_id = 0;
+    for (size_t i = 0; i < n; i++) {
+        max_id |= ids[i];
+    }
+
+    uint32_t shift = 0;
+    while (shift + RADIX_BITS < 64 && (max_id >> (shift + RADIX_BITS)) != 0) {
+        shift++;
+    }
+
+    parallel_sort_job_t job;
+    job.ids = ids;
+    job.n = n;
+    job.blocks = (size_t) executor->workers * 4;
+    job.shift = shift;
+    job.failed = false;
+    job.scratch = malloc(n * sizeof(geohex_id_t));
+    job.counts = calloc(job.blocks, sizeof(*job.counts));
+
+    if (!job.scratch || !job.counts) {
+        free(job.scratch);
+        free(job.counts);
+        return false;
+    }
+
+    executor->parallel_for(executor->context, job.blocks, count_task, &job);
+
+    /* turn per-block counts into scatter offsets, bucket major */
+    size_t sum = 0;
+    for (uint32_t d = 0; d < RADIX_SIZE; d++) {
+        job.bucket_begin[d] = sum;
+        for (size_t b = 0; b < job.blocks; b++) {
+            size_t count = job.counts[b][d];
+
+            job.counts[b][d] = sum;
+            sum += count;
+        }
+    }
+    job.bucket_begin[RADIX_SIZE] = sum;
+
+    executor->parallel_for(executor->context, job.blocks, scatter_task, &job);
+    executor->parallel_for(executor->context, RADIX_SIZE, bucket_task, &job);
+
+    memcpy(ids, job.scratch, n * sizeof(geohex_id_t));
+
+    free(job.scratch);
+    free(job.counts);
+
+    return !job.failed;
+}
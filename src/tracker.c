@@ -0,0 +1,230 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "geohex/geohex.h"
+#include "geohex/tracker.h"
+
+#include "geohex_internal.h"
+#include "idmap.h"
+
+#define TRACKER_EVENT_BLOCK 1024
+
+typedef struct {
+    geohex_id_t zone;
+    loc_t min;
+    loc_t max;
+    size_t next_free;
+} tracker_object_t;
+
+struct _geohex_tracker_t {
+    uint32_t level;
+    geohex_idmap_t map;
+    tracker_object_t *objects;
+    size_t count;
+    size_t capacity;
+    size_t active;
+    size_t free_head;
+    geohex_tracker_event_t events[TRACKER_EVENT_BLOCK];
+    size_t pending;
+};
+
+static void flush(geohex_tracker_t *tracker, geohex_tracker_fn fn, void *arg) {
+    if (tracker->pending) {
+        fn(arg, tracker->events, tracker->pending);
+        tracker->pending = 0;
+    }
+}
+
+static void emit(geohex_tracker_t *tracker, uint64_t object, geohex_id_t from, geohex_id_t to, geohex_tracker_fn fn, void *arg) {
+    if (!fn) {
+        return;
+    }
+
+    if (tracker->pending == TRACKER_EVENT_BLOCK) {
+        flush(tracker, fn, arg);
+    }
+
+    geohex_tracker_event_t *event = &tracker->events[tracker->pending++];
+    event->object = object;
+    event->from = from;
+    event->to = to;
+}
+
+geohex_tracker_t *geohex_tracker_create(uint32_t level, size_t capacity_hint) {
+    if (level > MAX_LEVEL) {
+        return NULL;
+    }
+
+    geohex_tracker_t *tracker = calloc(1, sizeof(geohex_tracker_t));
+    if (!tracker) {
+        return NULL;
+    }
+
+    tracker->level = level;
+    tracker->free_head = SIZE_MAX;
+    tracker->capacity = capacity_hint ? capacity_hint : 64;
+    tracker->objects = malloc(tracker->capacity * sizeof(tracker_object_t));
+
+    if (!tracker->objects || !geohex_idmap_init(&tracker->map, tracker->capacity)) {
+        free(tracker->objects);
+        free(tracker);
+        return NULL;
+    }
+
+    return tracker;
+}
+
+void geohex_tracker_destroy(geohex_tracker_t *tracker) {
+    if (!tracker) {
+        return;
+    }
+
+    geohex_idmap_free(&tracker->map);
+    free(tracker->objects);
+    free(tracker);
+}
+
+size_t geohex_tracker_size(const geohex_tracker_t *tracker) {
+    return tracker ? tracker->active : 0;
+}
+
+static tracker_object_t *lookup_or_add(geohex_tracker_t *tracker, uint64_t object) {
+    bool inserted;
+    size_t *slot = geohex_idmap_insert(&tracker->map, object, &inserted);
+
+    if (!slot) {
+        return NULL;
+    }
+
+    if (inserted) {
+        /* reuse the slot of a removed object before growing */
+        if (tracker->free_head != SIZE_MAX) {
+            *slot = tracker->free_head;
+            tracker->free_head = tracker->objects[*slot].next_free;
+        } else {
+            if (tracker->count == tracker->capacity) {
+                tracker_object_t *objects = realloc(tracker->objects, tracker->capacity * 2 * sizeof(tracker_object_t));
+
+                if (!objects) {
+                    geohex_idmap_remove(&tracker->map, object);
+                    return NULL;
+                }
+                tracker->objects = objects;
+                tracker->capacity *= 2;
+            }
+
+            *slot = tracker->count++;
+        }
+        tracker->objects[*slot].zone = GEOHEX_ID_INVALID;
+    }
+
+    return &tracker->objects[*slot];
+}
+
+bool geohex_tracker_update(geohex_tracker_t *tracker, const uint64_t *objects, const double *lon, const double *lat, size_t n, geohex_tracker_fn fn, void *arg) {
+    if (!tracker || ((!objects || !lon || !lat) && n)) {
+        return false;
+    }
+
+    bool ok = true;
+
+    for (size_t i = 0; i < n; i++) {
+        tracker_object_t *o = lookup_or_add(tracker, objects[i]);
+
+        if (!o) {
+            ok = false;
+            continue;
+        }
+
+        /* still inside the box inscribed in its zone */
+        if (o->zone != GEOHEX_ID_INVALID && lon[i] > o->min.lon && lon[i] < o->max.lon &&
+            lat[i] > o->min.lat && lat[i] < o->max.lat) {
+            continue;
+        }
+
+        loc_t location = {lon[i], lat[i]};
+        xy_t xy;
+        geohex_id_t zone;
+
+        if (!get_xy_by_location(&location, tracker->level, &xy) || !get_id_by_xy(&xy, tracker->level, &zone)) {
+            ok = false;
+            continue;
+        }
+
+        /* outside the box but still in a corner of the same zone */
+        if (zone == o->zone) {
+            continue;
+        }
+
+        emit(tracker, objects[i], o->zone, zone, fn, arg);
+        if (o->zone == GEOHEX_ID_INVALID) {
+            tracker->active++;
+        }
+        o->zone = zone;
+        zone_inner_box(&xy, tracker->level, &o->min, &o->max);
+    }
+
+    if (fn) {
+        flush(tracker, fn, arg);
+    }
+
+    return ok;
+}
+
+bool geohex_tracker_remove(geohex_tracker_t *tracker, const uint64_t *objects, size_t n, geohex_tracker_fn fn, void *arg) {
+    if (!tracker || (!objects && n)) {
+        return false;
+    }
+
+    bool ok = true;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t *slot = geohex_idmap_find(&tracker->map, objects[i]);
+
+        if (!slot || tracker->objects[*slot].zone == GEOHEX_ID_INVALID) {
+            ok = false;
+            continue;
+        }
+
+        size_t index = *slot;
+
+        emit(tracker, objects[i], tracker->objects[index].zone, GEOHEX_ID_INVALID, fn, arg);
+        tracker->objects[index].zone = GEOHEX_ID_INVALID;
+        tracker->objects[index].next_free = tracker->free_head;
+        tracker->free_head = index;
+        tracker->active--;
+        geohex_idmap_remove(&tracker->map, objects[i]);
+    }
+
+    if (fn) {
+        flush(tracker, fn, arg);
+    }
+
+    return ok;
+}
+
+bool geohex_tracker_get(const geohex_tracker_t *tracker, uint64_t object, geohex_id_t *zone) {
+    if (!tracker || !zone) {
+        return false;
+    }
+
+    size_t *slot = geohex_idmap_find(&tracker->map, object);
+    if (!slot || tracker->objects[*slot].zone == GEOHEX_ID_INVALID) {
+        return false;
+    }
+
+    *zone = tracker->objects[*slot].zone;
+    return true;
+}
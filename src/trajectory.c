@@ -0,0 +1,149 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "geohex/geohex.h"
+#include "geohex/trajectory.h"
+
+#include "geohex_internal.h"
+
+static const int32_t step_x[7] = {0, 1, 0, -1, -1, 0, 1};
+static const int32_t step_y[7] = {0, 1, 1, 0, -1, -1, 0};
+
+/* a seam zone flagged rev was rounded on the +180 side with x and y swapped */
+static inline void zone_base(const geohex_trajectory_t *t, int32_t *x, int32_t *y) {
+    *x = t->zone.xy.rev ? t->zone.xy.y : t->zone.xy.x;
+    *y = t->zone.xy.rev ? t->zone.xy.x : t->zone.xy.y;
+}
+
+static inline bool in_zone(const geohex_trajectory_t *t, double dx, double dy) {
+    double inradius = ZONE_INNER_MARGIN * SQRT3 * t->h_size;
+
+    dy = fabs(dy);
+    return dy < inradius && SQRT3 * fabs(dx) + dy < 2.0 * inradius;
+}
+
+static void update_box(geohex_trajectory_t *t) {
+    loc_t min, max;
+
+    zone_inner_box(&t->zone.xy, t->level, &min, &max);
+    t->lon_min = min.lon;
+    t->lat_min = min.lat;
+    t->lon_max = max.lon;
+    t->lat_max = max.lat;
+    t->valid = true;
+}
+
+bool geohex_trajectory_init(geohex_trajectory_t *trajectory, uint32_t level) {
+    if (!trajectory || level > MAX_LEVEL) {
+        return false;
+    }
+
+    memset(trajectory, 0, sizeof(geohex_trajectory_t));
+    trajectory->level = level;
+    trajectory->h_size = calc_hex_size(level);
+
+    return true;
+}
+
+void geohex_trajectory_reset(geohex_trajectory_t *trajectory) {
+    if (trajectory) {
+        trajectory->valid = false;
+    }
+}
+
+static bool step(geohex_trajectory_t *t, const loc_t *location) {
+    double x, y;
+    int32_t base_x, base_y;
+
+    loc2xy(location->lon, location->lat, &x, &y);
+    zone_base(t, &base_x, &base_y);
+
+    for (int i = 0; i < 7; i++) {
+        int32_t nx = base_x + step_x[i], ny = base_y + step_y[i];
+        double cx, cy;
+        xy_t xy;
+
+        lattice_center(t->h_size, nx, ny, &cx, &cy);
+        if (!in_zone(t, x - cx, y - cy)) {
+            continue;
+        }
+
+        /* the corners of the current zone fall outside its box */
+        if (i == 0) {
+            t->hits++;
+            return true;
+        }
+
+        adjust_xy(nx, ny, t->level, &xy);
+        if (!get_zone_by_xy(&xy, t->level, &t->zone)) {
+            t->valid = false;
+            return false;
+        }
+
+        update_box(t);
+        t->steps++;
+        return true;
+    }
+
+    return false;
+}
+
+bool geohex_trajectory_encode(geohex_trajectory_t *trajectory, const loc_t *location, zone_t *out) {
+    if (!trajectory || !location || !out) {
+        return false;
+    }
+
+    if (trajectory->valid) {
+        if (location->lon > trajectory->lon_min && location->lon < trajectory->lon_max &&
+            location->lat > trajectory->lat_min && location->lat < trajectory->lat_max) {
+            trajectory->hits++;
+            *out = trajectory->zone;
+            return true;
+        }
+
+        if (step(trajectory, location)) {
+            *out = trajectory->zone;
+            return true;
+        }
+    }
+
+    if (!get_zone_by_location(location, trajectory->level, &trajectory->zone)) {
+        trajectory->valid = false;
+        return false;
+    }
+
+    update_box(trajectory);
+    trajectory->misses++;
+    *out = trajectory->zone;
+
+    return true;
+}
+
+bool geohex_trajectory_encode_batch(geohex_trajectory_t *trajectory, const double *lon, const double *lat, size_t n, zone_t *out) {
+    if (!trajectory || ((!lon || !lat || !out) && n)) {
+        return false;
+    }
+
+    bool ok = true;
+
+    for (size_t i = 0; i < n; i++) {
+        loc_t location = {lon[i], lat[i]};
+
+        ok &= geohex_trajectory_encode(trajectory, &location, &out[i]);
+    }
+
+    return ok;
+}
@@ -0,0 +1,814 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "geohex/geohex.h"
+#include "geohex/zoneset.h"
+
+#include "geohex_internal.h"
+
+#define ZS_LOW_DIGITS       5
+#define ZS_LOW_RANGE        59049 /* pow(9, ZS_LOW_DIGITS) */
+#define ZS_BITMAP_WORDS     ((ZS_LOW_RANGE + 63) / 64)
+#define ZS_ARRAY_MAX        4096
+#define ZS_LEVEL_SHIFT      56
+
+#define ZS_MAGIC            "GHZS"
+#define ZS_VERSION          1
+#define ZS_HEADER_SIZE      12
+#define ZS_CONTAINER_SIZE   20
+
+enum {
+    ZS_ARRAY = 0,
+    ZS_BITMAP = 1,
+    ZS_RUN = 2
+};
+
+typedef struct {
+    uint64_t key;
+    uint32_t type;
+    uint32_t cardinality;
+    uint32_t length;    /* array: values, run: runs, bitmap: words */
+    uint32_t capacity;  /* allocated uint16_t slots of values */
+    uint16_t *values;   /* array values, or (start, length - 1) pairs of runs */
+    uint64_t *bits;
+} zs_container_t;
+
+struct _geohex_zoneset_t {
+    zs_container_t *containers;
+    size_t count;
+    size_t capacity;
+};
+
+static bool split_id(geohex_id_t id, uint64_t *key, uint16_t *low) {
+    uint32_t level = get_level_by_id(id);
+    uint64_t value = id >> GEOHEX_ID_LEVEL_BITS;
+
+    if (level > MAX_LEVEL || value >= pow9_table[MAX_LEVEL + 3] || value % pow9_table[MAX_LEVEL - level] != 0) {
+        return false;
+    }
+
+    uint64_t digits = value / pow9_table[MAX_LEVEL - level];
+
+    *key = ((uint64_t) level << ZS_LEVEL_SHIFT) | (digits / ZS_LOW_RANGE);
+    *low = (uint16_t) (digits % ZS_LOW_RANGE);
+    return true;
+}
+
+static geohex_id_t join_id(uint64_t key, uint32_t low) {
+    uint32_t level = (uint32_t) (key >> ZS_LEVEL_SHIFT);
+    uint64_t digits = (key & ((1ULL << ZS_LEVEL_SHIFT) - 1)) * ZS_LOW_RANGE + low;
+
+    return ((digits * pow9_table[MAX_LEVEL - level]) << GEOHEX_ID_LEVEL_BITS) | level;
+}
+
+static void container_free(zs_container_t *c) {
+    free(c->values);
+    free(c->bits);
+    c->values = NULL;
+    c->bits = NULL;
+}
+
+static bool reserve_values(zs_container_t *c, uint32_t slots) {
+    if (slots <= c->capacity) {
+        return true;
+    }
+
+    uint32_t capacity = c->capacity ? c->capacity : 8;
+    while (capacity < slots) {
+        capacity *= 2;
+    }
+
+    uint16_t *values = realloc(c->values, capacity * sizeof(uint16_t));
+    if (!values) {
+        return false;
+    }
+
+    c->values = values;
+    c->capacity = capacity;
+    return true;
+}
+
+static inline bool bit_test(const uint64_t *bits, uint32_t low) {
+    return (bits[low >> 6] >> (low & 63)) & 1;
+}
+
+static void fill_bitmap(const zs_container_t *c, uint64_t *bits) {
+    if (c->type == ZS_BITMAP) {
+        memcpy(bits, c->bits, ZS_BITMAP_WORDS * sizeof(uint64_t));
+        return;
+    }
+
+    memset(bits, 0, ZS_BITMAP_WORDS * sizeof(uint64_t));
+
+    if (c->type == ZS_ARRAY) {
+        for (uint32_t i = 0; i < c->length; i++) {
+            bits[c->values[i] >> 6] |= 1ULL << (c->values[i] & 63);
+        }
+    } else {
+        for (uint32_t r = 0; r < c->length; r++) {
+            uint32_t start = c->values[2 * r];
+            uint32_t end = start + c->values[2 * r + 1];
+
+            for (uint32_t low = start; low <= end; low++) {
+                bits[low >> 6] |= 1ULL << (low & 63);
+            }
+        }
+    }
+}
+
+/* Replaces the contents of c with bits, as an array or a bitmap. */
+static bool load_bitmap(zs_container_t *c, const uint64_t *bits) {
+    uint32_t cardinality = 0;
+
+    for (uint32_t w = 0; w < ZS_BITMAP_WORDS; w++) {
+        cardinality += (uint32_t) __builtin_popcountll(bits[w]);
+    }
+
+    if (cardinality > ZS_ARRAY_MAX) {
+        uint64_t *copy = c->bits;
+
+        if (!copy) {
+            copy = malloc(ZS_BITMAP_WORDS * sizeof(uint64_t));
+            if (!copy) {
+                return false;
+            }
+        }
+        if (copy != bits) {
+            memcpy(copy, bits, ZS_BITMAP_WORDS * sizeof(uint64_t));
+        }
+
+        free(c->values);
+        c->values = NULL;
+        c->capacity = 0;
+        c->bits = copy;
+        c->type = ZS_BITMAP;
+        c->length = ZS_BITMAP_WORDS;
+    } else {
+        /* leave c untouched if the array cannot be allocated */
+        if (!reserve_values(c, cardinality)) {
+            return false;
+        }
+        c->length = 0;
+
+        for (uint32_t w = 0; w < ZS_BITMAP_WORDS; w++) {
+            uint64_t word = bits[w];
+
+            while (word) {
+                c->values[c->length++] = (uint16_t) (w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+
+        free(c->bits);
+        c->bits = NULL;
+        c->type = ZS_ARRAY;
+    }
+
+    c->cardinality = cardinality;
+    return true;
+}
+
+static bool container_to_bitmap(zs_container_t *c) {
+    uint64_t *bits = malloc(ZS_BITMAP_WORDS * sizeof(uint64_t));
+
+    if (!bits) {
+        return false;
+    }
+
+    fill_bitmap(c, bits);
+    free(c->values);
+    c->values = NULL;
+    c->capacity = 0;
+    c->bits = bits;
+    c->type = ZS_BITMAP;
+    c->length = ZS_BITMAP_WORDS;
+    return true;
+}
+
+static uint32_t array_lower_bound(const uint16_t *values, uint32_t n, uint32_t low) {
+    uint32_t lo = 0, hi = n;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+
+        if (values[mid] < low) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static bool container_contains(const zs_container_t *c, uint32_t low) {
+    if (c->type == ZS_BITMAP) {
+        return bit_test(c->bits, low);
+    }
+
+    if (c->type == ZS_ARRAY) {
+        uint32_t i = array_lower_bound(c->values, c->length, low);
+        return i < c->length && c->values[i] == low;
+    }
+
+    /* last run starting at or before low */
+    uint32_t lo = 0, hi = c->length;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+
+        if (c->values[2 * mid] <= low) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo > 0 && low <= (uint32_t) c->values[2 * (lo - 1)] + c->values[2 * (lo - 1) + 1];
+}
+
+static bool container_add(zs_container_t *c, uint16_t low) {
+    if (c->type == ZS_RUN) {
+        if (container_contains(c, low)) {
+            return true;
+        }
+        if (!container_to_bitmap(c)) {
+            return false;
+        }
+    }
+
+    if (c->type == ZS_BITMAP) {
+        if (!bit_test(c->bits, low)) {
+            c->bits[low >> 6] |= 1ULL << (low & 63);
+            c->cardinality++;
+        }
+        return true;
+    }
+
+    uint32_t i = array_lower_bound(c->values, c->length, low);
+    if (i < c->length && c->values[i] == low) {
+        return true;
+    }
+
+    if (c->length == ZS_ARRAY_MAX) {
+        if (!container_to_bitmap(c)) {
+            return false;
+        }
+        c->bits[low >> 6] |= 1ULL << (low & 63);
+        c->cardinality++;
+        return true;
+    }
+
+    if (!reserve_values(c, c->length + 1)) {
+        return false;
+    }
+
+    memmove(c->values + i + 1, c->values + i, (c->length - i) * sizeof(uint16_t));
+    c->values[i] = low;
+    c->length++;
+    c->cardinality++;
+    return true;
+}
+
+static bool container_optimize(zs_container_t *c) {
+    uint64_t bits[ZS_BITMAP_WORDS];
+    uint32_t runs = 0;
+
+    fill_bitmap(c, bits);
+
+    for (uint32_t w = 0; w < ZS_BITMAP_WORDS; w++) {
+        /* a run starts at every set bit whose predecessor is clear */
+        uint64_t prev = (bits[w] << 1) | (w > 0 ? bits[w - 1] >> 63 : 0);
+        runs += (uint32_t) __builtin_popcountll(bits[w] & ~prev);
+    }
+
+    size_t run_bytes = (size_t) runs * 4;
+    size_t array_bytes = c->cardinality <= ZS_ARRAY_MAX ? (size_t) c->cardinality * 2 : SIZE_MAX;
+    size_t bitmap_bytes = ZS_BITMAP_WORDS * sizeof(uint64_t);
+
+    if (run_bytes >= array_bytes || run_bytes >= bitmap_bytes) {
+        return load_bitmap(c, bits);
+    }
+
+    if (!reserve_values(c, runs * 2)) {
+        return false;
+    }
+
+    uint32_t r = 0;
+    for (uint32_t low = 0; low < ZS_LOW_RANGE; low++) {
+        if (!bit_test(bits, low)) {
+            continue;
+        }
+
+        uint32_t end = low;
+        while (end + 1 < ZS_LOW_RANGE && bit_test(bits, end + 1)) {
+            end++;
+        }
+
+        c->values[2 * r] = (uint16_t) low;
+        c->values[2 * r + 1] = (uint16_t) (end - low);
+        r++;
+        low = end;
+    }
+
+    free(c->bits);
+    c->bits = NULL;
+    c->type = ZS_RUN;
+    c->length = runs;
+    return true;
+}
+
+static size_t find_container(const geohex_zoneset_t *set, uint64_t key, bool *found) {
+    size_t lo = 0, hi = set->count;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (set->containers[mid].key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    *found = lo < set->count && set->containers[lo].key == key;
+    return lo;
+}
+
+static zs_container_t *insert_container(geohex_zoneset_t *set, size_t index, uint64_t key) {
+    if (set->count == set->capacity) {
+        size_t capacity = set->capacity ? set->capacity * 2 : 8;
+        zs_container_t *containers = realloc(set->containers, capacity * sizeof(zs_container_t));
+
+        if (!containers) {
+            return NULL;
+        }
+
+        set->containers = containers;
+        set->capacity = capacity;
+    }
+
+    memmove(set->containers + index + 1, set->containers + index, (set->count - index) * sizeof(zs_container_t));
+    set->count++;
+
+    zs_container_t *c = &set->containers[index];
+    memset(c, 0, sizeof(zs_container_t));
+    c->key = key;
+    c->type = ZS_ARRAY;
+    return c;
+}
+
+/* Appends an empty container; keys must be added in increasing order. */
+static zs_container_t *append_container(geohex_zoneset_t *set, uint64_t key) {
+    return insert_container(set, set->count, key);
+}
+
+geohex_zoneset_t *geohex_zoneset_create(void) {
+    return calloc(1, sizeof(geohex_zoneset_t));
+}
+
+void geohex_zoneset_destroy(geohex_zoneset_t *set) {
+    if (!set) {
+        return;
+    }
+
+    for (size_t i = 0; i < set->count; i++) {
+        container_free(&set->containers[i]);
+    }
+
+    free(set->containers);
+    free(set);
+}
+
+bool geohex_zoneset_add(geohex_zoneset_t *set, geohex_id_t id) {
+    uint64_t key;
+    uint16_t low;
+    bool found;
+
+    if (!set || !split_id(id, &key, &low)) {
+        return false;
+    }
+
+    size_t index = find_container(set, key, &found);
+    zs_container_t *c = found ? &set->containers[index] : insert_container(set, index, key);
+
+    return c && container_add(c, low);
+}
+
+bool geohex_zoneset_add_many(geohex_zoneset_t *set, const geohex_id_t *ids, size_t n) {
+    if (!set || (!ids && n)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (!geohex_zoneset_add(set, ids[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool geohex_zoneset_contains(const geohex_zoneset_t *set, geohex_id_t id) {
+    uint64_t key;
+    uint16_t low;
+    bool found;
+
+    if (!set || !split_id(id, &key, &low)) {
+        return false;
+    }
+
+    size_t index = find_container(set, key, &found);
+
+    return found && container_contains(&set->containers[index], low);
+}
+
+size_t geohex_zoneset_size(const geohex_zoneset_t *set) {
+    size_t size = 0;
+
+    for (size_t i = 0; set && i < set->count; i++) {
+        size += set->containers[i].cardinality;
+    }
+
+    return size;
+}
+
+bool geohex_zoneset_optimize(geohex_zoneset_t *set) {
+    if (!set) {
+        return false;
+    }
+
+    for (size_t i = 0; i < set->count; i++) {
+        if (!container_optimize(&set->containers[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void geohex_zoneset_iter_init(const geohex_zoneset_t *set, geohex_zoneset_iter_t *iter) {
+    if (!iter) {
+        return;
+    }
+
+    iter->set = set;
+    iter->container = 0;
+    iter->position = 0;
+    iter->offset = 0;
+}
+
+bool geohex_zoneset_iter_next(geohex_zoneset_iter_t *iter, geohex_id_t *out) {
+    if (!iter || !iter->set || !out) {
+        return false;
+    }
+
+    while (iter->container < iter->set->count) {
+        const zs_container_t *c = &iter->set->containers[iter->container];
+
+        if (c->type == ZS_ARRAY && iter->position < c->length) {
+            *out = join_id(c->key, c->values[iter->position++]);
+            return true;
+        }
+
+        if (c->type == ZS_RUN && iter->position < c->length) {
+            uint32_t low = (uint32_t) c->values[2 * iter->position] + iter->offset;
+
+            if (iter->offset++ == c->values[2 * iter->position + 1]) {
+                iter->position++;
+                iter->offset = 0;
+            }
+
+            *out = join_id(c->key, low);
+            return true;
+        }
+
+        if (c->type == ZS_BITMAP) {
+            /* position is the next bit to look at */
+            while (iter->position < ZS_LOW_RANGE) {
+                uint64_t word = c->bits[iter->position >> 6] >> (iter->position & 63);
+
+                if (word) {
+                    uint32_t low = iter->position + (uint32_t) __builtin_ctzll(word);
+
+                    iter->position = low + 1;
+                    *out = join_id(c->key, low);
+                    return true;
+                }
+
+                iter->position = (iter->position | 63) + 1;
+            }
+        }
+
+        iter->container++;
+        iter->position = 0;
+        iter->offset = 0;
+    }
+
+    return false;
+}
+
+static bool combine(zs_container_t *dst, const zs_container_t *a, const zs_container_t *b, bool intersect) {
+    if (a->type == ZS_ARRAY && b->type == ZS_ARRAY && (intersect || a->length + b->length <= ZS_ARRAY_MAX)) {
+        uint32_t i = 0, j = 0;
+
+        if (!reserve_values(dst, intersect ? (a->length < b->length ? a->length : b->length) : a->length + b->length)) {
+            return false;
+        }
+
+        while (i < a->length && j < b->length) {
+            if (a->values[i] == b->values[j]) {
+                dst->values[dst->length++] = a->values[i];
+                i++;
+                j++;
+            } else if (a->values[i] < b->values[j]) {
+                if (!intersect) {
+                    dst->values[dst->length++] = a->values[i];
+                }
+                i++;
+            } else {
+                if (!intersect) {
+                    dst->values[dst->length++] = b->values[j];
+                }
+                j++;
+            }
+        }
+
+        if (!intersect) {
+            while (i < a->length) {
+                dst->values[dst->length++] = a->values[i++];
+            }
+            while (j < b->length) {
+                dst->values[dst->length++] = b->values[j++];
+            }
+        }
+
+        dst->cardinality = dst->length;
+        return true;
+    }
+
+    uint64_t bits_a[ZS_BITMAP_WORDS], bits_b[ZS_BITMAP_WORDS];
+
+    fill_bitmap(a, bits_a);
+    fill_bitmap(b, bits_b);
+
+    for (uint32_t w = 0; w < ZS_BITMAP_WORDS; w++) {
+        bits_a[w] = intersect ? bits_a[w] & bits_b[w] : bits_a[w] | bits_b[w];
+    }
+
+    return load_bitmap(dst, bits_a);
+}
+
+static bool copy_container(zs_container_t *dst, const zs_container_t *src) {
+    uint64_t bits[ZS_BITMAP_WORDS];
+
+    if (src->type == ZS_BITMAP) {
+        fill_bitmap(src, bits);
+        return load_bitmap(dst, bits);
+    }
+
+    uint32_t slots = src->type == ZS_RUN ? src->length * 2 : src->length;
+    if (!reserve_values(dst, slots)) {
+        return false;
+    }
+
+    memcpy(dst->values, src->values, slots * sizeof(uint16_t));
+    dst->type = src->type;
+    dst->length = src->length;
+    dst->cardinality = src->cardinality;
+    return true;
+}
+
+static geohex_zoneset_t *combine_sets(const geohex_zoneset_t *a, const geohex_zoneset_t *b, bool intersect) {
+    if (!a || !b) {
+        return NULL;
+    }
+
+    geohex_zoneset_t *out = geohex_zoneset_create();
+    size_t i = 0, j = 0;
+    bool ok = out != NULL;
+
+    while (ok && (i < a->count || j < b->count)) {
+        const zs_container_t *ca = i < a->count ? &a->containers[i] : NULL;
+        const zs_container_t *cb = j < b->count ? &b->containers[j] : NULL;
+        zs_container_t *dst;
+
+        if (ca && cb && ca->key == cb->key) {
+            ok = (dst = append_container(out, ca->key)) && combine(dst, ca, cb, intersect);
+            if (ok && dst->cardinality == 0) {
+                container_free(dst);
+                out->count--;
+            }
+            i++;
+            j++;
+        } else if (cb == NULL || (ca && ca->key < cb->key)) {
+            ok = intersect || ((dst = append_container(out, ca->key)) && copy_container(dst, ca));
+            i++;
+        } else {
+            ok = intersect || ((dst = append_container(out, cb->key)) && copy_container(dst, cb));
+            j++;
+        }
+    }
+
+    if (!ok) {
+        geohex_zoneset_destroy(out);
+        return NULL;
+    }
+
+    return out;
+}
+
+geohex_zoneset_t *geohex_zoneset_union(const geohex_zoneset_t *a, const geohex_zoneset_t *b) {
+    return combine_sets(a, b, false);
+}
+
+geohex_zoneset_t *geohex_zoneset_intersection(const geohex_zoneset_t *a, const geohex_zoneset_t *b) {
+    return combine_sets(a, b, true);
+}
+
+static size_t payload_size(const zs_container_t *c) {
+    switch (c->type) {
+        case ZS_ARRAY:
+            return (size_t) c->length * 2;
+        case ZS_RUN:
+            return (size_t) c->length * 4;
+        default:
+            return (size_t) c->length * 8;
+    }
+}
+
+size_t geohex_zoneset_serialized_size(const geohex_zoneset_t *set) {
+    size_t size = ZS_HEADER_SIZE;
+
+    for (size_t i = 0; set && i < set->count; i++) {
+        size += ZS_CONTAINER_SIZE + payload_size(&set->containers[i]);
+    }
+
+    return size;
+}
+
+/*
+ * Layout, all integers little-endian:
+ *   header:    "GHZS", u8 version, 3 reserved bytes, u32 container count
+ *   container: u64 key (level << 56 | code prefix), u8 type, 3 reserved bytes,
+ *              u32 cardinality, u32 length, then the payload of u16 values,
+ *              u16 (start, length - 1) run pairs or u64 bitmap words
+ */
+bool geohex_zoneset_serialize(const geohex_zoneset_t *set, uint8_t *buf, size_t capacity, size_t *written) {
+    if (!set || !written) {
+        return false;
+    }
+
+    size_t size = geohex_zoneset_serialized_size(set);
+    *written = size;
+    if (!buf || capacity < size || set->count > UINT32_MAX) {
+        return false;
+    }
+
+    memcpy(buf, ZS_MAGIC, 4);
+    buf[4] = ZS_VERSION;
+    buf[5] = buf[6] = buf[7] = 0;
+    put_le32(buf + 8, (uint32_t) set->count);
+
+    uint8_t *p = buf + ZS_HEADER_SIZE;
+    for (size_t i = 0; i < set->count; i++) {
+        const zs_container_t *c = &set->containers[i];
+
+        put_le64(p, c->key);
+        p[8] = (uint8_t) c->type;
+        p[9] = p[10] = p[11] = 0;
+        put_le32(p + 12, c->cardinality);
+        put_le32(p + 16, c->length);
+        p += ZS_CONTAINER_SIZE;
+
+        if (c->type == ZS_BITMAP) {
+            for (uint32_t w = 0; w < c->length; w++, p += 8) {
+                put_le64(p, c->bits[w]);
+            }
+        } else {
+            uint32_t slots = c->type == ZS_RUN ? c->length * 2 : c->length;
+
+            for (uint32_t k = 0; k < slots; k++, p += 2) {
+                put_le16(p, c->values[k]);
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool validate_container(const zs_container_t *c) {
+    uint32_t cardinality = 0;
+
+    if (c->type == ZS_BITMAP) {
+        for (uint32_t w = 0; w < ZS_BITMAP_WORDS; w++) {
+            cardinality += (uint32_t) __builtin_popcountll(c->bits[w]);
+        }
+        /* bits past the last index must be clear */
+        return cardinality == c->cardinality && (c->bits[ZS_BITMAP_WORDS - 1] >> (ZS_LOW_RANGE & 63)) == 0;
+    }
+
+    if (c->type == ZS_ARRAY) {
+        for (uint32_t i = 0; i < c->length; i++) {
+            if (c->values[i] >= ZS_LOW_RANGE || (i > 0 && c->values[i - 1] >= c->values[i])) {
+                return false;
+            }
+        }
+        return c->length == c->cardinality && c->length <= ZS_ARRAY_MAX;
+    }
+
+    uint32_t next = 0;
+    for (uint32_t r = 0; r < c->length; r++) {
+        uint32_t start = c->values[2 * r];
+        uint32_t end = start + c->values[2 * r + 1];
+
+        if (start < next || end >= ZS_LOW_RANGE) {
+            return false;
+        }
+        cardinality += end - start + 1;
+        next = end + 2;
+    }
+
+    return cardinality == c->cardinality;
+}
+
+geohex_zoneset_t *geohex_zoneset_deserialize(const uint8_t *buf, size_t len) {
+    if (!buf || len < ZS_HEADER_SIZE || memcmp(buf, ZS_MAGIC, 4) != 0 || buf[4] != ZS_VERSION) {
+        return NULL;
+    }
+
+    uint32_t count = get_le32(buf + 8);
+    geohex_zoneset_t *set = geohex_zoneset_create();
+    const uint8_t *p = buf + ZS_HEADER_SIZE, *end = buf + len;
+
+    for (uint32_t i = 0; set && i < count; i++) {
+        if ((size_t) (end - p) < ZS_CONTAINER_SIZE) {
+            goto fail;
+        }
+
+        uint64_t key = get_le64(p);
+        uint32_t type = p[8];
+        uint32_t cardinality = get_le32(p + 12);
+        uint32_t length = get_le32(p + 16);
+        p += ZS_CONTAINER_SIZE;
+
+        if ((key >> ZS_LEVEL_SHIFT) > MAX_LEVEL || type > ZS_RUN ||
+            (set->count > 0 && set->containers[set->count - 1].key >= key)) {
+            goto fail;
+        }
+
+        zs_container_t *c = append_container(set, key);
+        if (!c) {
+            goto fail;
+        }
+
+        c->type = type;
+        c->cardinality = cardinality;
+        c->length = length;
+
+        if (type == ZS_BITMAP) {
+            if (length != ZS_BITMAP_WORDS || (size_t) (end - p) < (size_t) length * 8 ||
+                !(c->bits = malloc(ZS_BITMAP_WORDS * sizeof(uint64_t)))) {
+                goto fail;
+            }
+            for (uint32_t w = 0; w < length; w++, p += 8) {
+                c->bits[w] = get_le64(p);
+            }
+        } else {
+            if (length > ZS_LOW_RANGE) {
+                goto fail;
+            }
+
+            uint32_t slots = type == ZS_RUN ? length * 2 : length;
+            if ((size_t) (end - p) < (size_t) slots * 2 || !reserve_values(c, slots)) {
+                goto fail;
+            }
+            for (uint32_t k = 0; k < slots; k++, p += 2) {
+                c->values[k] = get_le16(p);
+            }
+        }
+
+        if (cardinality == 0 || !validate_container(c)) {
+            goto fail;
+        }
+    }
+
+    if (set && p == end) {
+        return set;
+    }
+
+fail:
+    geohex_zoneset_destroy(set);
+    return NULL;
+}
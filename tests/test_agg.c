@@ -0,0 +1,234 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/agg.h"
+#include "geohex/parallel.h"
+
+#include "json_data.h"
+
+#define POINTS  (sizeof(coord2hex_data) / sizeof(coord2hex_data[0]))
+
+static double lon[POINTS], lat[POINTS], value[POINTS];
+
+void setUp(void)
+{
+    for (uint32_t i = 0; i < POINTS; i++) {
+        lon[i] = coord2hex_data[i].lon;
+        lat[i] = coord2hex_data[i].lat;
+        value[i] = (double) (i % 17) - 8.0;
+    }
+}
+
+void tearDown(void) {}
+
+static const geohex_agg_entry_t *find_entry(const geohex_agg_entry_t *entries, size_t n, geohex_id_t id)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (entries[i].id == id) {
+            return &entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+void test_agg_create(void)
+{
+    TEST_ASSERT_NULL(geohex_agg_create(5, 4));
+    TEST_ASSERT_NULL(geohex_agg_create(0, MAX_LEVEL + 1));
+
+    geohex_agg_t *agg = geohex_agg_create(0, MAX_LEVEL);
+    TEST_ASSERT_NOT_NULL(agg);
+    TEST_ASSERT_EQUAL_size_t(0, geohex_agg_size(agg, MAX_LEVEL));
+    geohex_agg_destroy(agg);
+}
+
+void test_agg_finest_level(void)
+{
+    geohex_agg_t *agg = geohex_agg_create(2, 8);
+    geohex_agg_entry_t *entries = malloc(POINTS * sizeof(geohex_agg_entry_t));
+    size_t written;
+    uint64_t total = 0;
+
+    TEST_ASSERT_TRUE(geohex_agg_add_batch(agg, lon, lat, value, POINTS));
+    TEST_ASSERT_TRUE(geohex_agg_export(agg, 8, entries, POINTS, &written));
+    TEST_ASSERT_EQUAL_size_t(geohex_agg_size(agg, 8), written);
+
+    for (size_t i = 0; i < written; i++) {
+        if (i > 0) {
+            TEST_ASSERT_TRUE(entries[i - 1].id < entries[i].id);
+        }
+        TEST_ASSERT_TRUE(entries[i].stats.min <= entries[i].stats.max);
+        total += entries[i].stats.count;
+    }
+    TEST_ASSERT_EQUAL_UINT64(POINTS, total);
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        loc_t loc = {lon[i], lat[i]};
+        zone_t zone;
+        geohex_id_t id;
+
+        TEST_ASSERT_TRUE(get_zone_by_location(&loc, 8, &zone));
+        TEST_ASSERT_TRUE(get_id_by_code(zone.code, &id));
+
+        const geohex_agg_entry_t *entry = find_entry(entries, written, id);
+        TEST_ASSERT_NOT_NULL(entry);
+        TEST_ASSERT_TRUE(entry->stats.min <= value[i]);
+        TEST_ASSERT_TRUE(entry->stats.max >= value[i]);
+    }
+
+    free(entries);
+    geohex_agg_destroy(agg);
+}
+
+void test_agg_rollup(void)
+{
+    geohex_agg_t *agg = geohex_agg_create(3, 9);
+    geohex_agg_entry_t *fine = malloc(POINTS * sizeof(geohex_agg_entry_t));
+    geohex_agg_entry_t *coarse = malloc(POINTS * sizeof(geohex_agg_entry_t));
+    size_t fine_n, coarse_n;
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        loc_t loc = {lon[i], lat[i]};
+        TEST_ASSERT_TRUE(geohex_agg_add(agg, &loc, value[i]));
+    }
+
+    TEST_ASSERT_TRUE(geohex_agg_export(agg, 9, fine, POINTS, &fine_n));
+
+    for (uint32_t level = 3; level < 9; level++) {
+        uint64_t total = 0;
+
+        TEST_ASSERT_TRUE(geohex_agg_export(agg, level, coarse, POINTS, &coarse_n));
+
+        for (size_t i = 0; i < coarse_n; i++) {
+            geohex_stats_t expected = {0, 0.0, 0.0, 0.0};
+            geohex_code_t code, fine_code;
+
+            TEST_ASSERT_EQUAL_UINT32(level, get_level_by_id(coarse[i].id));
+            TEST_ASSERT_TRUE(get_code_by_id(coarse[i].id, code));
+
+            for (size_t j = 0; j < fine_n; j++) {
+                TEST_ASSERT_TRUE(get_code_by_id(fine[j].id, fine_code));
+                if (strncmp(code, fine_code, level + 2) != 0) {
+                    continue;
+                }
+                if (expected.count == 0 || fine[j].stats.min < expected.min) {
+                    expected.min = fine[j].stats.min;
+                }
+                if (expected.count == 0 || fine[j].stats.max > expected.max) {
+                    expected.max = fine[j].stats.max;
+                }
+                expected.count += fine[j].stats.count;
+                expected.sum += fine[j].stats.sum;
+            }
+
+            TEST_ASSERT_EQUAL_UINT64(expected.count, coarse[i].stats.count);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, expected.sum, coarse[i].stats.sum);
+            TEST_ASSERT_EQUAL_DOUBLE(expected.min, coarse[i].stats.min);
+            TEST_ASSERT_EQUAL_DOUBLE(expected.max, coarse[i].stats.max);
+            total += coarse[i].stats.count;
+        }
+
+        TEST_ASSERT_EQUAL_UINT64(POINTS, total);
+    }
+
+    free(fine);
+    free(coarse);
+    geohex_agg_destroy(agg);
+}
+
+void test_agg_export_capacity(void)
+{
+    geohex_agg_t *agg = geohex_agg_create(5, 5);
+    geohex_agg_entry_t entry;
+    size_t written;
+
+    TEST_ASSERT_TRUE(geohex_agg_add_batch(agg, lon, lat, NULL, POINTS));
+    TEST_ASSERT_FALSE(geohex_agg_export(agg, 5, &entry, 1, &written));
+    TEST_ASSERT_TRUE(written > 1);
+    TEST_ASSERT_FALSE(geohex_agg_export(agg, 4, &entry, 1, &written));
+
+    geohex_agg_clear(agg);
+    TEST_ASSERT_TRUE(geohex_agg_export(agg, 5, NULL, 0, &written));
+    TEST_ASSERT_EQUAL_size_t(0, written);
+
+    geohex_agg_destroy(agg);
+}
+
+void test_agg_add_batch_parallel(void)
+{
+    geohex_agg_t *serial = geohex_agg_create(4, 10);
+    geohex_agg_t *sharded = geohex_agg_create(4, 10);
+    geohex_agg_entry_t *expected = malloc(POINTS * sizeof(geohex_agg_entry_t));
+    geohex_agg_entry_t *actual = malloc(POINTS * sizeof(geohex_agg_entry_t));
+    geohex_pool_t *pool = geohex_pool_create(4);
+    geohex_executor_t executor;
+    geohex_agg_timings_t timings;
+    size_t expected_n, actual_n;
+
+    TEST_ASSERT_TRUE(geohex_pool_executor(pool, &executor));
+
+    /* the second round merges into zones that already exist */
+    for (uint32_t round = 0; round < 2; round++) {
+        TEST_ASSERT_TRUE(geohex_agg_add_batch(serial, lon, lat, value, POINTS));
+        TEST_ASSERT_TRUE(geohex_agg_add_batch_parallel(sharded, &executor, lon, lat, value, POINTS, &timings));
+        TEST_ASSERT_TRUE(timings.encode > 0.0);
+        TEST_ASSERT_TRUE(timings.accumulate > 0.0);
+        TEST_ASSERT_TRUE(timings.merge > 0.0);
+    }
+
+    /* serial adds must find the zones the parallel path indexed */
+    TEST_ASSERT_TRUE(geohex_agg_add_batch(serial, lon, lat, value, POINTS));
+    TEST_ASSERT_TRUE(geohex_agg_add_batch(sharded, lon, lat, value, POINTS));
+
+    for (uint32_t level = 4; level <= 10; level++) {
+        TEST_ASSERT_TRUE(geohex_agg_export(serial, level, expected, POINTS, &expected_n));
+        TEST_ASSERT_TRUE(geohex_agg_export(sharded, level, actual, POINTS, &actual_n));
+        TEST_ASSERT_EQUAL_size_t(expected_n, actual_n);
+
+        for (size_t i = 0; i < expected_n; i++) {
+            TEST_ASSERT_EQUAL_UINT64(expected[i].id, actual[i].id);
+            TEST_ASSERT_EQUAL_UINT64(expected[i].stats.count, actual[i].stats.count);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, expected[i].stats.sum, actual[i].stats.sum);
+            TEST_ASSERT_EQUAL_DOUBLE(expected[i].stats.min, actual[i].stats.min);
+            TEST_ASSERT_EQUAL_DOUBLE(expected[i].stats.max, actual[i].stats.max);
+        }
+    }
+
+    geohex_pool_destroy(pool);
+    free(expected);
+    free(actual);
+    geohex_agg_destroy(serial);
+    geohex_agg_destroy(sharded);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_agg_create);
+    RUN_TEST(test_agg_finest_level);
+    RUN_TEST(test_agg_rollup);
+    RUN_TEST(test_agg_export_capacity);
+    RUN_TEST(test_agg_add_batch_parallel);
+
+    return UNITY_END();
+}
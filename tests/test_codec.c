@@ -0,0 +1,152 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/sort.h"
+#include "geohex/codec.h"
+
+#include "json_data.h"
+
+#define POINTS  (sizeof(coord2hex_data) / sizeof(coord2hex_data[0]))
+#define DENSE   20000
+
+static const geohex_code_t dense_base = "XM488548768";
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static void assert_round_trip(const geohex_id_t *ids, size_t n, size_t *encoded_size)
+{
+    size_t capacity = geohex_codec_bound(n), written, count = 0;
+    uint8_t *buf = malloc(capacity);
+    geohex_id_t *decoded = malloc((n + 1) * sizeof(geohex_id_t));
+    geohex_decoder_t decoder;
+    geohex_id_t id;
+
+    TEST_ASSERT_TRUE(geohex_codec_encode(ids, n, buf, capacity, &written));
+    TEST_ASSERT_TRUE(written <= capacity);
+
+    /* streaming */
+    TEST_ASSERT_TRUE(geohex_decoder_init(&decoder, buf, written));
+    TEST_ASSERT_EQUAL_UINT64(n, decoder.count);
+    while (geohex_decoder_next(&decoder, &id)) {
+        TEST_ASSERT_TRUE(count < n);
+        TEST_ASSERT_EQUAL_UINT64(ids[count], id);
+        count++;
+    }
+    TEST_ASSERT_FALSE(decoder.error);
+    TEST_ASSERT_EQUAL_size_t(n, count);
+
+    /* bulk */
+    TEST_ASSERT_TRUE(geohex_decoder_init(&decoder, buf, written));
+    TEST_ASSERT_EQUAL_size_t(n, geohex_decoder_read(&decoder, decoded, n + 1));
+    if (n > 0) {
+        TEST_ASSERT_EQUAL_MEMORY(ids, decoded, n * sizeof(geohex_id_t));
+    }
+
+    /* every truncation is detected */
+    for (size_t len = 0; len < written; len += 1 + len / 4) {
+        if (geohex_decoder_init(&decoder, buf, len)) {
+            TEST_ASSERT_TRUE(geohex_decoder_read(&decoder, decoded, n) < n);
+            TEST_ASSERT_TRUE(decoder.error);
+        }
+    }
+
+    if (encoded_size) {
+        *encoded_size = written;
+    }
+
+    free(decoded);
+    free(buf);
+}
+
+void test_codec_mixed_levels(void)
+{
+    geohex_id_t *ids = malloc(POINTS * sizeof(geohex_id_t));
+    size_t n = 0, unique_n;
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        loc_t loc = {coord2hex_data[i].lon, coord2hex_data[i].lat};
+        uint32_t level = i % (MAX_LEVEL + 1);
+        xy_t xy;
+
+        get_xy_by_location(&loc, level, &xy);
+        get_id_by_xy(&xy, level, &ids[n++]);
+    }
+    geohex_sort_unique_ids(ids, n, NULL, &unique_n);
+
+    assert_round_trip(ids, unique_n, NULL);
+    assert_round_trip(ids, 0, NULL);
+    assert_round_trip(ids, 1, NULL);
+    assert_round_trip(ids, 3, NULL);
+
+    free(ids);
+}
+
+void test_codec_dense_level(void)
+{
+    geohex_id_t *ids = malloc(DENSE * sizeof(geohex_id_t));
+    geohex_id_t base;
+    size_t n = 0, written;
+
+    get_id_by_code(dense_base, &base);
+    for (uint32_t i = 0; i < DENSE; i++) {
+        if (i % 1000 != 999) {
+            ids[n++] = base + ((geohex_id_t) i * 531441 << GEOHEX_ID_LEVEL_BITS);
+        }
+    }
+
+    assert_round_trip(ids, n, &written);
+    /* one byte per delta plus a two byte tag per four */
+    TEST_ASSERT_TRUE(written <= 16 + n + (n + 3) / 4 * 2 + 8);
+
+    free(ids);
+}
+
+void test_codec_invalid(void)
+{
+    geohex_id_t unsorted[] = {32, 16};
+    uint8_t buf[64];
+    size_t written;
+    geohex_decoder_t decoder;
+
+    TEST_ASSERT_FALSE(geohex_codec_encode(unsorted, 2, buf, sizeof(buf), &written));
+    TEST_ASSERT_FALSE(geohex_codec_encode(unsorted, 1, buf, 8, &written));
+
+    TEST_ASSERT_TRUE(geohex_codec_encode(unsorted, 1, buf, sizeof(buf), &written));
+    buf[0] = 'X';
+    TEST_ASSERT_FALSE(geohex_decoder_init(&decoder, buf, written));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_codec_mixed_levels);
+    RUN_TEST(test_codec_dense_level);
+    RUN_TEST(test_codec_invalid);
+
+    return UNITY_END();
+}
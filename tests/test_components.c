@@ -0,0 +1,242 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/parallel.h"
+#include "geohex/components.h"
+
+#define BIG     120000
+
+static geohex_id_t ids[BIG];
+static uint32_t labels[BIG];
+static uint32_t other_labels[BIG];
+static size_t sizes[BIG];
+static size_t other_sizes[BIG];
+
+static int compare_id(const void *a, const void *b)
+{
+    geohex_id_t ia = *(const geohex_id_t *) a, ib = *(const geohex_id_t *) b;
+
+    return (ia > ib) - (ia < ib);
+}
+
+static void fill(size_t n, uint32_t level, double lon, double lat, double span, uint64_t seed)
+{
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        loc_t loc = {lon + (double) (seed >> 40) / (1 << 24) * span, lat + (double) ((seed >> 16) & 0xffffff) / (1 << 24) * span};
+        xy_t xy;
+
+        get_xy_by_location(&loc, level, &xy);
+        get_id_by_xy(&xy, level, &ids[i]);
+    }
+}
+
+/* flood fill over the sorted distinct ids */
+static void assert_reference(size_t n, uint32_t level, size_t count)
+{
+    geohex_id_t *sorted = malloc(n * sizeof(geohex_id_t));
+    int32_t *component = malloc(n * sizeof(int32_t));
+    size_t *stack = malloc(n * sizeof(size_t));
+    size_t unique = 0, components = 0;
+
+    memcpy(sorted, ids, n * sizeof(geohex_id_t));
+    qsort(sorted, n, sizeof(geohex_id_t), compare_id);
+    for (size_t i = 0; i < n; i++) {
+        if (unique == 0 || sorted[unique - 1] != sorted[i]) {
+            sorted[unique++] = sorted[i];
+        }
+    }
+    memset(component, 0xff, unique * sizeof(int32_t));
+
+    for (size_t s = 0; s < unique; s++) {
+        size_t top = 0;
+
+        if (component[s] >= 0) {
+            continue;
+        }
+        component[s] = (int32_t) components;
+        stack[top++] = s;
+        while (top) {
+            xy_t xy, neighbors[6];
+
+            get_xy_by_id(sorted[stack[--top]], &xy);
+            get_xy_neighbors(&xy, level, neighbors);
+            for (int k = 0; k < 6; k++) {
+                geohex_id_t id;
+                geohex_id_t *hit;
+
+                get_id_by_xy(&neighbors[k], level, &id);
+                hit = bsearch(&id, sorted, unique, sizeof(geohex_id_t), compare_id);
+                if (hit && component[hit - sorted] < 0) {
+                    component[hit - sorted] = (int32_t) components;
+                    stack[top++] = (size_t) (hit - sorted);
+                }
+            }
+        }
+        components++;
+    }
+    TEST_ASSERT_EQUAL_size_t(components, count);
+
+    /* same partition, numbered by first appearance, with matching sizes */
+    int32_t *mapping = malloc(count * sizeof(int32_t));
+    size_t *counted = calloc(count, sizeof(size_t));
+    uint32_t next = 0;
+
+    memset(mapping, 0xff, count * sizeof(int32_t));
+    for (size_t i = 0; i < n; i++) {
+        size_t at = (size_t) ((geohex_id_t *) bsearch(&ids[i], sorted, unique, sizeof(geohex_id_t), compare_id) - sorted);
+
+        if (mapping[component[at]] < 0) {
+            TEST_ASSERT_EQUAL_UINT32(next++, labels[i]);
+            mapping[component[at]] = (int32_t) labels[i];
+        }
+        TEST_ASSERT_EQUAL_UINT32((uint32_t) mapping[component[at]], labels[i]);
+    }
+    for (size_t u = 0; u < unique; u++) {
+        counted[mapping[component[u]]]++;
+    }
+    TEST_ASSERT_EQUAL_MEMORY(counted, sizes, count * sizeof(size_t));
+
+    free(counted);
+    free(mapping);
+    free(stack);
+    free(component);
+    free(sorted);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_components_disks(void)
+{
+    loc_t centers[3] = {{139.70, 35.60}, {139.80, 35.60}, {139.75, 35.60}};
+    xy_t xy, disk[GEOHEX_DISK_SIZE(2)];
+    size_t n = 0, count;
+
+    /* two disks far apart, then a third one bridging them */
+    for (int c = 0; c < 2; c++) {
+        get_xy_by_location(&centers[c], 8, &xy);
+        for (size_t k = 0, m = get_xy_disk(&xy, 8, 2, disk); k < m; k++) {
+            get_id_by_xy(&disk[k], 8, &ids[n++]);
+        }
+    }
+    TEST_ASSERT_TRUE(geohex_components(ids, n, labels, sizes, &count));
+    TEST_ASSERT_EQUAL_size_t(2, count);
+    TEST_ASSERT_EQUAL_UINT32(0, labels[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, labels[n - 1]);
+    TEST_ASSERT_EQUAL_size_t(GEOHEX_DISK_SIZE(2), sizes[0]);
+    TEST_ASSERT_EQUAL_size_t(GEOHEX_DISK_SIZE(2), sizes[1]);
+
+    for (double lon = 139.70; lon <= 139.80; lon += 0.002) {
+        loc_t loc = {lon, 35.60};
+
+        get_xy_by_location(&loc, 8, &xy);
+        get_id_by_xy(&xy, 8, &ids[n++]);
+    }
+    TEST_ASSERT_TRUE(geohex_components(ids, n, labels, sizes, &count));
+    TEST_ASSERT_EQUAL_size_t(1, count);
+    assert_reference(n, 8, count);
+}
+
+void test_components_random(void)
+{
+    size_t count;
+
+    for (uint32_t level = 8; level <= 10; level++) {
+        fill(5000, level, 135.0, 34.5, 0.5, level);
+        TEST_ASSERT_TRUE(geohex_components(ids, 5000, labels, sizes, &count));
+        TEST_ASSERT_TRUE(count > 1);
+        assert_reference(5000, level, count);
+    }
+}
+
+void test_components_antimeridian(void)
+{
+    loc_t seam = {179.999, -16.7};
+    xy_t xy, disk[GEOHEX_DISK_SIZE(3)];
+    size_t count, n;
+
+    /* longitudes past 180 wrap around */
+    fill(4000, 7, 179.8, -17.0, 0.4, 3);
+    TEST_ASSERT_TRUE(geohex_components(ids, 4000, labels, sizes, &count));
+    assert_reference(4000, 7, count);
+
+    get_xy_by_location(&seam, 9, &xy);
+    n = get_xy_disk(&xy, 9, 3, disk);
+    for (size_t k = 0; k < n; k++) {
+        get_id_by_xy(&disk[k], 9, &ids[k]);
+    }
+    TEST_ASSERT_TRUE(geohex_components(ids, n, labels, sizes, &count));
+    TEST_ASSERT_EQUAL_size_t(1, count);
+    TEST_ASSERT_EQUAL_size_t(n, sizes[0]);
+}
+
+void test_components_parallel(void)
+{
+    geohex_pool_t *pool = geohex_pool_create(4);
+    geohex_executor_t executor;
+    size_t count, other_count;
+
+    TEST_ASSERT_TRUE(geohex_pool_executor(pool, &executor));
+
+    fill(BIG, 9, 139.0, 35.0, 0.6, 42);
+    TEST_ASSERT_TRUE(geohex_components(ids, BIG, labels, sizes, &count));
+    TEST_ASSERT_TRUE(geohex_components_parallel(&executor, ids, BIG, other_labels, other_sizes, &other_count));
+    TEST_ASSERT_EQUAL_size_t(count, other_count);
+    TEST_ASSERT_EQUAL_MEMORY(labels, other_labels, BIG * sizeof(uint32_t));
+    TEST_ASSERT_EQUAL_MEMORY(sizes, other_sizes, count * sizeof(size_t));
+    assert_reference(BIG, 9, count);
+
+    geohex_pool_destroy(pool);
+}
+
+void test_components_invalid(void)
+{
+    size_t count;
+
+    TEST_ASSERT_TRUE(geohex_components(NULL, 0, NULL, NULL, &count));
+    TEST_ASSERT_EQUAL_size_t(0, count);
+
+    fill(2, 7, 139.7, 35.7, 0.1, 1);
+    fill(1, 8, 139.7, 35.7, 0.1, 2);
+    TEST_ASSERT_FALSE(geohex_components(ids, 2, labels, sizes, &count));
+    TEST_ASSERT_FALSE(geohex_components(ids, 2, NULL, sizes, &count));
+    TEST_ASSERT_FALSE(geohex_components_parallel(NULL, ids, 2, labels, sizes, &count));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_components_disks);
+    RUN_TEST(test_components_random);
+    RUN_TEST(test_components_antimeridian);
+    RUN_TEST(test_components_parallel);
+    RUN_TEST(test_components_invalid);
+
+    return UNITY_END();
+}
@@ -0,0 +1,252 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/corridor.h"
+
+#define H_BASE      20037508.34
+#define MAX_COVER   65536
+#define SAMPLES     2000
+
+typedef struct {
+    geohex_id_t ids[MAX_COVER];
+    size_t n;
+    size_t blocks;
+} cover_t;
+
+static cover_t cover, other;
+
+static void collect(void *arg, const geohex_id_t *ids, size_t n)
+{
+    cover_t *c = arg;
+
+    TEST_ASSERT_TRUE(n > 0);
+    TEST_ASSERT_TRUE(c->n + n <= MAX_COVER);
+    memcpy(c->ids + c->n, ids, n * sizeof(geohex_id_t));
+    c->n += n;
+    c->blocks++;
+}
+
+static int compare_id(const void *a, const void *b)
+{
+    geohex_id_t ia = *(const geohex_id_t *) a, ib = *(const geohex_id_t *) b;
+
+    return (ia > ib) - (ia < ib);
+}
+
+static bool contains(const cover_t *c, geohex_id_t id)
+{
+    return bsearch(&id, c->ids, c->n, sizeof(geohex_id_t), compare_id) != NULL;
+}
+
+static void run_cover(cover_t *c, const loc_t *vertices, size_t n, uint32_t level, uint32_t buffer)
+{
+    c->n = 0;
+    c->blocks = 0;
+    TEST_ASSERT_TRUE(geohex_corridor_cover(vertices, n, level, buffer, collect, c));
+    qsort(c->ids, c->n, sizeof(geohex_id_t), compare_id);
+    for (size_t i = 1; i < c->n; i++) {
+        TEST_ASSERT_TRUE(c->ids[i - 1] != c->ids[i]);
+    }
+}
+
+static double mercator_y(double lat)
+{
+    return log(tan((90.0 + lat) * M_PI / 360.0)) * (H_BASE / M_PI);
+}
+
+static double mercator_lat(double y)
+{
+    return 180.0 / M_PI * (2.0 * atan(exp(y / H_BASE * M_PI)) - M_PI / 2.0);
+}
+
+static double unwrap(double x, double near)
+{
+    if (x - near > H_BASE) {
+        return x - 2.0 * H_BASE;
+    }
+    if (near - x > H_BASE) {
+        return x + 2.0 * H_BASE;
+    }
+    return x;
+}
+
+/* every point of the line lies in a covered zone */
+static void assert_samples(const loc_t *vertices, size_t n, uint32_t level)
+{
+    for (size_t i = 0; i + 1 < n; i++) {
+        double ax = vertices[i].lon * H_BASE / 180.0, ay = mercator_y(vertices[i].lat);
+        double bx = unwrap(vertices[i + 1].lon * H_BASE / 180.0, ax), by = mercator_y(vertices[i + 1].lat);
+
+        for (uint32_t s = 0; s < SAMPLES; s++) {
+            double t = (s + 0.5) / SAMPLES;
+            double x = unwrap(ax + t * (bx - ax), 0.0);
+            loc_t loc = {x * 180.0 / H_BASE, mercator_lat(ay + t * (by - ay))};
+            xy_t xy;
+            geohex_id_t id;
+
+            get_xy_by_location(&loc, level, &xy);
+            get_id_by_xy(&xy, level, &id);
+            TEST_ASSERT_TRUE(contains(&cover, id));
+        }
+    }
+}
+
+/* and every covered zone touches the line: its centre is within a circumradius */
+static void assert_tight(const loc_t *vertices, size_t n, uint32_t level)
+{
+    double h_size = H_BASE / pow(3.0, level + 3);
+
+    for (size_t z = 0; z < cover.n; z++) {
+        zone_t zone;
+        double best = INFINITY;
+
+        get_zone_by_id(cover.ids[z], &zone);
+
+        for (size_t i = 0; i + 1 < n || (n == 1 && i == 0); i++) {
+            size_t j = n == 1 ? i : i + 1;
+            double ax = vertices[i].lon * H_BASE / 180.0, ay = mercator_y(vertices[i].lat);
+            double bx = unwrap(vertices[j].lon * H_BASE / 180.0, ax), by = mercator_y(vertices[j].lat);
+            double cx = unwrap(3.0 * h_size * (zone.xy.x - zone.xy.y), ax);
+            double cy = sqrt(3.0) * h_size * (zone.xy.x + zone.xy.y);
+            double dx = bx - ax, dy = by - ay, len2 = dx * dx + dy * dy;
+            double t = len2 > 0 ? fmax(0.0, fmin(1.0, ((cx - ax) * dx + (cy - ay) * dy) / len2)) : 0.0;
+
+            best = fmin(best, hypot(ax + t * dx - cx, ay + t * dy - cy));
+        }
+
+        TEST_ASSERT_TRUE(best <= 2.0 * h_size * (1.0 + 1e-6));
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_corridor_route(void)
+{
+    static const loc_t route[] = {
+        {139.6917, 35.6895}, {139.7006, 35.6581}, {139.7454, 35.6586},
+        {139.7671, 35.6812}, {139.7745, 35.7100}, {139.7000, 35.7300},
+    };
+    size_t n = sizeof(route) / sizeof(route[0]);
+
+    for (uint32_t level = 6; level <= 11; level++) {
+        run_cover(&cover, route, n, level, 0);
+        TEST_ASSERT_TRUE(cover.n > 0);
+        assert_samples(route, n, level);
+        assert_tight(route, n, level);
+    }
+
+    /* a long line streams in several blocks */
+    run_cover(&cover, route, n, 13, 0);
+    TEST_ASSERT_TRUE(cover.blocks > 1);
+    assert_samples(route, n, 13);
+}
+
+void test_corridor_buffer(void)
+{
+    static const loc_t route[] = {
+        {-0.1276, 51.5072}, {-0.0877, 51.5136}, {-0.0761, 51.5081}, {-0.1000, 51.4900},
+    };
+    size_t n = sizeof(route) / sizeof(route[0]);
+
+    for (uint32_t buffer = 1; buffer <= 4; buffer++) {
+        xy_t disk[GEOHEX_DISK_SIZE(4)];
+
+        run_cover(&cover, route, n, 9, 0);
+        memcpy(other.ids, cover.ids, cover.n * sizeof(geohex_id_t));
+        other.n = cover.n;
+
+        /* dilate the bare line by hand */
+        for (size_t z = 0, base = other.n; z < base; z++) {
+            xy_t xy;
+            size_t cells;
+
+            get_xy_by_id(other.ids[z], &xy);
+            cells = get_xy_disk(&xy, 9, buffer, disk);
+            for (size_t c = 0; c < cells; c++) {
+                get_id_by_xy(&disk[c], 9, &other.ids[other.n++]);
+            }
+        }
+        qsort(other.ids, other.n, sizeof(geohex_id_t), compare_id);
+        size_t unique = 0;
+        for (size_t i = 0; i < other.n; i++) {
+            if (unique == 0 || other.ids[unique - 1] != other.ids[i]) {
+                other.ids[unique++] = other.ids[i];
+            }
+        }
+
+        run_cover(&cover, route, n, 9, buffer);
+        TEST_ASSERT_EQUAL_size_t(unique, cover.n);
+        TEST_ASSERT_EQUAL_MEMORY(other.ids, cover.ids, unique * sizeof(geohex_id_t));
+    }
+
+    /* a lone vertex is a disk */
+    run_cover(&cover, route, 1, 9, 3);
+    TEST_ASSERT_EQUAL_size_t(GEOHEX_DISK_SIZE(3), cover.n);
+}
+
+void test_corridor_antimeridian(void)
+{
+    static const loc_t route[] = {
+        {179.95, -16.9}, {-179.93, -16.85}, {-179.99, -16.7}, {179.97, -16.6}, {179.9, -16.55},
+    };
+    size_t n = sizeof(route) / sizeof(route[0]);
+
+    for (uint32_t level = 5; level <= 9; level++) {
+        run_cover(&cover, route, n, level, 0);
+        assert_samples(route, n, level);
+        assert_tight(route, n, level);
+    }
+
+    /* the short way: a handful of zones, not a lap of the globe */
+    run_cover(&cover, route, 2, 7, 1);
+    TEST_ASSERT_TRUE(cover.n < 100);
+}
+
+void test_corridor_invalid(void)
+{
+    loc_t route[] = {{139.7, 35.7}, {139.8, 90.0}};
+
+    TEST_ASSERT_FALSE(geohex_corridor_cover(route, 2, 7, 0, NULL, &cover));
+    TEST_ASSERT_FALSE(geohex_corridor_cover(NULL, 2, 7, 0, collect, &cover));
+    TEST_ASSERT_FALSE(geohex_corridor_cover(route, 2, MAX_LEVEL + 1, 0, collect, &cover));
+    TEST_ASSERT_FALSE(geohex_corridor_cover(route, 2, 7, 0, collect, &cover));
+    TEST_ASSERT_TRUE(geohex_corridor_cover(route, 0, 7, 0, collect, &cover));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_corridor_route);
+    RUN_TEST(test_corridor_buffer);
+    RUN_TEST(test_corridor_antimeridian);
+    RUN_TEST(test_corridor_invalid);
+
+    return UNITY_END();
+}
@@ -0,0 +1,209 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/counter.h"
+
+#include "json_data.h"
+
+#define POINTS  (sizeof(coord2hex_data) / sizeof(coord2hex_data[0]))
+#define THREADS 4
+#define ROUNDS  50
+
+static geohex_id_t ids[POINTS];
+
+typedef struct {
+    geohex_counter_t *counter;
+    uint32_t offset;
+    bool ok;
+} worker_t;
+
+void setUp(void)
+{
+    for (uint32_t i = 0; i < POINTS; i++) {
+        loc_t loc = {coord2hex_data[i].lon, coord2hex_data[i].lat};
+        xy_t xy;
+
+        get_xy_by_location(&loc, 6, &xy);
+        get_id_by_xy(&xy, 6, &ids[i]);
+    }
+}
+
+void tearDown(void) {}
+
+static uint64_t expected_count(geohex_id_t id)
+{
+    uint64_t count = 0;
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        count += ids[i] == id;
+    }
+
+    return count;
+}
+
+static void *worker_main(void *arg)
+{
+    worker_t *worker = arg;
+
+    worker->ok = true;
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        for (uint32_t i = 0; i < POINTS; i++) {
+            worker->ok &= geohex_counter_add(worker->counter, ids[(i + worker->offset) % POINTS], 1);
+        }
+    }
+
+    return NULL;
+}
+
+void test_counter_single_thread(void)
+{
+    geohex_counter_t *counter = geohex_counter_create(POINTS);
+
+    TEST_ASSERT_NULL(geohex_counter_create(0));
+    TEST_ASSERT_NOT_NULL(counter);
+    TEST_ASSERT_FALSE(geohex_counter_add(counter, GEOHEX_ID_INVALID, 1));
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        TEST_ASSERT_TRUE(geohex_counter_add(counter, ids[i], 1));
+    }
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        TEST_ASSERT_EQUAL_UINT64(expected_count(ids[i]), geohex_counter_get(counter, ids[i]));
+    }
+
+    geohex_counter_entry_t *entries = malloc(POINTS * sizeof(geohex_counter_entry_t));
+    size_t n = geohex_counter_snapshot(counter, entries, POINTS);
+    uint64_t total = 0;
+
+    TEST_ASSERT_EQUAL_size_t(geohex_counter_size(counter), n);
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_UINT64(expected_count(entries[i].id), entries[i].count);
+        total += entries[i].count;
+    }
+    TEST_ASSERT_EQUAL_UINT64(POINTS, total);
+
+    free(entries);
+    geohex_counter_destroy(counter);
+}
+
+void test_counter_full(void)
+{
+    geohex_counter_t *counter = geohex_counter_create(2);
+
+    TEST_ASSERT_TRUE(geohex_counter_add(counter, 0x10, 1));
+    TEST_ASSERT_TRUE(geohex_counter_add(counter, 0x20, 1));
+    TEST_ASSERT_TRUE(geohex_counter_add(counter, 0x10, 5));
+    TEST_ASSERT_FALSE(geohex_counter_add(counter, 0x30, 1));
+    TEST_ASSERT_EQUAL_UINT64(6, geohex_counter_get(counter, 0x10));
+    TEST_ASSERT_EQUAL_UINT64(0, geohex_counter_get(counter, 0x30));
+
+    geohex_counter_destroy(counter);
+}
+
+void test_counter_zero_delta(void)
+{
+    geohex_counter_t *counter = geohex_counter_create(1);
+    geohex_counter_entry_t entry;
+
+    /* a zero add neither stores the zone nor uses up the only slot */
+    TEST_ASSERT_TRUE(geohex_counter_add(counter, 0x10, 0));
+    TEST_ASSERT_EQUAL_size_t(0, geohex_counter_size(counter));
+    TEST_ASSERT_TRUE(geohex_counter_add(counter, 0x20, 3));
+    TEST_ASSERT_TRUE(geohex_counter_add(counter, 0x20, 0));
+    TEST_ASSERT_EQUAL_size_t(1, geohex_counter_size(counter));
+    TEST_ASSERT_EQUAL_size_t(1, geohex_counter_snapshot(counter, &entry, 1));
+    TEST_ASSERT_EQUAL_UINT64(0x20, entry.id);
+    TEST_ASSERT_EQUAL_UINT64(3, entry.count);
+
+    geohex_counter_destroy(counter);
+}
+
+static void *overflow_main(void *arg)
+{
+    worker_t *worker = arg;
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        geohex_counter_add(worker->counter, ids[(i + worker->offset) % POINTS], 1);
+    }
+
+    return NULL;
+}
+
+void test_counter_concurrent_full(void)
+{
+    geohex_counter_t *counter = geohex_counter_create(8);
+    geohex_counter_entry_t entries[POINTS];
+    pthread_t threads[THREADS];
+    worker_t workers[THREADS];
+
+    /* racing adders of distinct zones never overfill the counter */
+    for (uint32_t t = 0; t < THREADS; t++) {
+        workers[t].counter = counter;
+        workers[t].offset = t * 97;
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[t], NULL, overflow_main, &workers[t]));
+    }
+    for (uint32_t t = 0; t < THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    TEST_ASSERT_EQUAL_size_t(8, geohex_counter_size(counter));
+    TEST_ASSERT_EQUAL_size_t(8, geohex_counter_snapshot(counter, entries, POINTS));
+
+    geohex_counter_destroy(counter);
+}
+
+void test_counter_concurrent(void)
+{
+    geohex_counter_t *counter = geohex_counter_create(POINTS);
+    pthread_t threads[THREADS];
+    worker_t workers[THREADS];
+
+    for (uint32_t t = 0; t < THREADS; t++) {
+        workers[t].counter = counter;
+        workers[t].offset = t * 97;
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[t], NULL, worker_main, &workers[t]));
+    }
+
+    for (uint32_t t = 0; t < THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        TEST_ASSERT_TRUE(workers[t].ok);
+    }
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        TEST_ASSERT_EQUAL_UINT64(expected_count(ids[i]) * THREADS * ROUNDS, geohex_counter_get(counter, ids[i]));
+    }
+
+    geohex_counter_destroy(counter);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_counter_single_thread);
+    RUN_TEST(test_counter_full);
+    RUN_TEST(test_counter_zero_delta);
+    RUN_TEST(test_counter_concurrent);
+    RUN_TEST(test_counter_concurrent_full);
+
+    return UNITY_END();
+}
@@ -0,0 +1,246 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/dissolve.h"
+
+#define H_BASE  20037508.34
+#define BLOB    4000
+
+static geohex_id_t ids[BLOB];
+
+static double ring_area(const loc_t *ring, size_t n)
+{
+    double area = 0;
+
+    /* shoelace in Web Mercator */
+    for (size_t i = 0; i < n; i++) {
+        const loc_t *a = &ring[i], *b = &ring[(i + 1) % n];
+        double ax = a->lon * H_BASE / 180.0, ay = log(tan((90.0 + a->lat) * M_PI / 360.0)) * (H_BASE / M_PI);
+        double bx = b->lon * H_BASE / 180.0, by = log(tan((90.0 + b->lat) * M_PI / 360.0)) * (H_BASE / M_PI);
+
+        area += ax * by - bx * ay;
+    }
+
+    return area / 2.0;
+}
+
+static double hex_area(uint32_t level)
+{
+    double h_size = H_BASE / pow(3.0, level + 3);
+
+    return 6.0 * sqrt(3.0) * h_size * h_size;
+}
+
+static size_t disk_ids(const loc_t *center, uint32_t level, uint32_t radius, geohex_id_t *out)
+{
+    xy_t xy, disk[GEOHEX_DISK_SIZE(8)];
+    size_t n;
+
+    get_xy_by_location(center, level, &xy);
+    n = get_xy_disk(&xy, level, radius, disk);
+    for (size_t i = 0; i < n; i++) {
+        get_id_by_xy(&disk[i], level, &out[i]);
+    }
+
+    return n;
+}
+
+/* outline edges are zone edges without a member on the far side */
+static size_t count_open_edges(const geohex_id_t *set, size_t n, uint32_t level)
+{
+    size_t open = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        xy_t xy, neighbors[6];
+
+        get_xy_by_id(set[i], &xy);
+        get_xy_neighbors(&xy, level, neighbors);
+        for (int k = 0; k < 6; k++) {
+            geohex_id_t id;
+            bool member = false;
+
+            get_id_by_xy(&neighbors[k], level, &id);
+            for (size_t j = 0; j < n && !member; j++) {
+                member = set[j] == id;
+            }
+            open += !member;
+        }
+    }
+
+    return open;
+}
+
+static void assert_outline(const geohex_outline_t *outline, size_t zones, uint32_t level, size_t open_edges)
+{
+    double area = 0;
+    size_t offset = 0;
+
+    TEST_ASSERT_EQUAL_size_t(open_edges, outline->vertex_count);
+    for (size_t r = 0; r < outline->rings; r++) {
+        const loc_t *ring = outline->vertices + offset;
+
+        TEST_ASSERT_TRUE(outline->ring_sizes[r] >= 6);
+        for (size_t i = 0; i < outline->ring_sizes[r]; i++) {
+            TEST_ASSERT_TRUE(fabs(ring[(i + 1) % outline->ring_sizes[r]].lon - ring[i].lon) < 10.0);
+        }
+        area += ring_area(ring, outline->ring_sizes[r]);
+        offset += outline->ring_sizes[r];
+    }
+    TEST_ASSERT_EQUAL_size_t(outline->vertex_count, offset);
+
+    /* holes run clockwise and subtract */
+    TEST_ASSERT_DOUBLE_WITHIN(hex_area(level) * 1e-6 * zones, hex_area(level) * zones, area);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_dissolve_single(void)
+{
+    loc_t tokyo = {139.7454, 35.6586};
+    geohex_outline_t outline;
+    zone_t zone;
+
+    disk_ids(&tokyo, 9, 0, ids);
+    TEST_ASSERT_TRUE(geohex_dissolve(ids, 1, &outline));
+    TEST_ASSERT_EQUAL_size_t(1, outline.rings);
+    TEST_ASSERT_EQUAL_size_t(6, outline.ring_sizes[0]);
+    assert_outline(&outline, 1, 9, 6);
+
+    /* every corner maps back into the zone or its neighbours, nudged inwards */
+    get_zone_by_id(ids[0], &zone);
+    for (size_t i = 0; i < 6; i++) {
+        loc_t inside = {
+            outline.vertices[i].lon + (zone.latlon.lon - outline.vertices[i].lon) * 0.01,
+            outline.vertices[i].lat + (zone.latlon.lat - outline.vertices[i].lat) * 0.01,
+        };
+        xy_t xy;
+        geohex_id_t id;
+
+        get_xy_by_location(&inside, 9, &xy);
+        get_id_by_xy(&xy, 9, &id);
+        TEST_ASSERT_TRUE(id == ids[0]);
+    }
+    geohex_outline_free(&outline);
+}
+
+void test_dissolve_disk_and_hole(void)
+{
+    loc_t london = {-0.1276, 51.5072};
+    geohex_outline_t outline;
+    size_t n = disk_ids(&london, 8, 3, ids);
+
+    TEST_ASSERT_TRUE(geohex_dissolve(ids, n, &outline));
+    TEST_ASSERT_EQUAL_size_t(1, outline.rings);
+    TEST_ASSERT_EQUAL_size_t(6 * 7, outline.ring_sizes[0]);
+    assert_outline(&outline, n, 8, 6 * 7);
+    geohex_outline_free(&outline);
+
+    /* drop the inner disk of radius 1: a ring with a hole */
+    TEST_ASSERT_TRUE(geohex_dissolve(ids + GEOHEX_DISK_SIZE(1), n - GEOHEX_DISK_SIZE(1), &outline));
+    TEST_ASSERT_EQUAL_size_t(2, outline.rings);
+    TEST_ASSERT_EQUAL_size_t(6 * 7 + 6 * 3, outline.vertex_count);
+    assert_outline(&outline, n - GEOHEX_DISK_SIZE(1), 8, 6 * 7 + 6 * 3);
+    geohex_outline_free(&outline);
+}
+
+void test_dissolve_blob(void)
+{
+    uint64_t seed = 11;
+    geohex_outline_t outline;
+    size_t n = 0;
+
+    /* overlapping disks, with duplicates, leave islands and holes */
+    while (n + GEOHEX_DISK_SIZE(4) <= BLOB) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        loc_t center = {135.0 + (double) (seed >> 40) / (1 << 24) * 0.3, 34.5 + (double) ((seed >> 16) & 0xffffff) / (1 << 24) * 0.3};
+
+        n += disk_ids(&center, 7, (uint32_t) (seed >> 62) + 1, ids + n);
+    }
+
+    size_t unique = 0;
+    for (size_t i = 0; i < n; i++) {
+        bool duplicate = false;
+
+        for (size_t j = 0; j < unique && !duplicate; j++) {
+            duplicate = ids[j] == ids[i];
+        }
+        if (!duplicate) {
+            ids[unique++] = ids[i];
+        }
+    }
+
+    TEST_ASSERT_TRUE(geohex_dissolve(ids, n, &outline));
+    TEST_ASSERT_TRUE(outline.rings > 1);
+    assert_outline(&outline, unique, 7, count_open_edges(ids, unique, 7));
+    geohex_outline_free(&outline);
+}
+
+void test_dissolve_antimeridian(void)
+{
+    geohex_outline_t outline;
+
+    for (uint32_t level = 3; level <= 9; level += 3) {
+        loc_t seam = {179.999, -16.7};
+        size_t n = disk_ids(&seam, level, 4, ids);
+
+        TEST_ASSERT_TRUE(geohex_dissolve(ids, n, &outline));
+        TEST_ASSERT_EQUAL_size_t(1, outline.rings);
+        assert_outline(&outline, n, level, 6 * 9);
+        geohex_outline_free(&outline);
+    }
+}
+
+void test_dissolve_invalid(void)
+{
+    loc_t tokyo = {139.7454, 35.6586};
+    geohex_outline_t outline;
+
+    TEST_ASSERT_TRUE(geohex_dissolve(NULL, 0, &outline));
+    TEST_ASSERT_EQUAL_size_t(0, outline.rings);
+    geohex_outline_free(&outline);
+
+    disk_ids(&tokyo, 9, 0, ids);
+    disk_ids(&tokyo, 10, 0, ids + 1);
+    TEST_ASSERT_FALSE(geohex_dissolve(ids, 2, &outline));
+    TEST_ASSERT_FALSE(geohex_dissolve(NULL, 2, &outline));
+    TEST_ASSERT_FALSE(geohex_dissolve(ids, 1, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_dissolve_single);
+    RUN_TEST(test_dissolve_disk_and_hole);
+    RUN_TEST(test_dissolve_blob);
+    RUN_TEST(test_dissolve_antimeridian);
+    RUN_TEST(test_dissolve_invalid);
+
+    return UNITY_END();
+}
@@ -0,0 +1,260 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/geofence.h"
+
+#define FENCES  5
+#define SAMPLES 20000
+#define H_BASE  20037508.34
+
+typedef struct {
+    loc_t vertices[16];
+    size_t ring_sizes[2];
+    size_t rings;
+} polygon_t;
+
+static polygon_t polygons[FENCES];
+static uint64_t seed;
+
+static double next_random(void)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double) (seed >> 11) / 9007199254740992.0;
+}
+
+static void mercator(const loc_t *loc, double *x, double *y)
+{
+    *x = loc->lon * H_BASE / 180.0;
+    *y = log(tan((90.0 + loc->lat) * M_PI / 360.0)) * (H_BASE / M_PI);
+}
+
+/* even-odd over every ring, straight edges in Web Mercator */
+static bool reference_contains(const polygon_t *polygon, const loc_t *loc)
+{
+    const loc_t *ring = polygon->vertices;
+    double x, y;
+    bool inside = false;
+
+    mercator(loc, &x, &y);
+
+    for (size_t r = 0; r < polygon->rings; r++) {
+        size_t n = polygon->ring_sizes[r];
+
+        for (size_t i = 0; i < n; i++) {
+            double ax, ay, bx, by;
+
+            mercator(&ring[i], &ax, &ay);
+            mercator(&ring[(i + 1) % n], &bx, &by);
+            if ((ay > y) != (by > y) && ax + (y - ay) * (bx - ax) / (by - ay) > x) {
+                inside = !inside;
+            }
+        }
+        ring += n;
+    }
+
+    return inside;
+}
+
+void setUp(void)
+{
+    polygon_t *p;
+
+    seed = 42;
+    memset(polygons, 0, sizeof(polygons));
+
+    /* concave star */
+    p = &polygons[0];
+    for (int i = 0; i < 10; i++) {
+        double angle = M_PI * i / 5.0, radius = i % 2 ? 0.04 : 0.1;
+
+        p->vertices[i].lon = 139.75 + radius * cos(angle);
+        p->vertices[i].lat = 35.68 + radius * sin(angle) * 0.8;
+    }
+    p->ring_sizes[0] = 10;
+    p->rings = 1;
+
+    /* square with a square hole */
+    p = &polygons[1];
+    p->vertices[0] = (loc_t) {139.60, 35.55};
+    p->vertices[1] = (loc_t) {139.90, 35.55};
+    p->vertices[2] = (loc_t) {139.90, 35.80};
+    p->vertices[3] = (loc_t) {139.60, 35.80};
+    p->vertices[4] = (loc_t) {139.70, 35.62};
+    p->vertices[5] = (loc_t) {139.70, 35.72};
+    p->vertices[6] = (loc_t) {139.80, 35.72};
+    p->vertices[7] = (loc_t) {139.80, 35.62};
+    p->ring_sizes[0] = 4;
+    p->ring_sizes[1] = 4;
+    p->rings = 2;
+
+    /* thin sliver crossing the others */
+    p = &polygons[2];
+    p->vertices[0] = (loc_t) {139.56, 35.52};
+    p->vertices[1] = (loc_t) {139.94, 35.88};
+    p->vertices[2] = (loc_t) {139.93, 35.885};
+    p->ring_sizes[0] = 3;
+    p->rings = 1;
+
+    /* smaller than a single zone */
+    p = &polygons[3];
+    p->vertices[0] = (loc_t) {139.701, 35.701};
+    p->vertices[1] = (loc_t) {139.704, 35.701};
+    p->vertices[2] = (loc_t) {139.7025, 35.703};
+    p->ring_sizes[0] = 3;
+    p->rings = 1;
+
+    /* touching the antimeridian */
+    p = &polygons[4];
+    p->vertices[0] = (loc_t) {179.9, 10.0};
+    p->vertices[1] = (loc_t) {180.0, 10.0};
+    p->vertices[2] = (loc_t) {180.0, 10.1};
+    p->vertices[3] = (loc_t) {179.9, 10.1};
+    p->ring_sizes[0] = 4;
+    p->rings = 1;
+}
+
+void tearDown(void)
+{
+}
+
+static geohex_geofence_t *build(uint32_t level)
+{
+    geohex_geofence_t *fence = geohex_geofence_create(level);
+    uint32_t id;
+
+    TEST_ASSERT_NOT_NULL(fence);
+    for (uint32_t i = 0; i < FENCES; i++) {
+        TEST_ASSERT_TRUE(geohex_geofence_add(fence, polygons[i].vertices, polygons[i].ring_sizes, polygons[i].rings, &id));
+        TEST_ASSERT_EQUAL_UINT32(i, id);
+    }
+    TEST_ASSERT_TRUE(geohex_geofence_compile(fence));
+
+    return fence;
+}
+
+static void assert_matches_reference(const geohex_geofence_t *fence, const loc_t *loc)
+{
+    uint32_t found_ids[FENCES];
+    size_t found, expected = 0;
+
+    TEST_ASSERT_TRUE(geohex_geofence_query(fence, loc, found_ids, FENCES, &found));
+    for (uint32_t i = 0; i < FENCES; i++) {
+        if (reference_contains(&polygons[i], loc)) {
+            TEST_ASSERT_TRUE(expected < found);
+            TEST_ASSERT_EQUAL_UINT32(i, found_ids[expected]);
+            expected++;
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(expected, found);
+}
+
+void test_geofence_query(void)
+{
+    for (uint32_t level = 5; level <= 8; level++) {
+        geohex_geofence_t *fence = build(level);
+
+        for (uint32_t i = 0; i < SAMPLES; i++) {
+            loc_t loc = {139.55 + 0.4 * next_random(), 35.5 + 0.4 * next_random()};
+
+            assert_matches_reference(fence, &loc);
+        }
+
+        for (uint32_t i = 0; i < SAMPLES / 10; i++) {
+            loc_t tiny = {139.7005 + 0.004 * next_random(), 35.7005 + 0.003 * next_random()};
+            loc_t seam = {179.85 + 0.15 * next_random(), 9.95 + 0.2 * next_random()};
+            loc_t wrapped = {-180.0 + 0.05 * next_random(), 9.95 + 0.2 * next_random()};
+
+            assert_matches_reference(fence, &tiny);
+            assert_matches_reference(fence, &seam);
+            assert_matches_reference(fence, &wrapped);
+        }
+
+        geohex_geofence_destroy(fence);
+    }
+}
+
+void test_geofence_query_batch(void)
+{
+    geohex_geofence_t *fence = build(7);
+    double *lon = malloc(SAMPLES * sizeof(double));
+    double *lat = malloc(SAMPLES * sizeof(double));
+    uint32_t *out = malloc(SAMPLES * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        lon[i] = 139.55 + 0.4 * next_random();
+        lat[i] = 35.5 + 0.4 * next_random();
+    }
+
+    TEST_ASSERT_TRUE(geohex_geofence_query_batch(fence, lon, lat, SAMPLES, out));
+
+    for (uint32_t i = 0; i < SAMPLES; i++) {
+        loc_t loc = {lon[i], lat[i]};
+        uint32_t expected = GEOHEX_GEOFENCE_NONE;
+
+        for (uint32_t f = 0; f < FENCES && expected == GEOHEX_GEOFENCE_NONE; f++) {
+            if (reference_contains(&polygons[f], &loc)) {
+                expected = f;
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT32(expected, out[i]);
+    }
+
+    free(out);
+    free(lat);
+    free(lon);
+    geohex_geofence_destroy(fence);
+}
+
+void test_geofence_invalid(void)
+{
+    geohex_geofence_t *fence = geohex_geofence_create(7);
+    loc_t inside = {139.65, 35.58};
+    size_t ring_size = 2, found;
+    uint32_t id, out;
+
+    TEST_ASSERT_NULL(geohex_geofence_create(MAX_LEVEL + 1));
+    TEST_ASSERT_FALSE(geohex_geofence_add(fence, polygons[0].vertices, &ring_size, 1, &id));
+    TEST_ASSERT_TRUE(geohex_geofence_add(fence, polygons[1].vertices, polygons[1].ring_sizes, 2, &id));
+    TEST_ASSERT_FALSE(geohex_geofence_query(fence, &inside, &out, 1, &found));
+
+    TEST_ASSERT_TRUE(geohex_geofence_compile(fence));
+    TEST_ASSERT_FALSE(geohex_geofence_compile(fence));
+    TEST_ASSERT_FALSE(geohex_geofence_add(fence, polygons[1].vertices, polygons[1].ring_sizes, 2, &id));
+
+    TEST_ASSERT_FALSE(geohex_geofence_query(fence, &inside, NULL, 0, &found));
+    TEST_ASSERT_EQUAL_size_t(1, found);
+    TEST_ASSERT_TRUE(geohex_geofence_query(fence, &inside, &out, 1, &found));
+    TEST_ASSERT_EQUAL_UINT32(0, out);
+
+    geohex_geofence_destroy(fence);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_geofence_query);
+    RUN_TEST(test_geofence_query_batch);
+    RUN_TEST(test_geofence_invalid);
+
+    return UNITY_END();
+}
@@ -88,6 +88,124 @@ void test_get_xy_by_location(void)
     }
 }
 
+void test_get_xy_by_mercator(void)
+{
+    enum { N = sizeof(coord2hex_data) / sizeof(coord2hex_data[0]) };
+    static double dx[N], dy[N];
+    static xy_t batch[N];
+
+    for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+        for (uint32_t i = 0; i < N; i++) {
+            loc_t loc = {
+                .lat = coord2hex_data[i].lat,
+                .lon = coord2hex_data[i].lon,
+            };
+            xy_t expected, out;
+            zone_t zone;
+            double cx, cy, lon, lat;
+
+            loc2xy(loc.lon, loc.lat, &dx[i], &dy[i]);
+            TEST_ASSERT_TRUE(get_xy_by_location(&loc, level, &expected));
+            TEST_ASSERT_TRUE(get_xy_by_mercator(dx[i], dy[i], level, &out));
+            TEST_ASSERT_EQUAL_INT32(expected.x, out.x);
+            TEST_ASSERT_EQUAL_INT32(expected.y, out.y);
+            TEST_ASSERT_EQUAL(expected.rev, out.rev);
+
+            /* the centre in meters projects back to the zone centre */
+            TEST_ASSERT_TRUE(get_mercator_center_by_xy(&out, level, &cx, &cy));
+            TEST_ASSERT_TRUE(get_zone_by_xy(&out, level, &zone));
+            xy2loc(cx, cy, &lon, &lat);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, zone.latlon.lon, lon);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, zone.latlon.lat, lat);
+        }
+
+        TEST_ASSERT_TRUE(get_xys_by_mercator(dx, dy, N, level, batch));
+        TEST_ASSERT_TRUE(get_mercator_centers_by_xys(batch, N, level, dx, dy));
+        for (uint32_t i = 0; i < N; i++) {
+            double cx, cy;
+
+            get_mercator_center_by_xy(&batch[i], level, &cx, &cy);
+            TEST_ASSERT_EQUAL_DOUBLE(cx, dx[i]);
+            TEST_ASSERT_EQUAL_DOUBLE(cy, dy[i]);
+        }
+    }
+
+    /*
+     * A zone centred on the antimeridian given from the east, x - y equal to
+     * the period, reports lon -180; its centre must sit on that side too.
+     */
+    for (uint32_t level = 0, period = 9; level <= MAX_LEVEL; level++, period *= 3) {
+        xy_t seam = {(int32_t) (period + 1) / 2, (int32_t) (1 - (int64_t) period) / 2, false};
+        zone_t zone;
+        double cx, cy, lon, lat;
+
+        TEST_ASSERT_TRUE(get_zone_by_xy(&seam, level, &zone));
+        TEST_ASSERT_EQUAL_DOUBLE(-180.0, zone.latlon.lon);
+        TEST_ASSERT_TRUE(get_mercator_center_by_xy(&seam, level, &cx, &cy));
+        xy2loc(cx, cy, &lon, &lat);
+        TEST_ASSERT_DOUBLE_WITHIN(1e-9, zone.latlon.lon, lon);
+        TEST_ASSERT_DOUBLE_WITHIN(1e-9, zone.latlon.lat, lat);
+        TEST_ASSERT_TRUE(get_mercator_centers_by_xys(&seam, 1, level, dx, dy));
+        TEST_ASSERT_EQUAL_DOUBLE(cx, dx[0]);
+        TEST_ASSERT_EQUAL_DOUBLE(cy, dy[0]);
+    }
+
+    xy_t out = {0, 0, false};
+    double cx, cy;
+
+    TEST_ASSERT_FALSE(get_xy_by_mercator(0, 0, MAX_LEVEL + 1, &out));
+    TEST_ASSERT_FALSE(get_xy_by_mercator(0, 0, 0, NULL));
+    TEST_ASSERT_FALSE(get_mercator_center_by_xy(&out, MAX_LEVEL + 1, &cx, &cy));
+    TEST_ASSERT_FALSE(get_mercator_center_by_xy(NULL, 0, &cx, &cy));
+    TEST_ASSERT_FALSE(get_xys_by_mercator(NULL, dy, 1, 0, batch));
+    TEST_ASSERT_FALSE(get_mercator_centers_by_xys(batch, 1, 0, dx, NULL));
+    TEST_ASSERT_TRUE(get_xys_by_mercator(NULL, NULL, 0, 0, NULL));
+}
+
+void test_get_xys_by_e7(void)
+{
+    enum { N = 1000 };
+    static int32_t lon_e7[N], lat_e7[N];
+    static xy_t xys[N];
+    static geohex_id_t ids[N];
+    uint32_t seed = 7;
+
+    for (uint32_t i = 0; i < N; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        lon_e7[i] = (int32_t) ((int64_t) (seed % 3600000001u) - 1800000000);
+        seed = seed * 1664525u + 1013904223u;
+        lat_e7[i] = (int32_t) ((int64_t) (seed % 1700000001u) - 850000000);
+    }
+    lon_e7[0] = 1800000000;
+    lon_e7[1] = -1800000000;
+    lat_e7[2] = 0;
+
+    for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+        /* a count that leaves a partial block */
+        TEST_ASSERT_TRUE(get_xys_by_e7(lon_e7, lat_e7, N - 3, level, xys));
+        TEST_ASSERT_TRUE(get_ids_by_e7(lon_e7, lat_e7, N - 3, level, ids));
+
+        for (uint32_t i = 0; i < N - 3; i++) {
+            loc_t loc = {(double) lon_e7[i] / 1e7, (double) lat_e7[i] / 1e7};
+            xy_t expected;
+            geohex_id_t id;
+
+            TEST_ASSERT_TRUE(get_xy_by_location(&loc, level, &expected));
+            TEST_ASSERT_EQUAL_INT32(expected.x, xys[i].x);
+            TEST_ASSERT_EQUAL_INT32(expected.y, xys[i].y);
+            TEST_ASSERT_EQUAL(expected.rev, xys[i].rev);
+            TEST_ASSERT_TRUE(get_id_by_xy(&expected, level, &id));
+            TEST_ASSERT_TRUE(id == ids[i]);
+        }
+    }
+
+    TEST_ASSERT_FALSE(get_xys_by_e7(lon_e7, lat_e7, N, MAX_LEVEL + 1, xys));
+    TEST_ASSERT_FALSE(get_xys_by_e7(NULL, lat_e7, N, 0, xys));
+    TEST_ASSERT_FALSE(get_ids_by_e7(lon_e7, NULL, N, 0, ids));
+    TEST_ASSERT_FALSE(get_ids_by_e7(lon_e7, lat_e7, N, 0, NULL));
+    TEST_ASSERT_TRUE(get_ids_by_e7(NULL, NULL, 0, 0, NULL));
+}
+
 void test_get_zone_by_xy(void)
 {
     zone_t out;
@@ -151,6 +269,178 @@ void test_get_zone_by_code(void)
     }
 }
 
+static void assert_fast_zone(const zone_t *exact, const zone_t *fast)
+{
+    TEST_ASSERT_EQUAL_STRING(exact->code, fast->code);
+    TEST_ASSERT_EQUAL_INT32(exact->xy.x, fast->xy.x);
+    TEST_ASSERT_EQUAL_INT32(exact->xy.y, fast->xy.y);
+    TEST_ASSERT_EQUAL(exact->xy.rev, fast->xy.rev);
+    TEST_ASSERT_EQUAL_DOUBLE(exact->latlon.lon, fast->latlon.lon);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-10, exact->latlon.lat, fast->latlon.lat);
+}
+
+void test_get_zone_by_code_fast(void)
+{
+    static const char key[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    zone_t exact, fast;
+
+    for (uint32_t i = 0; i < (sizeof(code2hex_data) / sizeof(code2hex_data[0])); i++) {
+        TEST_ASSERT_TRUE(get_zone_by_code(code2hex_data[i].code, &exact));
+        TEST_ASSERT_TRUE(get_zone_by_code_fast(code2hex_data[i].code, &fast));
+        assert_fast_zone(&exact, &fast);
+    }
+
+    /* every code of the low levels decodes as get_xy_by_code() reads it */
+    for (uint32_t level = 0; level <= 2; level++) {
+        uint32_t count = 729;
+
+        for (uint32_t i = 0; i < level; i++) {
+            count *= 9;
+        }
+        for (uint32_t n = 0; n < count; n++) {
+            geohex_code_t code;
+            uint32_t digits = n, h_1_int = 0;
+
+            for (int32_t i = (int32_t) level + 1; i >= 2; i--) {
+                code[i] = (char) ('0' + digits % 9);
+                digits /= 9;
+            }
+            for (uint32_t i = 0, scale = 1; i < 3; i++, scale *= 10) {
+                h_1_int += digits % 9 * scale;
+                digits /= 9;
+            }
+            code[0] = key[h_1_int / 30];
+            code[1] = key[h_1_int % 30];
+            code[level + 2] = '\0';
+
+            TEST_ASSERT_TRUE(get_zone_by_code(code, &exact));
+            TEST_ASSERT_TRUE(get_zone_by_code_fast(code, &fast));
+            assert_fast_zone(&exact, &fast);
+        }
+    }
+
+    /* rows from pole to pole, past the end of the table too */
+    for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+        int64_t digits = 1;
+
+        for (uint32_t i = 0; i < level + 3; i++) {
+            digits *= 3;
+        }
+        int32_t limit = (int32_t) ((digits - 1) / 2);
+
+        for (int32_t step = 0; step <= 2000; step++) {
+            int32_t sum = (int32_t) ((int64_t) (4 * (int64_t) limit) * step / 2000 - 2 * (int64_t) limit);
+            xy_t xy = {sum / 2, sum - sum / 2, false};
+
+            TEST_ASSERT_TRUE(get_zone_by_xy(&xy, level, &exact));
+            TEST_ASSERT_TRUE(get_zone_by_xy_fast(&xy, level, &fast));
+            assert_fast_zone(&exact, &fast);
+        }
+    }
+
+    xy_t far = {1 << 29, 1 << 29, false};
+
+    TEST_ASSERT_TRUE(get_zone_by_xy(&far, 0, &exact));
+    TEST_ASSERT_TRUE(get_zone_by_xy_fast(&far, 0, &fast));
+    assert_fast_zone(&exact, &fast);
+
+    const geohex_code_t codes[] = {"XM", "XM4880", "OL3362"}, invalid[] = {"X", "XM9", "X-1"};
+    zone_t batch[3];
+
+    TEST_ASSERT_TRUE(get_zones_by_codes_fast(codes, 3, batch));
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(get_zone_by_code(codes[i], &exact));
+        assert_fast_zone(&exact, &batch[i]);
+    }
+    for (uint32_t i = 0; i < (sizeof(invalid) / sizeof(invalid[0])); i++) {
+        TEST_ASSERT_FALSE(get_zone_by_code_fast(invalid[i], &fast));
+    }
+    TEST_ASSERT_FALSE(get_zone_by_code_fast(NULL, &fast));
+}
+
+void test_get_id_by_code(void)
+{
+    geohex_id_t id;
+    geohex_code_t code;
+
+    for (uint32_t i = 0; i < (sizeof(code2hex_data) / sizeof(code2hex_data[0])); i++) {
+        TEST_ASSERT_TRUE(get_id_by_code(code2hex_data[i].code, &id));
+        TEST_ASSERT_EQUAL_UINT32(strlen(code2hex_data[i].code) - 2, get_level_by_id(id));
+        TEST_ASSERT_TRUE(get_code_by_id(id, code));
+        TEST_ASSERT_EQUAL_STRING(code2hex_data[i].code, code);
+    }
+
+    /* "AT" and "aK" decode to prefixes 19 and 790, which hold a digit 9 */
+    geohex_code_t invalid[] = {"X", "XM9", "X-1", "AT", "aK1"};
+    for (uint32_t i = 0; i < (sizeof(invalid) / sizeof(invalid[0])); i++) {
+        TEST_ASSERT_FALSE(get_id_by_code(invalid[i], &id));
+    }
+    TEST_ASSERT_FALSE(get_code_by_id(GEOHEX_ID_INVALID, code));
+}
+
+void test_get_id_by_xy(void)
+{
+    geohex_id_t id, expected;
+
+    for (uint32_t i = 0; i < (sizeof(xy2hex_data) / sizeof(xy2hex_data[0])); i++) {
+        xy_t xy = {
+            .x = xy2hex_data[i].x,
+            .y = xy2hex_data[i].y,
+            .rev = false,
+        };
+
+        TEST_ASSERT_TRUE(get_id_by_xy(&xy, xy2hex_data[i].level, &id));
+        TEST_ASSERT_TRUE(get_id_by_code(xy2hex_data[i].code, &expected));
+        TEST_ASSERT_EQUAL_UINT64(expected, id);
+    }
+}
+
+void test_get_zone_by_id(void)
+{
+    geohex_id_t id;
+    zone_t expected, out;
+
+    for (uint32_t i = 0; i < (sizeof(code2hex_data) / sizeof(code2hex_data[0])); i++) {
+        TEST_ASSERT_TRUE(get_id_by_code(code2hex_data[i].code, &id));
+        TEST_ASSERT_TRUE(get_zone_by_id(id, &out));
+        TEST_ASSERT_TRUE(get_zone_by_code(code2hex_data[i].code, &expected));
+        TEST_ASSERT_EQUAL_STRING(expected.code, out.code);
+        TEST_ASSERT_EQUAL_INT32(expected.xy.x, out.xy.x);
+        TEST_ASSERT_EQUAL_INT32(expected.xy.y, out.xy.y);
+    }
+}
+
+void test_get_parent_id(void)
+{
+    geohex_id_t id, parent, prev = 0;
+    geohex_code_t code;
+    char prefix[MAX_CODE_LEN];
+
+    for (uint32_t i = 0; i < (sizeof(code2hex_data) / sizeof(code2hex_data[0])); i++) {
+        uint32_t level = strlen(code2hex_data[i].code) - 2;
+
+        TEST_ASSERT_TRUE(get_id_by_code(code2hex_data[i].code, &id));
+
+        for (uint32_t l = 0; l <= level; l++) {
+            TEST_ASSERT_TRUE(get_parent_id(id, l, &parent));
+            TEST_ASSERT_TRUE(get_code_by_id(parent, code));
+
+            memcpy(prefix, code2hex_data[i].code, l + 2);
+            prefix[l + 2] = '\0';
+            TEST_ASSERT_EQUAL_STRING(prefix, code);
+            TEST_ASSERT_TRUE(parent <= id);
+        }
+
+        TEST_ASSERT_FALSE(get_parent_id(id, level + 1, &parent));
+
+        if (i > 0) {
+            int cmp = strcmp(code2hex_data[i - 1].code, code2hex_data[i].code);
+            TEST_ASSERT_TRUE((cmp < 0) == (prev < id));
+        }
+        prev = id;
+    }
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -161,10 +451,18 @@ int main(void)
 
     RUN_TEST(test_adjust_xy);
     RUN_TEST(test_get_xy_by_location);
+    RUN_TEST(test_get_xy_by_mercator);
+    RUN_TEST(test_get_xys_by_e7);
     RUN_TEST(test_get_zone_by_xy);
     RUN_TEST(test_get_xy_by_code);
     RUN_TEST(test_get_zone_by_location);
     RUN_TEST(test_get_zone_by_code);
+    RUN_TEST(test_get_zone_by_code_fast);
+
+    RUN_TEST(test_get_id_by_code);
+    RUN_TEST(test_get_id_by_xy);
+    RUN_TEST(test_get_zone_by_id);
+    RUN_TEST(test_get_parent_id);
 
     return UNITY_END();
 }
@@ -0,0 +1,262 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/grid.h"
+
+#define H_BASE      20037508.34
+#define MAX_ZONES   65536
+
+typedef struct {
+    uint32_t level;
+    int32_t x_min;
+    int32_t x_max;
+    int32_t x;
+    int32_t y;
+    size_t n;
+    size_t blocks;
+} walk_t;
+
+typedef struct {
+    geohex_id_t ids[MAX_ZONES];
+    size_t n;
+} zones_t;
+
+static zones_t found;
+
+static void expect_zone(const zone_t *zone, int32_t x, int32_t y, uint32_t level)
+{
+    xy_t origin = {0, 0, false}, xy;
+    ij_t ij = {x, y};
+    zone_t expected;
+
+    TEST_ASSERT_TRUE(get_xy_by_local_ij(&origin, &ij, level, &xy));
+    TEST_ASSERT_TRUE(get_zone_by_xy(&xy, level, &expected));
+    TEST_ASSERT_EQUAL_STRING(expected.code, zone->code);
+    TEST_ASSERT_EQUAL_INT32(expected.xy.x, zone->xy.x);
+    TEST_ASSERT_EQUAL_INT32(expected.xy.y, zone->xy.y);
+    TEST_ASSERT_EQUAL(expected.xy.rev, zone->xy.rev);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, expected.latlon.lat, zone->latlon.lat);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, expected.latlon.lon, zone->latlon.lon);
+}
+
+static void check_walk(void *arg, const zone_t *zones, size_t n)
+{
+    walk_t *w = arg;
+
+    TEST_ASSERT_TRUE(n > 0);
+    for (size_t i = 0; i < n; i++) {
+        expect_zone(&zones[i], w->x, w->y, w->level);
+        if (w->x++ == w->x_max) {
+            w->x = w->x_min;
+            w->y++;
+        }
+    }
+    w->n += n;
+    w->blocks++;
+}
+
+static void collect(void *arg, const zone_t *zones, size_t n)
+{
+    zones_t *z = arg;
+
+    TEST_ASSERT_TRUE(z->n + n <= MAX_ZONES);
+    for (size_t i = 0; i < n; i++) {
+        zone_t check;
+
+        /* the zone must be exactly what its code decodes to */
+        TEST_ASSERT_TRUE(get_zone_by_code(zones[i].code, &check));
+        TEST_ASSERT_EQUAL_INT32(check.xy.x, zones[i].xy.x);
+        TEST_ASSERT_EQUAL_INT32(check.xy.y, zones[i].xy.y);
+        TEST_ASSERT_TRUE(get_id_by_code(zones[i].code, &z->ids[z->n++]));
+    }
+}
+
+static int compare_id(const void *a, const void *b)
+{
+    geohex_id_t ia = *(const geohex_id_t *) a, ib = *(const geohex_id_t *) b;
+
+    return (ia > ib) - (ia < ib);
+}
+
+static void run_rect(int32_t x_min, int32_t y_min, int32_t x_max, int32_t y_max, uint32_t level)
+{
+    walk_t w = {level, x_min, x_max, x_min, y_min, 0, 0};
+
+    TEST_ASSERT_TRUE(geohex_grid_rect(x_min, y_min, x_max, y_max, level, check_walk, &w));
+    TEST_ASSERT_EQUAL_size_t((size_t) (x_max - x_min + 1) * (size_t) (y_max - y_min + 1), w.n);
+    TEST_ASSERT_EQUAL_INT32(y_max + 1, w.y);
+}
+
+static void base_of(const loc_t *loc, uint32_t level, int32_t *x, int32_t *y)
+{
+    xy_t origin = {0, 0, false}, xy;
+    ij_t ij;
+
+    get_xy_by_location(loc, level, &xy);
+    get_local_ij(&origin, &xy, level, &ij);
+    *x = ij.i;
+    *y = ij.j;
+}
+
+static bool inside(const loc_t *vertices, const size_t *ring_sizes, size_t rings, const loc_t *point)
+{
+    double px = point->lon * H_BASE / 180.0;
+    double py = log(tan((90.0 + point->lat) * M_PI / 360.0)) * (H_BASE / M_PI);
+    bool in = false;
+
+    for (size_t r = 0, start = 0; r < rings; start += ring_sizes[r++]) {
+        for (size_t i = 0; i < ring_sizes[r]; i++) {
+            const loc_t *a = &vertices[start + i], *b = &vertices[start + (i + 1) % ring_sizes[r]];
+            double ax = a->lon * H_BASE / 180.0, bx = b->lon * H_BASE / 180.0;
+            double ay = log(tan((90.0 + a->lat) * M_PI / 360.0)) * (H_BASE / M_PI);
+            double by = log(tan((90.0 + b->lat) * M_PI / 360.0)) * (H_BASE / M_PI);
+
+            if ((ay > py) != (by > py) && px < ax + (py - ay) * (bx - ax) / (by - ay)) {
+                in = !in;
+            }
+        }
+    }
+
+    return in;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_grid_rect(void)
+{
+    loc_t tokyo = {139.7671, 35.6812};
+
+    for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+        int32_t x, y;
+
+        base_of(&tokyo, level, &x, &y);
+        run_rect(x - 20, y - 15, x + 25, y + 10, level);
+    }
+
+    /* the southern hemisphere and a west longitude */
+    loc_t santiago = {-70.6693, -33.4489};
+    int32_t x, y;
+
+    base_of(&santiago, 10, &x, &y);
+    run_rect(x - 100, y - 100, x + 100, y + 100, 10);
+}
+
+void test_grid_antimeridian(void)
+{
+    for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+        for (double lat = -70.0; lat <= 70.0; lat += 35.0) {
+            loc_t seam = {180.0, lat};
+            int32_t x, y;
+
+            base_of(&seam, level, &x, &y);
+            run_rect(x - 12, y - 12, x + 12, y + 12, level);
+        }
+    }
+
+    /* wider than the globe, and out to the poles where the codes run out */
+    run_rect(-40, -40, 40, 40, 0);
+    run_rect(-100, -3, 100, 3, 1);
+}
+
+void test_grid_polygon(void)
+{
+    static const loc_t vertices[] = {
+        /* the outline */
+        {139.70, 35.64}, {139.80, 35.65}, {139.82, 35.72}, {139.76, 35.74}, {139.72, 35.71},
+        /* a hole */
+        {139.75, 35.67}, {139.78, 35.68}, {139.76, 35.70},
+    };
+    static const size_t ring_sizes[] = {5, 3};
+
+    for (uint32_t level = 5; level <= 9; level++) {
+        loc_t center = {139.76, 35.69};
+        xy_t xy, *disk;
+        size_t n, expected = 0;
+        uint32_t radius = 3;
+
+        found.n = 0;
+        TEST_ASSERT_TRUE(geohex_grid_polygon(vertices, ring_sizes, 2, level, collect, &found));
+        qsort(found.ids, found.n, sizeof(geohex_id_t), compare_id);
+        for (size_t i = 1; i < found.n; i++) {
+            TEST_ASSERT_TRUE(found.ids[i - 1] != found.ids[i]);
+        }
+
+        /* a disk reaching past the polygon holds exactly the same centres */
+        while (3.0 * radius * H_BASE / pow(3.0, level + 3) < 20000.0) {
+            radius++;
+        }
+        disk = malloc(GEOHEX_DISK_SIZE(radius) * sizeof(xy_t));
+        TEST_ASSERT_NOT_NULL(disk);
+        get_xy_by_location(&center, level, &xy);
+        n = get_xy_disk(&xy, level, radius, disk);
+        for (size_t i = 0; i < n; i++) {
+            zone_t zone;
+            geohex_id_t id;
+
+            get_zone_by_xy(&disk[i], level, &zone);
+            get_id_by_xy(&disk[i], level, &id);
+            bool in = inside(vertices, ring_sizes, 2, &zone.latlon);
+
+            TEST_ASSERT_EQUAL(in, bsearch(&id, found.ids, found.n, sizeof(geohex_id_t), compare_id) != NULL);
+            expected += in;
+        }
+        TEST_ASSERT_EQUAL_size_t(expected, found.n);
+        free(disk);
+    }
+}
+
+void test_grid_invalid(void)
+{
+    static const loc_t vertices[] = {{0, 0}, {1, 0}, {1, 1}};
+    static const loc_t pole[] = {{0, 0}, {1, 0}, {1, 90}};
+    size_t three = 3, two = 2;
+    walk_t w = {0};
+
+    TEST_ASSERT_FALSE(geohex_grid_rect(0, 0, 1, 1, 0, NULL, &w));
+    TEST_ASSERT_FALSE(geohex_grid_rect(0, 0, 1, 1, MAX_LEVEL + 1, check_walk, &w));
+    TEST_ASSERT_FALSE(geohex_grid_rect(1, 0, 0, 1, 0, check_walk, &w));
+    TEST_ASSERT_FALSE(geohex_grid_polygon(NULL, &three, 1, 5, collect, &found));
+    TEST_ASSERT_FALSE(geohex_grid_polygon(vertices, &two, 1, 5, collect, &found));
+    TEST_ASSERT_FALSE(geohex_grid_polygon(vertices, &three, 0, 5, collect, &found));
+    TEST_ASSERT_FALSE(geohex_grid_polygon(vertices, &three, 1, 5, NULL, &found));
+    TEST_ASSERT_FALSE(geohex_grid_polygon(pole, &three, 1, 5, collect, &found));
+    TEST_ASSERT_EQUAL_size_t(0, w.n);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_grid_rect);
+    RUN_TEST(test_grid_antimeridian);
+    RUN_TEST(test_grid_polygon);
+    RUN_TEST(test_grid_invalid);
+
+    return UNITY_END();
+}
@@ -0,0 +1,174 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/index.h"
+
+#include "json_data.h"
+
+#define CODES   (sizeof(code2hex_data) / sizeof(code2hex_data[0]))
+#define DENSE   5000
+
+static const geohex_code_t dense_base = "XM488548768";
+static char path[] = "/tmp/geohex_index_XXXXXX";
+static geohex_index_entry_t *entries;
+static uint32_t *values;
+static size_t n;
+
+void setUp(void)
+{
+    int fd = mkstemp(path);
+    geohex_id_t base;
+
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+
+    entries = malloc((CODES + DENSE) * sizeof(geohex_index_entry_t));
+    values = malloc((CODES + DENSE) * sizeof(uint32_t));
+    n = 0;
+
+    /* the code fixtures repeat; keep the first of each */
+    for (uint32_t i = 0; i < CODES; i++) {
+        geohex_id_t id;
+        bool seen = false;
+
+        if (!get_id_by_code(code2hex_data[i].code, &id)) {
+            continue;
+        }
+        for (size_t j = 0; j < n && !seen; j++) {
+            seen = entries[j].id == id;
+        }
+        if (!seen) {
+            values[n] = i;
+            entries[n].id = id;
+            entries[n].data = code2hex_data[i].code;
+            entries[n].size = strlen(code2hex_data[i].code) + 1;
+            n++;
+        }
+    }
+
+    get_id_by_code(dense_base, &base);
+    for (uint32_t i = 0; i < DENSE; i++) {
+        values[n] = i;
+        entries[n].id = base + ((geohex_id_t) (i * 2) * 531441 << GEOHEX_ID_LEVEL_BITS);
+        entries[n].data = &values[n];
+        entries[n].size = i % 7 == 0 ? 0 : sizeof(uint32_t);
+        n++;
+    }
+}
+
+void tearDown(void)
+{
+    unlink(path);
+    strcpy(path, "/tmp/geohex_index_XXXXXX");
+    free(values);
+    free(entries);
+}
+
+void test_index_lookup(void)
+{
+    geohex_index_t *index;
+    const void *data;
+    size_t size;
+    geohex_id_t base;
+
+    TEST_ASSERT_TRUE(geohex_index_write(path, entries, n));
+    index = geohex_index_open(path);
+    TEST_ASSERT_NOT_NULL(index);
+    TEST_ASSERT_EQUAL_size_t(n, geohex_index_size(index));
+
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_TRUE(geohex_index_lookup_id(index, entries[i].id, &data, &size));
+        TEST_ASSERT_EQUAL_size_t(entries[i].size, size);
+        if (size) {
+            TEST_ASSERT_EQUAL_MEMORY(entries[i].data, data, size);
+        }
+    }
+
+    for (uint32_t i = 0; i < CODES; i++) {
+        zone_t zone;
+
+        if (!get_zone_by_code(code2hex_data[i].code, &zone)) {
+            continue;
+        }
+        TEST_ASSERT_TRUE(geohex_index_lookup(index, code2hex_data[i].code, &data, &size));
+        TEST_ASSERT_EQUAL_STRING(code2hex_data[i].code, (const char *) data);
+        TEST_ASSERT_TRUE(geohex_index_lookup_xy(index, &zone.xy, (uint32_t) strlen(zone.code) - 2, &data, &size));
+        TEST_ASSERT_EQUAL_STRING(code2hex_data[i].code, (const char *) data);
+    }
+
+    /* the gaps between the dense ids are absent */
+    get_id_by_code(dense_base, &base);
+    for (uint32_t i = 0; i < DENSE; i++) {
+        geohex_id_t id = base + ((geohex_id_t) (i * 2 + 1) * 531441 << GEOHEX_ID_LEVEL_BITS);
+
+        TEST_ASSERT_FALSE(geohex_index_lookup_id(index, id, &data, &size));
+    }
+    TEST_ASSERT_FALSE(geohex_index_lookup_id(index, 0, &data, &size));
+    TEST_ASSERT_FALSE(geohex_index_lookup_id(index, GEOHEX_ID_INVALID, &data, &size));
+
+    geohex_index_close(index);
+}
+
+void test_index_invalid(void)
+{
+    geohex_index_t *index;
+    const void *data;
+    size_t size;
+    FILE *fp;
+
+    entries[1].id = entries[0].id;
+    TEST_ASSERT_FALSE(geohex_index_write(path, entries, n));
+
+    TEST_ASSERT_TRUE(geohex_index_write(path, entries, 0));
+    index = geohex_index_open(path);
+    TEST_ASSERT_NOT_NULL(index);
+    TEST_ASSERT_EQUAL_size_t(0, geohex_index_size(index));
+    TEST_ASSERT_FALSE(geohex_index_lookup_id(index, entries[0].id, &data, &size));
+    geohex_index_close(index);
+
+    /* truncated file */
+    TEST_ASSERT_TRUE(geohex_index_write(path, entries + 1, n - 1));
+    TEST_ASSERT_EQUAL_INT(0, truncate(path, 200));
+    TEST_ASSERT_NULL(geohex_index_open(path));
+
+    /* bad magic */
+    TEST_ASSERT_TRUE(geohex_index_write(path, entries + 1, n - 1));
+    fp = fopen(path, "r+b");
+    TEST_ASSERT_NOT_NULL(fp);
+    fputs("XXXX", fp);
+    fclose(fp);
+    TEST_ASSERT_NULL(geohex_index_open(path));
+
+    TEST_ASSERT_NULL(geohex_index_open("/nonexistent/geohex.idx"));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_index_lookup);
+    RUN_TEST(test_index_invalid);
+
+    return UNITY_END();
+}
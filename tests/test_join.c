@@ -0,0 +1,196 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/parallel.h"
+#include "geohex/join.h"
+
+#define NA              1500
+#define NB              1000
+#define EARTH_RADIUS    6371008.8
+#define MAX_WORKERS     8
+
+typedef struct {
+    uint8_t *found;
+    size_t count[MAX_WORKERS];
+    bool bad_distance;
+} collector_t;
+
+static double a_lon[NA], a_lat[NA], b_lon[NB], b_lat[NB];
+static uint64_t seed;
+
+static double next_random(void)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double) (seed >> 11) / 9007199254740992.0;
+}
+
+static double haversine(double lon1, double lat1, double lon2, double lat2)
+{
+    double p1 = lat1 * M_PI / 180.0, p2 = lat2 * M_PI / 180.0;
+    double dp = p2 - p1, dl = (lon2 - lon1) * M_PI / 180.0;
+    double h = sin(dp / 2) * sin(dp / 2) + cos(p1) * cos(p2) * sin(dl / 2) * sin(dl / 2);
+
+    return 2.0 * EARTH_RADIUS * asin(fmin(1.0, sqrt(h)));
+}
+
+/* clusters around Tokyo, Oslo and the antimeridian */
+static void scatter(double *lon, double *lat, size_t n, double spread)
+{
+    static const double centers[3][2] = {{139.7, 35.68}, {10.75, 59.91}, {179.99, -16.5}};
+
+    for (size_t i = 0; i < n; i++) {
+        const double *c = centers[i % 3];
+
+        lon[i] = c[0] + spread * (next_random() - 0.5);
+        lat[i] = c[1] + spread * (next_random() - 0.5);
+        if (lon[i] >= 180.0) {
+            lon[i] -= 360.0;
+        }
+    }
+}
+
+static void collect(void *arg, const geohex_join_pair_t *pairs, size_t n, uint32_t worker)
+{
+    collector_t *collector = arg;
+
+    /* each worker owns its counter; the found bits are per pair */
+    for (size_t i = 0; i < n; i++) {
+        double expected = haversine(a_lon[pairs[i].a], a_lat[pairs[i].a], b_lon[pairs[i].b], b_lat[pairs[i].b]);
+
+        if (fabs(expected - pairs[i].distance) > 1e-6 * fmax(1.0, expected)) {
+            __atomic_store_n(&collector->bad_distance, true, __ATOMIC_RELAXED);
+        }
+        collector->found[pairs[i].a * NB + pairs[i].b]++;
+    }
+    collector->count[worker] += n;
+}
+
+static void assert_join(const geohex_executor_t *executor, double meters)
+{
+    collector_t collector = {0};
+    size_t total = 0, expected = 0;
+
+    collector.found = calloc(NA * NB, 1);
+    TEST_ASSERT_TRUE(geohex_join_within(executor, a_lon, a_lat, NA, b_lon, b_lat, NB, meters, collect, &collector));
+    TEST_ASSERT_FALSE(collector.bad_distance);
+
+    for (size_t w = 0; w < MAX_WORKERS; w++) {
+        total += collector.count[w];
+    }
+
+    for (size_t a = 0; a < NA; a++) {
+        for (size_t b = 0; b < NB; b++) {
+            double d = haversine(a_lon[a], a_lat[a], b_lon[b], b_lat[b]);
+            uint8_t found = collector.found[a * NB + b];
+
+            TEST_ASSERT_TRUE(found <= 1);
+            if (d < meters * (1.0 - 1e-9)) {
+                TEST_ASSERT_EQUAL_UINT8(1, found);
+            } else if (d > meters * (1.0 + 1e-9)) {
+                TEST_ASSERT_EQUAL_UINT8(0, found);
+            }
+            expected += found;
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(expected, total);
+
+    free(collector.found);
+}
+
+void setUp(void)
+{
+    seed = 11;
+    scatter(a_lon, a_lat, NA, 0.2);
+    scatter(b_lon, b_lat, NB, 0.2);
+}
+
+void tearDown(void)
+{
+}
+
+void test_join_serial(void)
+{
+    static const double thresholds[] = {0, 50, 500, 2000, 10000, 300000};
+
+    for (size_t i = 0; i < sizeof(thresholds) / sizeof(thresholds[0]); i++) {
+        assert_join(NULL, thresholds[i]);
+    }
+}
+
+void test_join_parallel(void)
+{
+    geohex_pool_t *pool = geohex_pool_create(4);
+    geohex_executor_t executor;
+
+    TEST_ASSERT_TRUE(geohex_pool_executor(pool, &executor));
+    assert_join(&executor, 1000);
+    assert_join(&executor, 8000);
+
+    geohex_pool_destroy(pool);
+}
+
+void test_join_polar(void)
+{
+    geohex_pool_t *pool = geohex_pool_create(4);
+    geohex_executor_t executor;
+
+    /* rings around both poles, straddling the 89 degree grid cap */
+    for (size_t i = 0; i < NA; i++) {
+        a_lon[i] = 360.0 * next_random() - 180.0;
+        a_lat[i] = (i % 4 ? 1.0 : -1.0) * (89.5 + 0.9 * (next_random() - 0.5));
+    }
+    for (size_t i = 0; i < NB; i++) {
+        b_lon[i] = 360.0 * next_random() - 180.0;
+        b_lat[i] = (i % 4 ? 1.0 : -1.0) * (89.5 + 0.9 * (next_random() - 0.5));
+    }
+
+    assert_join(NULL, 5000);
+    assert_join(NULL, 40000);
+    TEST_ASSERT_TRUE(geohex_pool_executor(pool, &executor));
+    assert_join(&executor, 20000);
+
+    geohex_pool_destroy(pool);
+}
+
+void test_join_invalid(void)
+{
+    collector_t collector = {0};
+
+    TEST_ASSERT_FALSE(geohex_join_within(NULL, a_lon, a_lat, NA, b_lon, b_lat, NB, 100, NULL, NULL));
+    TEST_ASSERT_FALSE(geohex_join_within(NULL, a_lon, a_lat, NA, b_lon, b_lat, NB, -1, collect, &collector));
+    TEST_ASSERT_FALSE(geohex_join_within(NULL, a_lon, a_lat, NA, b_lon, b_lat, NB, NAN, collect, &collector));
+    TEST_ASSERT_FALSE(geohex_join_within(NULL, NULL, NULL, NA, b_lon, b_lat, NB, 100, collect, &collector));
+    TEST_ASSERT_TRUE(geohex_join_within(NULL, NULL, NULL, 0, b_lon, b_lat, NB, 100, collect, &collector));
+    TEST_ASSERT_EQUAL_size_t(0, collector.count[0]);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_join_serial);
+    RUN_TEST(test_join_parallel);
+    RUN_TEST(test_join_polar);
+    RUN_TEST(test_join_invalid);
+
+    return UNITY_END();
+}
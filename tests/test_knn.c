@@ -0,0 +1,209 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/knn.h"
+
+#define ZONES   3000
+#define QUERIES 200
+#define K       12
+#define MAX_K   20
+#define H_BASE  20037508.34
+
+static geohex_id_t ids[ZONES];
+static uint64_t seed;
+
+static double next_random(void)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double) (seed >> 11) / 9007199254740992.0;
+}
+
+static loc_t random_location(void)
+{
+    /* half around Tokyo, half straddling the antimeridian */
+    if (next_random() < 0.5) {
+        return (loc_t) {139.5 + 0.5 * next_random(), 35.5 + 0.5 * next_random()};
+    }
+
+    double lon = 179.5 + next_random();
+
+    return (loc_t) {lon >= 180.0 ? lon - 360.0 : lon, -17.0 + 0.5 * next_random()};
+}
+
+static double reference_distance(geohex_id_t id, const loc_t *loc)
+{
+    zone_t zone;
+    double x = loc->lon * H_BASE / 180.0;
+    double y = log(tan((90.0 + loc->lat) * M_PI / 360.0)) * (H_BASE / M_PI);
+    double h_size = H_BASE / pow(3.0, get_level_by_id(id) + 3);
+    double dx, dy;
+
+    get_zone_by_id(id, &zone);
+    dx = 3.0 * h_size * (zone.xy.x - zone.xy.y) - x;
+    dy = sqrt(3.0) * h_size * (zone.xy.x + zone.xy.y) - y;
+    if (dx > H_BASE) {
+        dx -= 2.0 * H_BASE;
+    } else if (dx < -H_BASE) {
+        dx += 2.0 * H_BASE;
+    }
+
+    return sqrt(dx * dx + dy * dy);
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double da = *(const double *) a, db = *(const double *) b;
+
+    return (da > db) - (da < db);
+}
+
+static void fill(uint32_t level, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        loc_t loc = random_location();
+        xy_t xy;
+
+        get_xy_by_location(&loc, level, &xy);
+        get_id_by_xy(&xy, level, &ids[i]);
+    }
+}
+
+static int compare_id(const void *a, const void *b)
+{
+    geohex_id_t ia = *(const geohex_id_t *) a, ib = *(const geohex_id_t *) b;
+
+    return (ia > ib) - (ia < ib);
+}
+
+static void assert_knn(const geohex_knn_t *knn, size_t n, size_t k)
+{
+    geohex_id_t *distinct = malloc(n * sizeof(geohex_id_t));
+    double *distances = malloc(n * sizeof(double));
+    geohex_knn_result_t results[MAX_K];
+    size_t unique = 0;
+
+    /* brute force runs over the distinct zones */
+    memcpy(distinct, ids, n * sizeof(geohex_id_t));
+    qsort(distinct, n, sizeof(geohex_id_t), compare_id);
+    for (size_t i = 0; i < n; i++) {
+        if (unique == 0 || distinct[unique - 1] != distinct[i]) {
+            distinct[unique++] = distinct[i];
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(unique, geohex_knn_size(knn));
+
+    for (uint32_t q = 0; q < QUERIES; q++) {
+        loc_t loc = random_location();
+        size_t found;
+
+        TEST_ASSERT_TRUE(geohex_knn_search(knn, &loc, k, results, &found));
+        TEST_ASSERT_EQUAL_size_t(k < unique ? k : unique, found);
+
+        for (size_t i = 0; i < unique; i++) {
+            distances[i] = reference_distance(distinct[i], &loc);
+        }
+        qsort(distances, unique, sizeof(double), compare_double);
+
+        for (size_t i = 0; i < found; i++) {
+            TEST_ASSERT_DOUBLE_WITHIN(1e-6 * fmax(1.0, distances[i]), distances[i], results[i].distance);
+            TEST_ASSERT_DOUBLE_WITHIN(1e-6 * fmax(1.0, distances[i]), reference_distance(results[i].id, &loc), results[i].distance);
+            if (i > 0) {
+                TEST_ASSERT_TRUE(results[i - 1].distance <= results[i].distance);
+            }
+        }
+    }
+
+    free(distances);
+    free(distinct);
+}
+
+void setUp(void)
+{
+    seed = 5;
+}
+
+void tearDown(void)
+{
+}
+
+void test_knn_dense(void)
+{
+    for (uint32_t level = 5; level <= 9; level += 2) {
+        geohex_knn_t *knn;
+
+        fill(level, ZONES);
+        knn = geohex_knn_create(level, ids, ZONES);
+        TEST_ASSERT_NOT_NULL(knn);
+        assert_knn(knn, ZONES, K);
+        assert_knn(knn, ZONES, 1);
+        geohex_knn_destroy(knn);
+    }
+}
+
+void test_knn_sparse(void)
+{
+    /* few zones: the rings give way to a scan */
+    geohex_knn_t *knn;
+
+    fill(10, 20);
+    knn = geohex_knn_create(10, ids, 20);
+    TEST_ASSERT_NOT_NULL(knn);
+    assert_knn(knn, 20, K);
+    assert_knn(knn, 20, MAX_K);
+    geohex_knn_destroy(knn);
+
+    /* coarse levels where rings wrap around the globe */
+    fill(0, 40);
+    knn = geohex_knn_create(0, ids, 40);
+    assert_knn(knn, 40, K);
+    geohex_knn_destroy(knn);
+}
+
+void test_knn_invalid(void)
+{
+    geohex_knn_t *knn;
+    geohex_knn_result_t result;
+    loc_t loc = {139.7, 35.7};
+    size_t found;
+
+    fill(7, 2);
+    TEST_ASSERT_NULL(geohex_knn_create(8, ids, 2));
+    TEST_ASSERT_NULL(geohex_knn_create(MAX_LEVEL + 1, ids, 0));
+
+    knn = geohex_knn_create(7, ids, 0);
+    TEST_ASSERT_NOT_NULL(knn);
+    TEST_ASSERT_TRUE(geohex_knn_search(knn, &loc, 1, &result, &found));
+    TEST_ASSERT_EQUAL_size_t(0, found);
+    TEST_ASSERT_FALSE(geohex_knn_search(knn, &loc, 1, NULL, &found));
+    geohex_knn_destroy(knn);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_knn_dense);
+    RUN_TEST(test_knn_sparse);
+    RUN_TEST(test_knn_invalid);
+
+    return UNITY_END();
+}
@@ -0,0 +1,302 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+
+#include "json_data.h"
+
+#define POINTS  (sizeof(coord2hex_data) / sizeof(coord2hex_data[0]))
+#define RADIUS  6
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static bool same_zone(const xy_t *a, const xy_t *b, uint32_t level)
+{
+    geohex_id_t id_a, id_b;
+
+    get_id_by_xy(a, level, &id_a);
+    get_id_by_xy(b, level, &id_b);
+    return id_a == id_b;
+}
+
+void test_lattice_neighbors(void)
+{
+    for (uint32_t i = 0; i < POINTS; i++) {
+        loc_t loc = {coord2hex_data[i].lon, coord2hex_data[i].lat};
+
+        for (uint32_t level = 2; level <= MAX_LEVEL; level++) {
+            xy_t xy, neighbors[6];
+            uint32_t distance;
+
+            get_xy_by_location(&loc, level, &xy);
+            TEST_ASSERT_TRUE(get_xy_neighbors(&xy, level, neighbors));
+
+            for (int n = 0; n < 6; n++) {
+                zone_t zone;
+                xy_t back;
+
+                /* the centre of a neighbour maps back to it */
+                get_zone_by_xy(&neighbors[n], level, &zone);
+                get_xy_by_location(&zone.latlon, level, &back);
+                TEST_ASSERT_TRUE(same_zone(&neighbors[n], &back, level));
+
+                TEST_ASSERT_TRUE(get_xy_distance(&xy, &neighbors[n], level, &distance));
+                TEST_ASSERT_EQUAL_UINT32(1, distance);
+            }
+        }
+    }
+}
+
+void test_lattice_ring_disk(void)
+{
+    xy_t disk[GEOHEX_DISK_SIZE(RADIUS)];
+    geohex_id_t ids[GEOHEX_DISK_SIZE(RADIUS)];
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        loc_t loc = {coord2hex_data[i].lon, coord2hex_data[i].lat};
+        uint32_t level = 4 + i % 8;
+        xy_t xy;
+        size_t n = 0;
+
+        get_xy_by_location(&loc, level, &xy);
+
+        for (uint32_t r = 0; r <= RADIUS; r++) {
+            size_t count = get_xy_ring(&xy, level, r, disk + n);
+
+            TEST_ASSERT_EQUAL_size_t(r == 0 ? 1 : 6 * r, count);
+            for (size_t k = n; k < n + count; k++) {
+                uint32_t distance;
+
+                get_xy_distance(&xy, &disk[k], level, &distance);
+                TEST_ASSERT_EQUAL_UINT32(r, distance);
+            }
+            n += count;
+        }
+        TEST_ASSERT_EQUAL_size_t(GEOHEX_DISK_SIZE(RADIUS), n);
+        TEST_ASSERT_EQUAL_size_t(n, get_xy_disk(&xy, level, RADIUS, disk));
+
+        /* all distinct */
+        for (size_t k = 0; k < n; k++) {
+            get_id_by_xy(&disk[k], level, &ids[k]);
+            for (size_t j = 0; j < k; j++) {
+                TEST_ASSERT_TRUE(ids[j] != ids[k]);
+            }
+        }
+    }
+}
+
+void test_lattice_antimeridian(void)
+{
+    for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+        for (double lat = -60.123; lat <= 60.0; lat += 7.5) {
+            loc_t east = {179.9999999, lat}, west = {-179.9999999, lat};
+            xy_t a, b, neighbors[6];
+            uint32_t distance;
+            bool adjacent;
+
+            get_xy_by_location(&east, level, &a);
+            get_xy_by_location(&west, level, &b);
+            TEST_ASSERT_TRUE(get_xy_distance(&a, &b, level, &distance));
+            TEST_ASSERT_TRUE(distance <= 1);
+
+            get_xy_neighbors(&a, level, neighbors);
+            adjacent = same_zone(&a, &b, level);
+            for (int n = 0; n < 6; n++) {
+                adjacent |= same_zone(&neighbors[n], &b, level);
+            }
+            TEST_ASSERT_TRUE(adjacent);
+        }
+    }
+}
+
+void test_lattice_local_ij(void)
+{
+    for (uint32_t i = 0; i < POINTS; i++) {
+        loc_t loc = {coord2hex_data[i].lon, coord2hex_data[i].lat};
+        uint32_t level = 2 + i % 12;
+        xy_t anchor, disk[GEOHEX_DISK_SIZE(RADIUS)];
+        size_t n;
+
+        get_xy_by_location(&loc, level, &anchor);
+        n = get_xy_disk(&anchor, level, RADIUS, disk);
+
+        for (size_t k = 0; k < n; k++) {
+            ij_t ij;
+            xy_t back;
+            uint32_t distance, steps;
+
+            TEST_ASSERT_TRUE(get_local_ij(&anchor, &disk[k], level, &ij));
+            TEST_ASSERT_TRUE(get_xy_by_local_ij(&anchor, &ij, level, &back));
+            TEST_ASSERT_TRUE(same_zone(&disk[k], &back, level));
+
+            /* the offset is as short as the distance */
+            get_xy_distance(&anchor, &disk[k], level, &distance);
+            steps = (ij.i < 0) == (ij.j < 0) ? (uint32_t) (abs(ij.i) > abs(ij.j) ? abs(ij.i) : abs(ij.j)) : (uint32_t) (abs(ij.i) + abs(ij.j));
+            TEST_ASSERT_EQUAL_UINT32(distance, steps);
+        }
+    }
+}
+
+void test_lattice_local_ij_antimeridian(void)
+{
+    for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+        for (double lat = -60.123; lat <= 60.0; lat += 7.5) {
+            loc_t east = {179.9999999, lat}, west = {-179.9999999, lat};
+            xy_t a, b, back;
+            ij_t ij, lap;
+
+            get_xy_by_location(&east, level, &a);
+            get_xy_by_location(&west, level, &b);
+            TEST_ASSERT_TRUE(get_local_ij(&a, &b, level, &ij));
+            TEST_ASSERT_TRUE(abs(ij.i) <= 1 && abs(ij.j) <= 1);
+            TEST_ASSERT_TRUE(get_xy_by_local_ij(&a, &ij, level, &back));
+            TEST_ASSERT_TRUE(same_zone(&b, &back, level));
+
+            /* whole laps around the globe land on the same zone */
+            if (level < 10) {
+                lap.i = ij.i + 3 * (int32_t) (pow(3.0, level + 2) + 0.5);
+                lap.j = ij.j - 3 * (int32_t) (pow(3.0, level + 2) + 0.5);
+                TEST_ASSERT_TRUE(get_xy_by_local_ij(&a, &lap, level, &back));
+                TEST_ASSERT_TRUE(same_zone(&b, &back, level));
+            }
+        }
+    }
+}
+
+static void expect_step(const geohex_code_t code, int32_t dx, int32_t dy)
+{
+    uint32_t level = (uint32_t) strlen(code) - 2;
+    ij_t ij = {dx, dy};
+    xy_t xy, next;
+    zone_t zone;
+    geohex_code_t stepped;
+    geohex_id_t id, stepped_id, expected_id;
+
+    TEST_ASSERT_TRUE(get_xy_by_code(code, &xy));
+    TEST_ASSERT_TRUE(get_xy_by_local_ij(&xy, &ij, level, &next));
+    TEST_ASSERT_TRUE(get_zone_by_xy(&next, level, &zone));
+
+    TEST_ASSERT_TRUE(get_code_step(code, dx, dy, stepped));
+    TEST_ASSERT_EQUAL_STRING(zone.code, stepped);
+
+    TEST_ASSERT_TRUE(get_id_by_code(code, &id));
+    TEST_ASSERT_TRUE(get_id_by_code(zone.code, &expected_id));
+    TEST_ASSERT_TRUE(get_id_step(id, dx, dy, &stepped_id));
+    TEST_ASSERT_TRUE(expected_id == stepped_id);
+}
+
+void test_lattice_code_step(void)
+{
+    static const char key[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+    /* every code of the low levels, canonical or not, in every direction */
+    for (uint32_t level = 0; level <= 2; level++) {
+        uint32_t count = 729 * (uint32_t) pow(9.0, level);
+
+        for (uint32_t n = 0; n < count; n++) {
+            geohex_code_t code;
+            uint32_t digits = n, h_1_int = 0;
+
+            for (int32_t i = (int32_t) level + 1; i >= 2; i--) {
+                code[i] = (char) ('0' + digits % 9);
+                digits /= 9;
+            }
+            for (uint32_t i = 0, scale = 1; i < 3; i++, scale *= 10) {
+                h_1_int += digits % 9 * scale;
+                digits /= 9;
+            }
+            code[0] = key[h_1_int / 30];
+            code[1] = key[h_1_int % 30];
+            code[level + 2] = '\0';
+
+            for (int32_t dx = -1; dx <= 1; dx++) {
+                for (int32_t dy = -1; dy <= 1; dy++) {
+                    expect_step(code, dx, dy);
+                }
+            }
+        }
+    }
+
+    /* real zones of every level, along the antimeridian too */
+    for (uint32_t i = 0; i < POINTS; i++) {
+        for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+            loc_t locs[2] = {{coord2hex_data[i].lon, coord2hex_data[i].lat}, {180.0, coord2hex_data[i].lat}};
+
+            for (int k = 0; k < 2; k++) {
+                zone_t zone;
+
+                get_zone_by_location(&locs[k], level, &zone);
+                for (int n = 0; n < 6; n++) {
+                    static const int32_t dx[6] = {1, 0, -1, -1, 0, 1}, dy[6] = {1, 1, 0, -1, -1, 0};
+
+                    expect_step(zone.code, dx[n], dy[n]);
+                }
+            }
+        }
+    }
+}
+
+void test_lattice_invalid(void)
+{
+    static const geohex_code_t valid = "XM", bad_codes[] = {"X", "XM9", "X!1", "zz1"};
+    xy_t xy = {0, 0, false}, out[6];
+    uint32_t distance;
+    ij_t ij;
+    geohex_code_t code;
+    geohex_id_t id;
+
+    TEST_ASSERT_FALSE(get_xy_neighbors(&xy, MAX_LEVEL + 1, out));
+    TEST_ASSERT_FALSE(get_xy_neighbors(NULL, 0, out));
+    TEST_ASSERT_EQUAL_size_t(0, get_xy_ring(&xy, MAX_LEVEL + 1, 1, out));
+    TEST_ASSERT_EQUAL_size_t(0, get_xy_disk(NULL, 0, 1, out));
+    TEST_ASSERT_FALSE(get_xy_distance(&xy, NULL, 0, &distance));
+    TEST_ASSERT_FALSE(get_local_ij(&xy, &xy, MAX_LEVEL + 1, &ij));
+    TEST_ASSERT_FALSE(get_xy_by_local_ij(&xy, NULL, 0, out));
+    TEST_ASSERT_FALSE(get_code_step(valid, 2, 0, code));
+    for (size_t i = 0; i < sizeof(bad_codes) / sizeof(bad_codes[0]); i++) {
+        TEST_ASSERT_FALSE(get_code_step(bad_codes[i], 1, 0, code));
+    }
+    TEST_ASSERT_FALSE(get_code_step(NULL, 1, 0, code));
+    TEST_ASSERT_FALSE(get_id_step(GEOHEX_ID_INVALID, 1, 0, &id));
+    TEST_ASSERT_FALSE(get_id_step(0, 0, -2, &id));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_lattice_neighbors);
+    RUN_TEST(test_lattice_ring_disk);
+    RUN_TEST(test_lattice_antimeridian);
+    RUN_TEST(test_lattice_local_ij);
+    RUN_TEST(test_lattice_local_ij_antimeridian);
+    RUN_TEST(test_lattice_code_step);
+    RUN_TEST(test_lattice_invalid);
+
+    return UNITY_END();
+}
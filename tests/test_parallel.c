@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/parallel.h"
+
+#include "json_data.h"
+
+#define POINTS  (sizeof(coord2hex_data) / sizeof(coord2hex_data[0]))
+#define LEVEL   11
+
+static loc_t locations[POINTS];
+static geohex_code_t codes[POINTS];
+
+void setUp(void)
+{
+    for (uint32_t i = 0; i < POINTS; i++) {
+        locations[i].lon = coord2hex_data[i].lon;
+        locations[i].lat = coord2hex_data[i].lat;
+        strcpy(codes[i], coord2hex_data[i].code);
+    }
+}
+
+void tearDown(void) {}
+
+static void count_task(void *arg, size_t begin, size_t end, uint32_t worker)
+{
+    uint32_t *hits = arg;
+
+    (void) worker;
+
+    for (size_t i = begin; i < end; i++) {
+        __atomic_fetch_add(&hits[i], 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void serial_for(void *context, size_t n, geohex_task_fn task, void *arg)
+{
+    (void) context;
+
+    /* odd sized ranges to exercise range boundaries */
+    for (size_t begin = 0; begin < n; begin += 7) {
+        task(arg, begin, begin + 7 < n ? begin + 7 : n, 0);
+    }
+}
+
+void test_pool_run_covers_every_index(void)
+{
+    const size_t sizes[] = {1, 3, 64, 1000, 100003};
+    geohex_pool_t *pool = geohex_pool_create(4);
+
+    TEST_ASSERT_NOT_NULL(pool);
+    TEST_ASSERT_EQUAL_UINT32(4, geohex_pool_size(pool));
+
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint32_t *hits = calloc(sizes[s], sizeof(uint32_t));
+
+        for (uint32_t round = 0; round < 3; round++) {
+            geohex_pool_run(pool, sizes[s], count_task, hits);
+        }
+        for (size_t i = 0; i < sizes[s]; i++) {
+            TEST_ASSERT_EQUAL_UINT32(3, hits[i]);
+        }
+
+        free(hits);
+    }
+
+    geohex_pool_destroy(pool);
+}
+
+void test_get_zones_by_locations_parallel(void)
+{
+    zone_t *serial = calloc(POINTS, sizeof(zone_t));
+    zone_t *parallel = calloc(POINTS, sizeof(zone_t));
+    geohex_pool_t *pool = geohex_pool_create(3);
+    geohex_executor_t executor;
+
+    TEST_ASSERT_TRUE(geohex_pool_executor(pool, &executor));
+    TEST_ASSERT_TRUE(get_zones_by_locations(locations, POINTS, LEVEL, serial));
+    TEST_ASSERT_TRUE(get_zones_by_locations_parallel(&executor, locations, POINTS, LEVEL, parallel));
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        TEST_ASSERT_EQUAL_STRING(serial[i].code, parallel[i].code);
+        TEST_ASSERT_EQUAL_INT32(serial[i].xy.x, parallel[i].xy.x);
+        TEST_ASSERT_EQUAL_INT32(serial[i].xy.y, parallel[i].xy.y);
+    }
+
+    geohex_pool_destroy(pool);
+    free(serial);
+    free(parallel);
+}
+
+void test_get_zones_by_codes_parallel(void)
+{
+    zone_t *parallel = calloc(POINTS, sizeof(zone_t));
+    geohex_executor_t executor = {1, serial_for, NULL};
+
+    TEST_ASSERT_TRUE(get_zones_by_codes_parallel(&executor, (const geohex_code_t *) codes, POINTS, parallel));
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        zone_t expected;
+
+        TEST_ASSERT_TRUE(get_zone_by_code(codes[i], &expected));
+        TEST_ASSERT_EQUAL_STRING(expected.code, parallel[i].code);
+        TEST_ASSERT_EQUAL_DOUBLE(expected.latlon.lat, parallel[i].latlon.lat);
+        TEST_ASSERT_EQUAL_DOUBLE(expected.latlon.lon, parallel[i].latlon.lon);
+    }
+
+    strcpy(codes[POINTS / 2], "0");
+    TEST_ASSERT_FALSE(get_zones_by_codes_parallel(&executor, (const geohex_code_t *) codes, POINTS, parallel));
+
+    free(parallel);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_pool_run_covers_every_index);
+    RUN_TEST(test_get_zones_by_locations_parallel);
+    RUN_TEST(test_get_zones_by_codes_parallel);
+
+    return UNITY_END();
+}
@@ -0,0 +1,267 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/path.h"
+
+#define LEVEL   9
+#define ARENA   12
+#define ZONES   GEOHEX_DISK_SIZE(ARENA)
+#define MAX_PATH 4096
+
+static geohex_id_t route[MAX_PATH];
+static geohex_id_t disk_ids[ZONES];
+static double disk_costs[ZONES];
+
+static geohex_id_t id_at(double lon, double lat, uint32_t level)
+{
+    loc_t loc = {lon, lat};
+    xy_t xy;
+    geohex_id_t id;
+
+    get_xy_by_location(&loc, level, &xy);
+    get_id_by_xy(&xy, level, &id);
+    return id;
+}
+
+static uint32_t step_distance(geohex_id_t a, geohex_id_t b)
+{
+    xy_t xa, xb;
+    uint32_t distance;
+
+    get_xy_by_id(a, &xa);
+    get_xy_by_id(b, &xb);
+    get_xy_distance(&xa, &xb, get_level_by_id(a), &distance);
+    return distance;
+}
+
+static size_t disk_index(geohex_id_t id)
+{
+    for (size_t i = 0; i < ZONES; i++) {
+        if (disk_ids[i] == id) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+/* consecutive zones adjoin and the entered costs add up */
+static void assert_route(size_t length, double cost, bool weighted)
+{
+    double total = 0;
+
+    for (size_t i = 1; i < length; i++) {
+        TEST_ASSERT_EQUAL_UINT32(1, step_distance(route[i - 1], route[i]));
+        total += weighted ? disk_costs[disk_index(route[i])] : 1.0;
+    }
+    TEST_ASSERT_DOUBLE_WITHIN(1e-9, total, cost);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_path_open(void)
+{
+    geohex_path_t *path = geohex_path_create(LEVEL);
+    geohex_id_t from = id_at(139.70, 35.65, LEVEL), to = id_at(139.78, 35.70, LEVEL);
+    size_t length;
+    double cost;
+
+    TEST_ASSERT_NOT_NULL(path);
+    TEST_ASSERT_TRUE(geohex_path_find(path, from, to, 0, route, MAX_PATH, &length, &cost));
+    TEST_ASSERT_EQUAL_size_t(step_distance(from, to) + 1, length);
+    TEST_ASSERT_TRUE(route[0] == from && route[length - 1] == to);
+    assert_route(length, cost, false);
+
+    /* the arena is reused */
+    TEST_ASSERT_TRUE(geohex_path_find(path, to, from, 0, route, MAX_PATH, &length, &cost));
+    TEST_ASSERT_EQUAL_size_t(step_distance(from, to) + 1, length);
+    TEST_ASSERT_TRUE(geohex_path_find(path, from, from, 0, route, MAX_PATH, &length, &cost));
+    TEST_ASSERT_EQUAL_size_t(1, length);
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, cost);
+
+    /* short capacity reports the length needed */
+    TEST_ASSERT_FALSE(geohex_path_find(path, from, to, 0, route, 2, &length, &cost));
+    TEST_ASSERT_EQUAL_size_t(step_distance(from, to) + 1, length);
+
+    geohex_path_destroy(path);
+}
+
+void test_path_weighted(void)
+{
+    geohex_id_t center = id_at(-0.1276, 51.5072, LEVEL);
+    xy_t xy, disk[ZONES];
+    uint64_t seed = 7;
+
+    get_xy_by_id(center, &xy);
+    get_xy_disk(&xy, LEVEL, ARENA, disk);
+
+    for (int trial = 0; trial < 20; trial++) {
+        geohex_path_t *path = geohex_path_create(LEVEL);
+        double g[ZONES];
+        bool done[ZONES];
+        size_t length, from, to;
+        double cost;
+
+        /* a walled arena of random costs and obstacles */
+        for (size_t i = 0; i < ZONES; i++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            get_id_by_xy(&disk[i], LEVEL, &disk_ids[i]);
+            disk_costs[i] = i >= GEOHEX_DISK_SIZE(ARENA - 1) || (seed >> 60) < 3 ? GEOHEX_PATH_BLOCKED : 0.5 + (double) (seed >> 40) / (1 << 24) * 3.0;
+            if (disk_costs[i] != 1.0) {
+                TEST_ASSERT_TRUE(geohex_path_set_cost(path, disk_ids[i], disk_costs[i]));
+            }
+        }
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        from = (size_t) (seed >> 33) % GEOHEX_DISK_SIZE(ARENA - 1);
+        to = (size_t) (seed >> 13) % GEOHEX_DISK_SIZE(ARENA - 1);
+        disk_costs[from] = disk_costs[to] = 1.0;
+        geohex_path_set_cost(path, disk_ids[from], 1.0);
+        geohex_path_set_cost(path, disk_ids[to], 1.0);
+
+        /* plain Dijkstra over the arena */
+        for (size_t i = 0; i < ZONES; i++) {
+            g[i] = INFINITY;
+            done[i] = false;
+        }
+        g[from] = 0;
+        for (;;) {
+            size_t best = SIZE_MAX;
+            xy_t neighbors[6];
+
+            for (size_t i = 0; i < ZONES; i++) {
+                if (!done[i] && isfinite(g[i]) && (best == SIZE_MAX || g[i] < g[best])) {
+                    best = i;
+                }
+            }
+            if (best == SIZE_MAX) {
+                break;
+            }
+            done[best] = true;
+            get_xy_neighbors(&disk[best], LEVEL, neighbors);
+            for (int k = 0; k < 6; k++) {
+                geohex_id_t id;
+                size_t n;
+
+                get_id_by_xy(&neighbors[k], LEVEL, &id);
+                if ((n = disk_index(id)) != SIZE_MAX && isfinite(disk_costs[n])) {
+                    g[n] = fmin(g[n], g[best] + disk_costs[n]);
+                }
+            }
+        }
+
+        TEST_ASSERT_TRUE(geohex_path_find(path, disk_ids[from], disk_ids[to], 0, route, MAX_PATH, &length, &cost));
+        if (isinf(g[to])) {
+            TEST_ASSERT_EQUAL_size_t(0, length);
+            TEST_ASSERT_TRUE(isinf(cost));
+        } else {
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, g[to], cost);
+            assert_route(length, cost, true);
+        }
+        geohex_path_destroy(path);
+    }
+}
+
+void test_path_wall(void)
+{
+    geohex_path_t *path = geohex_path_create(LEVEL);
+    geohex_id_t center = id_at(139.70, 35.65, LEVEL), from, to;
+    xy_t xy, ring[6 * 5];
+    size_t length;
+    double cost;
+
+    /* a ring of radius 5 with one gap, on the far side from the goal */
+    get_xy_by_id(center, &xy);
+    get_xy_ring(&xy, LEVEL, 5, ring);
+    for (size_t i = 1; i < 6 * 5; i++) {
+        geohex_id_t id;
+
+        get_id_by_xy(&ring[i], LEVEL, &id);
+        TEST_ASSERT_TRUE(geohex_path_set_cost(path, id, GEOHEX_PATH_BLOCKED));
+    }
+    from = center;
+    to = id_at(139.66, 35.68, LEVEL);
+    TEST_ASSERT_TRUE(geohex_path_find(path, from, to, 0, route, MAX_PATH, &length, &cost));
+    TEST_ASSERT_TRUE(length > step_distance(from, to) + 1);
+    assert_route(length, cost, false);
+
+    /* closing the gap encloses the start; a budget stops the search early */
+    get_id_by_xy(&ring[0], LEVEL, &to);
+    TEST_ASSERT_TRUE(geohex_path_set_cost(path, to, GEOHEX_PATH_BLOCKED));
+    TEST_ASSERT_TRUE(geohex_path_find(path, from, id_at(139.66, 35.68, LEVEL), 0, route, MAX_PATH, &length, &cost));
+    TEST_ASSERT_EQUAL_size_t(0, length);
+    TEST_ASSERT_TRUE(geohex_path_find(path, from, to, 0, route, MAX_PATH, &length, &cost));
+    TEST_ASSERT_EQUAL_size_t(0, length);
+    TEST_ASSERT_TRUE(geohex_path_find(path, id_at(139.80, 35.60, LEVEL), id_at(139.90, 35.70, LEVEL), 10, route, MAX_PATH, &length, &cost));
+    TEST_ASSERT_EQUAL_size_t(0, length);
+
+    geohex_path_destroy(path);
+}
+
+void test_path_antimeridian(void)
+{
+    for (uint32_t level = 5; level <= 10; level++) {
+        geohex_path_t *path = geohex_path_create(level);
+        geohex_id_t from = id_at(179.97, -16.8, level), to = id_at(-179.96, -16.75, level);
+        size_t length;
+        double cost;
+
+        TEST_ASSERT_TRUE(geohex_path_find(path, from, to, 100000, route, MAX_PATH, &length, &cost));
+        TEST_ASSERT_EQUAL_size_t(step_distance(from, to) + 1, length);
+        assert_route(length, cost, false);
+        geohex_path_destroy(path);
+    }
+}
+
+void test_path_invalid(void)
+{
+    geohex_path_t *path = geohex_path_create(LEVEL);
+    geohex_id_t a = id_at(139.70, 35.65, LEVEL), b = id_at(139.70, 35.65, LEVEL + 1);
+    size_t length;
+    double cost;
+
+    TEST_ASSERT_NULL(geohex_path_create(MAX_LEVEL + 1));
+    TEST_ASSERT_FALSE(geohex_path_set_cost(path, a, 0.0));
+    TEST_ASSERT_FALSE(geohex_path_set_cost(path, a, -1.0));
+    TEST_ASSERT_FALSE(geohex_path_set_cost(path, b, 2.0));
+    TEST_ASSERT_FALSE(geohex_path_find(path, a, b, 0, route, MAX_PATH, &length, &cost));
+    TEST_ASSERT_FALSE(geohex_path_find(path, a, a, 0, NULL, MAX_PATH, &length, &cost));
+    geohex_path_destroy(path);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_path_open);
+    RUN_TEST(test_path_weighted);
+    RUN_TEST(test_path_wall);
+    RUN_TEST(test_path_antimeridian);
+    RUN_TEST(test_path_invalid);
+
+    return UNITY_END();
+}
@@ -0,0 +1,203 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/set.h"
+
+#define ROOT_LEVEL  2
+#define LEAF_LEVEL  5
+#define LEAVES      729 /* pow(9, LEAF_LEVEL - ROOT_LEVEL) */
+#define SET_SIZE    40
+#define ROUNDS      200
+
+static geohex_id_t root;
+static uint32_t seed = 12345;
+
+static uint32_t next_random(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 8) & 0xffffff;
+}
+
+void setUp(void)
+{
+    loc_t loc = {139.745433, 35.65858};
+    xy_t xy;
+
+    get_xy_by_location(&loc, ROOT_LEVEL, &xy);
+    get_id_by_xy(&xy, ROOT_LEVEL, &root);
+}
+
+void tearDown(void) {}
+
+static geohex_id_t random_descendant(void)
+{
+    geohex_code_t code;
+    uint32_t level = ROOT_LEVEL + next_random() % (LEAF_LEVEL - ROOT_LEVEL + 1);
+    geohex_id_t id;
+
+    get_code_by_id(root, code);
+    for (uint32_t l = ROOT_LEVEL; l < level; l++) {
+        code[l + 2] = '0' + next_random() % 9;
+    }
+    code[level + 2] = '\0';
+
+    get_id_by_code(code, &id);
+    return id;
+}
+
+static void expand(const geohex_id_t *ids, size_t n, bool *leaves)
+{
+    geohex_code_t root_code, code;
+
+    get_code_by_id(root, root_code);
+    memset(leaves, 0, LEAVES * sizeof(bool));
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t level = get_level_by_id(ids[i]);
+        uint32_t index = 0, span = 1;
+
+        TEST_ASSERT_TRUE(get_code_by_id(ids[i], code));
+        TEST_ASSERT_EQUAL_INT(0, strncmp(root_code, code, ROOT_LEVEL + 2));
+
+        for (uint32_t l = ROOT_LEVEL; l < LEAF_LEVEL; l++) {
+            index *= 9;
+            if (l < level) {
+                index += code[l + 2] - '0';
+            } else {
+                span *= 9;
+            }
+        }
+
+        for (uint32_t k = 0; k < span; k++) {
+            TEST_ASSERT_FALSE(leaves[index + k]);
+            leaves[index + k] = true;
+        }
+    }
+}
+
+static size_t random_set(geohex_id_t *ids)
+{
+    size_t n;
+
+    for (uint32_t i = 0; i < SET_SIZE; i++) {
+        ids[i] = random_descendant();
+    }
+    TEST_ASSERT_TRUE(geohex_set_normalize(ids, SET_SIZE, &n));
+
+    return n;
+}
+
+static void assert_normalized(const geohex_id_t *ids, size_t n)
+{
+    for (size_t i = 1; i < n; i++) {
+        TEST_ASSERT_TRUE(ids[i - 1] < ids[i]);
+        TEST_ASSERT_FALSE(geohex_set_contains(ids, i, ids[i]));
+    }
+}
+
+void test_set_operations(void)
+{
+    geohex_id_t a[SET_SIZE], b[SET_SIZE], out[LEAVES];
+    bool la[LEAVES], lb[LEAVES], lo[LEAVES];
+
+    for (uint32_t round = 0; round < ROUNDS; round++) {
+        size_t na = random_set(a), nb = random_set(b), n;
+
+        expand(a, na, la);
+        expand(b, nb, lb);
+
+        n = geohex_set_union(a, na, b, nb, out);
+        TEST_ASSERT_EQUAL_size_t(n, geohex_set_union(a, na, b, nb, NULL));
+        assert_normalized(out, n);
+        expand(out, n, lo);
+        for (uint32_t k = 0; k < LEAVES; k++) {
+            TEST_ASSERT_EQUAL_INT(la[k] || lb[k], lo[k]);
+        }
+
+        n = geohex_set_intersection(a, na, b, nb, out);
+        TEST_ASSERT_EQUAL_size_t(n, geohex_set_intersection(a, na, b, nb, NULL));
+        assert_normalized(out, n);
+        expand(out, n, lo);
+        for (uint32_t k = 0; k < LEAVES; k++) {
+            TEST_ASSERT_EQUAL_INT(la[k] && lb[k], lo[k]);
+        }
+
+        n = geohex_set_difference(a, na, b, nb, out);
+        TEST_ASSERT_EQUAL_size_t(n, geohex_set_difference(a, na, b, nb, NULL));
+        assert_normalized(out, n);
+        expand(out, n, lo);
+        bool subset = true;
+        for (uint32_t k = 0; k < LEAVES; k++) {
+            TEST_ASSERT_EQUAL_INT(la[k] && !lb[k], lo[k]);
+            subset &= !la[k] || lb[k];
+        }
+        TEST_ASSERT_EQUAL_INT(subset, geohex_set_is_subset(a, na, b, nb));
+    }
+}
+
+void test_set_mixed_levels(void)
+{
+    geohex_id_t coarse, fine[3], out[8];
+    geohex_code_t code;
+    size_t n;
+
+    get_code_by_id(root, code);
+    strcpy(code + ROOT_LEVEL + 2, "000");
+    get_id_by_code(code, &coarse);
+    get_parent_id(coarse, 3, &coarse);
+
+    strcpy(code + ROOT_LEVEL + 2, "0411");
+    get_id_by_code(code, &fine[0]);
+    strcpy(code + ROOT_LEVEL + 2, "0800");
+    get_id_by_code(code, &fine[1]);
+    strcpy(code + ROOT_LEVEL + 2, "1000");
+    get_id_by_code(code, &fine[2]);
+
+    TEST_ASSERT_TRUE(geohex_set_contains(&coarse, 1, fine[0]));
+    TEST_ASSERT_TRUE(geohex_set_contains(&coarse, 1, fine[1]));
+    TEST_ASSERT_FALSE(geohex_set_contains(&coarse, 1, fine[2]));
+    TEST_ASSERT_FALSE(geohex_set_contains(fine, 3, coarse));
+
+    n = geohex_set_intersection(&coarse, 1, fine, 3, out);
+    TEST_ASSERT_EQUAL_size_t(2, n);
+    TEST_ASSERT_EQUAL_UINT64(fine[0], out[0]);
+    TEST_ASSERT_EQUAL_UINT64(fine[1], out[1]);
+
+    n = geohex_set_union(&coarse, 1, fine, 3, out);
+    TEST_ASSERT_EQUAL_size_t(2, n);
+    TEST_ASSERT_EQUAL_UINT64(coarse, out[0]);
+    TEST_ASSERT_EQUAL_UINT64(fine[2], out[1]);
+
+    TEST_ASSERT_TRUE(geohex_set_is_subset(fine, 2, &coarse, 1));
+    TEST_ASSERT_FALSE(geohex_set_is_subset(&coarse, 1, fine, 2));
+    /* 7 untouched level 4 children, then 8 siblings at levels 5 and 6 for each removed zone */
+    TEST_ASSERT_EQUAL_size_t(7 + 2 * (8 + 8), geohex_set_difference(&coarse, 1, fine, 2, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_set_operations);
+    RUN_TEST(test_set_mixed_levels);
+
+    return UNITY_END();
+}
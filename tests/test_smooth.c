@@ -0,0 +1,208 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/lattice.h"
+#include "geohex/smooth.h"
+
+#define ZONES       4000
+#define MAX_RADIUS  3
+
+typedef struct {
+    geohex_id_t id;
+    double value;
+} entry_t;
+
+static geohex_id_t ids[ZONES];
+static double values[ZONES];
+static double out[ZONES];
+static entry_t entries[ZONES];
+static size_t unique;
+
+static int compare_entry(const void *a, const void *b)
+{
+    geohex_id_t ia = ((const entry_t *) a)->id, ib = ((const entry_t *) b)->id;
+
+    return (ia > ib) - (ia < ib);
+}
+
+static void build_entries(size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        entries[i].id = ids[i];
+        entries[i].value = values[i];
+    }
+    qsort(entries, n, sizeof(entry_t), compare_entry);
+
+    unique = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (unique > 0 && entries[unique - 1].id == entries[i].id) {
+            entries[unique - 1].value += entries[i].value;
+        } else {
+            entries[unique++] = entries[i];
+        }
+    }
+}
+
+static double value_of(geohex_id_t id)
+{
+    entry_t key = {id, 0};
+    entry_t *hit = bsearch(&key, entries, unique, sizeof(entry_t), compare_entry);
+
+    return hit ? hit->value : 0;
+}
+
+/* the three axis passes written out as one sum over their offsets */
+static double reference(geohex_id_t id, const double *kernel, int32_t radius)
+{
+    uint32_t level = get_level_by_id(id);
+    double sum = 0;
+    int32_t x, y;
+    xy_t xy;
+
+    get_xy_by_id(id, &xy);
+    x = xy.rev ? xy.y : xy.x;
+    y = xy.rev ? xy.x : xy.y;
+
+    for (int32_t a = -radius; a <= radius; a++) {
+        for (int32_t b = -radius; b <= radius; b++) {
+            for (int32_t c = -radius; c <= radius; c++) {
+                geohex_id_t other;
+                xy_t cell;
+
+                adjust_xy(x + a + c, y + b + c, level, &cell);
+                get_id_by_xy(&cell, level, &other);
+                sum += kernel[abs(a)] * kernel[abs(b)] * kernel[abs(c)] * value_of(other);
+            }
+        }
+    }
+
+    return sum;
+}
+
+static void fill(size_t n, uint32_t level, double lon, double lat, double span, uint64_t seed)
+{
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        loc_t loc = {lon + (double) (seed >> 40) / (1 << 24) * span, lat + (double) ((seed >> 16) & 0xffffff) / (1 << 24) * span};
+        xy_t xy;
+
+        get_xy_by_location(&loc, level, &xy);
+        get_id_by_xy(&xy, level, &ids[i]);
+        /* a quarter of the zones are empty halo */
+        values[i] = (seed >> 62) ? (double) ((seed >> 20) & 0xff) : 0.0;
+    }
+    build_entries(n);
+}
+
+static void assert_reference(size_t n, const double *kernel, uint32_t radius)
+{
+    TEST_ASSERT_TRUE(geohex_smooth(ids, values, n, kernel, radius, out));
+    for (size_t i = 0; i < n; i += 3) {
+        double expected = reference(ids[i], kernel, (int32_t) radius);
+
+        TEST_ASSERT_DOUBLE_WITHIN(1e-9 * fmax(1.0, fabs(expected)), expected, out[i]);
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_smooth_reference(void)
+{
+    static const double kernels[MAX_RADIUS + 1][MAX_RADIUS + 1] = {
+        {1.0}, {0.5, 0.25}, {0.4, 0.2, 0.1}, {0.3, 0.2, 0.1, 0.05},
+    };
+
+    for (uint32_t radius = 0; radius <= MAX_RADIUS; radius++) {
+        /* dense around Tokyo, then sparse enough to span many tiles */
+        fill(ZONES, 9, 139.70, 35.60, 0.08, radius + 1);
+        assert_reference(ZONES, kernels[radius], radius);
+        fill(ZONES, 11, 139.0, 35.0, 1.0, radius + 7);
+        assert_reference(ZONES, kernels[radius], radius);
+    }
+}
+
+void test_smooth_antimeridian(void)
+{
+    static const double kernel[3] = {0.4, 0.2, 0.1};
+
+    for (uint32_t level = 4; level <= 13; level += 3) {
+        fill(ZONES, level, 179.9, -17.0, 0.2, level);
+        assert_reference(ZONES, kernel, 2);
+    }
+}
+
+void test_smooth_gaussian(void)
+{
+    double kernel[7];
+    xy_t xy, disk[GEOHEX_DISK_SIZE(20)];
+    loc_t center = {-0.1276, 51.5072};
+    size_t n;
+
+    TEST_ASSERT_TRUE(geohex_smooth_gaussian(1.5, 6, kernel));
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 1.0, kernel[0] + 2.0 * (kernel[1] + kernel[2] + kernel[3] + kernel[4] + kernel[5] + kernel[6]));
+    TEST_ASSERT_TRUE(kernel[0] > kernel[1] && kernel[5] > kernel[6]);
+
+    /* a flat field stays flat well inside its border */
+    get_xy_by_location(&center, 8, &xy);
+    n = get_xy_disk(&xy, 8, 20, disk);
+    for (size_t i = 0; i < n; i++) {
+        get_id_by_xy(&disk[i], 8, &ids[i]);
+        values[i] = 3.0;
+    }
+    TEST_ASSERT_TRUE(geohex_smooth(ids, values, n, kernel, 6, out));
+    for (size_t i = 0; i < GEOHEX_DISK_SIZE(8); i++) {
+        TEST_ASSERT_DOUBLE_WITHIN(1e-9, 3.0, out[i]);
+    }
+    TEST_ASSERT_TRUE(out[n - 1] < 3.0);
+
+    TEST_ASSERT_FALSE(geohex_smooth_gaussian(0.0, 2, kernel));
+}
+
+void test_smooth_invalid(void)
+{
+    double kernel[1] = {1.0};
+
+    TEST_ASSERT_TRUE(geohex_smooth(NULL, NULL, 0, kernel, 0, NULL));
+    fill(2, 7, 139.7, 35.7, 0.1, 1);
+    fill(1, 8, 139.7, 35.7, 0.1, 2);
+    TEST_ASSERT_FALSE(geohex_smooth(ids, values, 2, kernel, 0, out));
+    TEST_ASSERT_FALSE(geohex_smooth(ids, values, 1, NULL, 0, out));
+    TEST_ASSERT_FALSE(geohex_smooth(ids, NULL, 1, kernel, 0, out));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_smooth_reference);
+    RUN_TEST(test_smooth_antimeridian);
+    RUN_TEST(test_smooth_gaussian);
+    RUN_TEST(test_smooth_invalid);
+
+    return UNITY_END();
+}
@@ -0,0 +1,163 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/sort.h"
+
+#include "json_data.h"
+
+#define POINTS  (sizeof(coord2hex_data) / sizeof(coord2hex_data[0]))
+#define LARGE   200000
+
+static geohex_id_t *ids, *expected;
+static size_t n;
+
+static int compare_id(const void *a, const void *b)
+{
+    geohex_id_t id_a = *(const geohex_id_t *) a;
+    geohex_id_t id_b = *(const geohex_id_t *) b;
+
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+void setUp(void)
+{
+    uint64_t seed = 88172645463325252ULL;
+
+    ids = malloc(LARGE * sizeof(geohex_id_t));
+    expected = malloc(LARGE * sizeof(geohex_id_t));
+
+    /* encoded zones at mixed levels, repeated to produce duplicates */
+    n = 0;
+    for (uint32_t round = 0; round < 4; round++) {
+        for (uint32_t i = 0; i < POINTS; i++) {
+            loc_t loc = {coord2hex_data[i].lon, coord2hex_data[i].lat};
+            uint32_t level = (i + round * 5) % (MAX_LEVEL + 1);
+            xy_t xy;
+
+            get_xy_by_location(&loc, level, &xy);
+            get_id_by_xy(&xy, level, &ids[n++]);
+        }
+    }
+
+    while (n < LARGE) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        ids[n++] = seed >> 2;
+    }
+
+    memcpy(expected, ids, n * sizeof(geohex_id_t));
+    qsort(expected, n, sizeof(geohex_id_t), compare_id);
+}
+
+void tearDown(void)
+{
+    free(ids);
+    free(expected);
+}
+
+void test_sort_ids(void)
+{
+    const size_t sizes[] = {0, 1, 2, 63, 64, 65, 1000, LARGE};
+
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        geohex_id_t *copy = malloc((sizes[s] + 1) * sizeof(geohex_id_t));
+        geohex_id_t *sorted = malloc((sizes[s] + 1) * sizeof(geohex_id_t));
+
+        memcpy(copy, ids, sizes[s] * sizeof(geohex_id_t));
+        memcpy(sorted, ids, sizes[s] * sizeof(geohex_id_t));
+        qsort(sorted, sizes[s], sizeof(geohex_id_t), compare_id);
+
+        TEST_ASSERT_TRUE(geohex_sort_ids(copy, sizes[s], NULL));
+        TEST_ASSERT_EQUAL_MEMORY(sorted, copy, sizes[s] * sizeof(geohex_id_t));
+
+        memcpy(copy, ids, sizes[s] * sizeof(geohex_id_t));
+        geohex_sort_ids_inplace(copy, sizes[s]);
+        TEST_ASSERT_EQUAL_MEMORY(sorted, copy, sizes[s] * sizeof(geohex_id_t));
+
+        free(copy);
+        free(sorted);
+    }
+}
+
+void test_sort_unique_ids(void)
+{
+    geohex_id_t *scratch = malloc(n * sizeof(geohex_id_t));
+    size_t unique_n, expected_n = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (i == 0 || expected[i] != expected[i - 1]) {
+            expected[expected_n++] = expected[i];
+        }
+    }
+
+    TEST_ASSERT_TRUE(geohex_sort_unique_ids(ids, n, scratch, &unique_n));
+    TEST_ASSERT_EQUAL_size_t(expected_n, unique_n);
+    TEST_ASSERT_EQUAL_MEMORY(expected, ids, unique_n * sizeof(geohex_id_t));
+
+    geohex_id_t same[100];
+    for (uint32_t i = 0; i < 100; i++) {
+        same[i] = 0x1234;
+    }
+    TEST_ASSERT_TRUE(geohex_sort_unique_ids(same, 100, NULL, &unique_n));
+    TEST_ASSERT_EQUAL_size_t(1, unique_n);
+
+    free(scratch);
+}
+
+void test_sort_ids_parallel(void)
+{
+    geohex_pool_t *pool = geohex_pool_create(3);
+    geohex_executor_t executor;
+
+    TEST_ASSERT_TRUE(geohex_pool_executor(pool, &executor));
+    TEST_ASSERT_TRUE(geohex_sort_ids_parallel(&executor, ids, n));
+    TEST_ASSERT_EQUAL_MEMORY(expected, ids, n * sizeof(geohex_id_t));
+
+    geohex_pool_destroy(pool);
+}
+
+void test_sort_ids_hierarchy_order(void)
+{
+    geohex_code_t prev, code;
+
+    TEST_ASSERT_TRUE(geohex_sort_ids(ids, 4 * POINTS, NULL));
+
+    for (uint32_t i = 0; i < 4 * POINTS; i++) {
+        TEST_ASSERT_TRUE(get_code_by_id(ids[i], code));
+        if (i > 0) {
+            TEST_ASSERT_TRUE(strcmp(prev, code) <= 0);
+        }
+        strcpy(prev, code);
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_sort_ids);
+    RUN_TEST(test_sort_unique_ids);
+    RUN_TEST(test_sort_ids_parallel);
+    RUN_TEST(test_sort_ids_hierarchy_order);
+
+    return UNITY_END();
+}
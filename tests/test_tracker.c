@@ -0,0 +1,209 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/tracker.h"
+
+#define OBJECTS 2000
+#define TICKS   40
+#define LEVEL   9
+
+typedef struct {
+    geohex_id_t expected[OBJECTS];
+    size_t events;
+    size_t calls;
+} checker_t;
+
+static double lon[OBJECTS], lat[OBJECTS];
+static uint64_t objects[OBJECTS];
+static uint64_t seed;
+
+static double next_random(void)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double) (seed >> 11) / 9007199254740992.0;
+}
+
+/* objects are numbered sparsely so the map cannot index them directly */
+static size_t object_index(uint64_t object)
+{
+    return (size_t) ((object - 11) / 7919);
+}
+
+static void check_events(void *arg, const geohex_tracker_event_t *events, size_t n)
+{
+    checker_t *checker = arg;
+
+    TEST_ASSERT_TRUE(n > 0);
+    for (size_t i = 0; i < n; i++) {
+        size_t index = object_index(events[i].object);
+
+        TEST_ASSERT_TRUE(index < OBJECTS);
+        TEST_ASSERT_TRUE(events[i].from != events[i].to);
+        TEST_ASSERT_EQUAL_UINT64(checker->expected[index], events[i].from);
+        checker->expected[index] = events[i].to;
+    }
+    checker->events += n;
+    checker->calls++;
+}
+
+static geohex_id_t zone_of(size_t i)
+{
+    loc_t loc = {lon[i], lat[i]};
+    xy_t xy;
+    geohex_id_t id;
+
+    get_xy_by_location(&loc, LEVEL, &xy);
+    get_id_by_xy(&xy, LEVEL, &id);
+    return id;
+}
+
+void setUp(void)
+{
+    seed = 3;
+    for (size_t i = 0; i < OBJECTS; i++) {
+        objects[i] = 11 + (uint64_t) i * 7919;
+        lon[i] = 139.5 + 0.5 * next_random();
+        lat[i] = 35.5 + 0.5 * next_random();
+    }
+}
+
+void tearDown(void)
+{
+}
+
+void test_tracker_update(void)
+{
+    geohex_tracker_t *tracker = geohex_tracker_create(LEVEL, 16);
+    checker_t *checker = malloc(sizeof(checker_t));
+    size_t moved_total = 0;
+
+    TEST_ASSERT_NOT_NULL(tracker);
+    for (size_t i = 0; i < OBJECTS; i++) {
+        checker->expected[i] = GEOHEX_ID_INVALID;
+    }
+    checker->events = 0;
+    checker->calls = 0;
+
+    TEST_ASSERT_TRUE(geohex_tracker_update(tracker, objects, lon, lat, OBJECTS, check_events, checker));
+    TEST_ASSERT_EQUAL_size_t(OBJECTS, checker->events);
+    TEST_ASSERT_EQUAL_size_t(OBJECTS, geohex_tracker_size(tracker));
+
+    for (uint32_t tick = 0; tick < TICKS; tick++) {
+        size_t moved = 0, before = checker->events;
+
+        /* most objects drift a little, a few jump */
+        for (size_t i = 0; i < OBJECTS; i++) {
+            geohex_id_t previous = zone_of(i);
+            double stride = i % 50 == 0 ? 0.05 : 0.0005;
+
+            lon[i] += stride * (next_random() - 0.5);
+            lat[i] += stride * (next_random() - 0.5);
+            moved += zone_of(i) != previous;
+        }
+
+        TEST_ASSERT_TRUE(geohex_tracker_update(tracker, objects, lon, lat, OBJECTS, check_events, checker));
+        TEST_ASSERT_EQUAL_size_t(moved, checker->events - before);
+        moved_total += moved;
+    }
+    TEST_ASSERT_TRUE(moved_total > 0);
+
+    for (size_t i = 0; i < OBJECTS; i++) {
+        geohex_id_t zone;
+
+        TEST_ASSERT_TRUE(geohex_tracker_get(tracker, objects[i], &zone));
+        TEST_ASSERT_EQUAL_UINT64(zone_of(i), zone);
+        TEST_ASSERT_EQUAL_UINT64(checker->expected[i], zone);
+    }
+
+    /* removal reports an exit, and a removed object may come back */
+    TEST_ASSERT_TRUE(geohex_tracker_remove(tracker, objects, 10, check_events, checker));
+    TEST_ASSERT_EQUAL_size_t(OBJECTS - 10, geohex_tracker_size(tracker));
+    for (size_t i = 0; i < 10; i++) {
+        geohex_id_t zone;
+
+        TEST_ASSERT_EQUAL_UINT64(GEOHEX_ID_INVALID, checker->expected[i]);
+        TEST_ASSERT_FALSE(geohex_tracker_get(tracker, objects[i], &zone));
+    }
+    TEST_ASSERT_FALSE(geohex_tracker_remove(tracker, objects, 1, check_events, checker));
+
+    TEST_ASSERT_TRUE(geohex_tracker_update(tracker, objects, lon, lat, 10, check_events, checker));
+    TEST_ASSERT_EQUAL_size_t(OBJECTS, geohex_tracker_size(tracker));
+    TEST_ASSERT_EQUAL_UINT64(zone_of(0), checker->expected[0]);
+
+    free(checker);
+    geohex_tracker_destroy(tracker);
+}
+
+void test_tracker_without_callback(void)
+{
+    geohex_tracker_t *tracker = geohex_tracker_create(LEVEL, 0);
+    geohex_id_t zone;
+
+    TEST_ASSERT_NULL(geohex_tracker_create(MAX_LEVEL + 1, 0));
+    TEST_ASSERT_TRUE(geohex_tracker_update(tracker, objects, lon, lat, OBJECTS, NULL, NULL));
+    TEST_ASSERT_TRUE(geohex_tracker_get(tracker, objects[OBJECTS - 1], &zone));
+    TEST_ASSERT_EQUAL_UINT64(zone_of(OBJECTS - 1), zone);
+    TEST_ASSERT_FALSE(geohex_tracker_get(tracker, 12345, &zone));
+
+    geohex_tracker_destroy(tracker);
+}
+
+void test_tracker_churn(void)
+{
+    geohex_tracker_t *tracker = geohex_tracker_create(LEVEL, 0);
+    uint64_t churned[OBJECTS];
+    geohex_id_t zone;
+
+    /* every other object leaves and a new one takes its place, many times over */
+    TEST_ASSERT_TRUE(geohex_tracker_update(tracker, objects, lon, lat, OBJECTS, NULL, NULL));
+    memcpy(churned, objects, sizeof(churned));
+    for (uint64_t round = 1; round <= 8; round++) {
+        for (size_t i = 0; i < OBJECTS; i += 2) {
+            TEST_ASSERT_TRUE(geohex_tracker_remove(tracker, &churned[i], 1, NULL, NULL));
+            TEST_ASSERT_FALSE(geohex_tracker_get(tracker, churned[i], &zone));
+            churned[i] = objects[i] + round * 1000003;
+            TEST_ASSERT_TRUE(geohex_tracker_update(tracker, &churned[i], &lon[i], &lat[i], 1, NULL, NULL));
+        }
+        TEST_ASSERT_EQUAL_size_t(OBJECTS, geohex_tracker_size(tracker));
+    }
+
+    for (size_t i = 0; i < OBJECTS; i++) {
+        TEST_ASSERT_TRUE(geohex_tracker_get(tracker, churned[i], &zone));
+        TEST_ASSERT_EQUAL_UINT64(zone_of(i), zone);
+        if (i % 2 == 0) {
+            TEST_ASSERT_FALSE(geohex_tracker_get(tracker, objects[i], &zone));
+        }
+    }
+
+    geohex_tracker_destroy(tracker);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_tracker_update);
+    RUN_TEST(test_tracker_without_callback);
+    RUN_TEST(test_tracker_churn);
+
+    return UNITY_END();
+}
@@ -0,0 +1,148 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/trajectory.h"
+
+#include "json_data.h"
+
+#define POINTS  (sizeof(coord2hex_data) / sizeof(coord2hex_data[0]))
+#define STEPS   20000
+
+static uint64_t seed;
+
+/* a stride of 15% of the hex size, in degrees of longitude */
+static double stride_for(uint32_t level)
+{
+    return 0.15 * 180.0 / pow(3.0, level + 3);
+}
+
+static double next_random(void)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double) (seed >> 11) / 9007199254740992.0;
+}
+
+void setUp(void)
+{
+    seed = 7;
+}
+
+void tearDown(void)
+{
+}
+
+static void assert_same_zone(const zone_t *expected, const zone_t *actual)
+{
+    TEST_ASSERT_EQUAL_STRING(expected->code, actual->code);
+    TEST_ASSERT_EQUAL_INT32(expected->xy.x, actual->xy.x);
+    TEST_ASSERT_EQUAL_INT32(expected->xy.y, actual->xy.y);
+    TEST_ASSERT_EQUAL(expected->xy.rev, actual->xy.rev);
+    TEST_ASSERT_EQUAL_DOUBLE(expected->latlon.lon, actual->latlon.lon);
+    TEST_ASSERT_EQUAL_DOUBLE(expected->latlon.lat, actual->latlon.lat);
+}
+
+/* a random walk whose stride is a fraction of the zone size */
+static void walk(uint32_t level, loc_t start, double stride)
+{
+    geohex_trajectory_t trajectory;
+    loc_t loc = start;
+    double heading = 0;
+
+    TEST_ASSERT_TRUE(geohex_trajectory_init(&trajectory, level));
+
+    for (uint32_t i = 0; i < STEPS; i++) {
+        zone_t expected, actual;
+
+        heading += (next_random() - 0.5) * 1.5;
+        loc.lon += stride * cos(heading) * (0.5 + next_random());
+        loc.lat += stride * sin(heading) * (0.5 + next_random());
+        if (loc.lon >= 180.0) {
+            loc.lon -= 360.0;
+        } else if (loc.lon < -180.0) {
+            loc.lon += 360.0;
+        }
+        loc.lat = fmax(-85.0, fmin(85.0, loc.lat));
+
+        TEST_ASSERT_TRUE(get_zone_by_location(&loc, level, &expected));
+        TEST_ASSERT_TRUE(geohex_trajectory_encode(&trajectory, &loc, &actual));
+        assert_same_zone(&expected, &actual);
+    }
+
+    TEST_ASSERT_EQUAL_UINT64(STEPS, trajectory.hits + trajectory.steps + trajectory.misses);
+    TEST_ASSERT_TRUE(trajectory.hits > trajectory.misses);
+    TEST_ASSERT_TRUE(trajectory.steps > 0);
+}
+
+void test_trajectory_walk(void)
+{
+    for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+        walk(level, (loc_t) {139.7, 35.68}, stride_for(level));
+        walk(level, (loc_t) {-70.6, -33.4}, stride_for(level));
+    }
+}
+
+void test_trajectory_antimeridian(void)
+{
+    for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+        walk(level, (loc_t) {179.99, 10.0}, stride_for(level));
+        walk(level, (loc_t) {-179.99, -45.0}, stride_for(level));
+    }
+}
+
+void test_trajectory_batch(void)
+{
+    double lon[POINTS], lat[POINTS];
+    zone_t *out = malloc(POINTS * sizeof(zone_t));
+    geohex_trajectory_t trajectory;
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        lon[i] = coord2hex_data[i].lon;
+        lat[i] = coord2hex_data[i].lat;
+    }
+
+    for (uint32_t level = 0; level <= MAX_LEVEL; level++) {
+        TEST_ASSERT_TRUE(geohex_trajectory_init(&trajectory, level));
+        TEST_ASSERT_TRUE(geohex_trajectory_encode_batch(&trajectory, lon, lat, POINTS, out));
+
+        for (uint32_t i = 0; i < POINTS; i++) {
+            loc_t loc = {lon[i], lat[i]};
+            zone_t expected;
+
+            get_zone_by_location(&loc, level, &expected);
+            assert_same_zone(&expected, &out[i]);
+        }
+    }
+
+    TEST_ASSERT_FALSE(geohex_trajectory_init(&trajectory, MAX_LEVEL + 1));
+    free(out);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_trajectory_walk);
+    RUN_TEST(test_trajectory_antimeridian);
+    RUN_TEST(test_trajectory_batch);
+
+    return UNITY_END();
+}
@@ -0,0 +1,245 @@
+/* SPDX-License-Identifier: MIT */
+/*
+ * libgeohex
+ *
+ * Copyright (c) 2024 Go Kudo (https://github.com/zeriyoshi)
+ *
+ * GeoHex original implementation by @sa2da (http://twitter.com/sa2da)
+ * https://www.geohex.org/
+ *
+ * Released under the MIT license.
+ * see https://opensource.org/licenses/MIT
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "geohex/geohex.h"
+#include "geohex/sort.h"
+#include "geohex/zoneset.h"
+
+#include "json_data.h"
+
+#define POINTS  (sizeof(coord2hex_data) / sizeof(coord2hex_data[0]))
+#define DENSE   20000
+
+static const geohex_code_t dense_base = "XM488548768";
+static geohex_id_t *ids;
+static size_t n;
+
+/* level-major, then id order, as the iterator walks the set */
+static int compare_level_id(const void *a, const void *b)
+{
+    geohex_id_t id_a = *(const geohex_id_t *) a;
+    geohex_id_t id_b = *(const geohex_id_t *) b;
+    uint32_t level_a = get_level_by_id(id_a), level_b = get_level_by_id(id_b);
+
+    if (level_a != level_b) {
+        return (level_a > level_b) - (level_a < level_b);
+    }
+
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+void setUp(void)
+{
+    geohex_id_t base;
+    size_t unique_n;
+
+    ids = malloc((POINTS + DENSE) * sizeof(geohex_id_t));
+    n = 0;
+
+    for (uint32_t i = 0; i < POINTS; i++) {
+        loc_t loc = {coord2hex_data[i].lon, coord2hex_data[i].lat};
+        uint32_t level = i % (MAX_LEVEL + 1);
+        xy_t xy;
+
+        get_xy_by_location(&loc, level, &xy);
+        get_id_by_xy(&xy, level, &ids[n++]);
+    }
+
+    /* a dense run of consecutive level 9 zones with a few gaps */
+    get_id_by_code(dense_base, &base);
+    for (uint32_t i = 0; i < DENSE; i++) {
+        if (i % 1000 != 999) {
+            ids[n++] = base + ((geohex_id_t) i * 531441 << GEOHEX_ID_LEVEL_BITS);
+        }
+    }
+
+    geohex_sort_unique_ids(ids, n, NULL, &unique_n);
+    n = unique_n;
+    qsort(ids, n, sizeof(geohex_id_t), compare_level_id);
+}
+
+void tearDown(void)
+{
+    free(ids);
+}
+
+static void assert_matches(const geohex_zoneset_t *set, const geohex_id_t *expected, size_t expected_n)
+{
+    geohex_zoneset_iter_t iter;
+    geohex_id_t id;
+    size_t count = 0;
+
+    TEST_ASSERT_EQUAL_size_t(expected_n, geohex_zoneset_size(set));
+
+    geohex_zoneset_iter_init(set, &iter);
+    while (geohex_zoneset_iter_next(&iter, &id)) {
+        TEST_ASSERT_TRUE(count < expected_n);
+        TEST_ASSERT_EQUAL_UINT64(expected[count], id);
+        count++;
+    }
+    TEST_ASSERT_EQUAL_size_t(expected_n, count);
+
+    for (size_t i = 0; i < expected_n; i++) {
+        TEST_ASSERT_TRUE(geohex_zoneset_contains(set, expected[i]));
+    }
+}
+
+void test_zoneset_add_contains_iterate(void)
+{
+    geohex_zoneset_t *set = geohex_zoneset_create();
+
+    /* insert in reverse to exercise out of order inserts */
+    for (size_t i = n; i > 0; i--) {
+        TEST_ASSERT_TRUE(geohex_zoneset_add(set, ids[i - 1]));
+    }
+    TEST_ASSERT_TRUE(geohex_zoneset_add(set, ids[0]));
+    TEST_ASSERT_FALSE(geohex_zoneset_add(set, GEOHEX_ID_INVALID));
+
+    assert_matches(set, ids, n);
+
+    geohex_id_t missing;
+    get_id_by_code(dense_base, &missing);
+    missing += (geohex_id_t) 999 * 531441 << GEOHEX_ID_LEVEL_BITS;
+    TEST_ASSERT_FALSE(geohex_zoneset_contains(set, missing));
+
+    TEST_ASSERT_TRUE(geohex_zoneset_optimize(set));
+    assert_matches(set, ids, n);
+    TEST_ASSERT_FALSE(geohex_zoneset_contains(set, missing));
+    TEST_ASSERT_TRUE(geohex_zoneset_serialized_size(set) < n * sizeof(geohex_id_t) / 4);
+
+    /* adding to a run container keeps it correct */
+    TEST_ASSERT_TRUE(geohex_zoneset_add(set, missing));
+    TEST_ASSERT_TRUE(geohex_zoneset_contains(set, missing));
+    TEST_ASSERT_EQUAL_size_t(n + 1, geohex_zoneset_size(set));
+
+    geohex_zoneset_destroy(set);
+}
+
+void test_zoneset_union_intersection(void)
+{
+    geohex_zoneset_t *a = geohex_zoneset_create();
+    geohex_zoneset_t *b = geohex_zoneset_create();
+    geohex_id_t *expected = malloc(n * sizeof(geohex_id_t));
+    size_t expected_n = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (i % 2 == 0 || i % 3 == 0) {
+            geohex_zoneset_add(a, ids[i]);
+        }
+        if (i % 3 == 0 || i % 5 == 0) {
+            geohex_zoneset_add(b, ids[i]);
+        }
+    }
+    geohex_zoneset_optimize(b);
+
+    geohex_zoneset_t *u = geohex_zoneset_union(a, b);
+    for (size_t i = 0; i < n; i++) {
+        if (i % 2 == 0 || i % 3 == 0 || i % 5 == 0) {
+            expected[expected_n++] = ids[i];
+        }
+    }
+    assert_matches(u, expected, expected_n);
+
+    geohex_zoneset_t *x = geohex_zoneset_intersection(a, b);
+    expected_n = 0;
+    for (size_t i = 0; i < n; i++) {
+        if ((i % 2 == 0 || i % 3 == 0) && (i % 3 == 0 || i % 5 == 0)) {
+            expected[expected_n++] = ids[i];
+        }
+    }
+    assert_matches(x, expected, expected_n);
+
+    geohex_zoneset_destroy(a);
+    geohex_zoneset_destroy(b);
+    geohex_zoneset_destroy(u);
+    geohex_zoneset_destroy(x);
+    free(expected);
+}
+
+void test_zoneset_serialize(void)
+{
+    geohex_zoneset_t *set = geohex_zoneset_create();
+    size_t size, written;
+
+    geohex_zoneset_add_many(set, ids, n);
+
+    for (uint32_t round = 0; round < 2; round++) {
+        size = geohex_zoneset_serialized_size(set);
+        uint8_t *buf = malloc(size);
+
+        TEST_ASSERT_FALSE(geohex_zoneset_serialize(set, buf, size - 1, &written));
+        TEST_ASSERT_TRUE(geohex_zoneset_serialize(set, buf, size, &written));
+        TEST_ASSERT_EQUAL_size_t(size, written);
+        TEST_ASSERT_EQUAL_MEMORY("GHZS", buf, 4);
+
+        geohex_zoneset_t *copy = geohex_zoneset_deserialize(buf, size);
+        TEST_ASSERT_NOT_NULL(copy);
+        assert_matches(copy, ids, n);
+        geohex_zoneset_destroy(copy);
+
+        TEST_ASSERT_NULL(geohex_zoneset_deserialize(buf, size - 1));
+        buf[4] ^= 0xff;
+        TEST_ASSERT_NULL(geohex_zoneset_deserialize(buf, size));
+
+        free(buf);
+        geohex_zoneset_optimize(set);
+    }
+
+    geohex_zoneset_destroy(set);
+}
+
+void test_zoneset_byte_format(void)
+{
+    geohex_zoneset_t *set = geohex_zoneset_create();
+    const uint8_t expected[] = {
+        'G', 'H', 'Z', 'S', 1, 0, 0, 0,
+        1, 0, 0, 0,
+        /* key: level 2, prefix 0 */
+        0, 0, 0, 0, 0, 0, 0, 0x02,
+        0, 0, 0, 0,
+        2, 0, 0, 0,
+        2, 0, 0, 0,
+        /* low digits 0x0102 and 0x0203 */
+        0x02, 0x01, 0x03, 0x02,
+    };
+    uint8_t buf[sizeof(expected)];
+    size_t written;
+
+    geohex_zoneset_add(set, ((geohex_id_t) 0x0203 * 2541865828329ULL) << GEOHEX_ID_LEVEL_BITS | 2);
+    geohex_zoneset_add(set, ((geohex_id_t) 0x0102 * 2541865828329ULL) << GEOHEX_ID_LEVEL_BITS | 2);
+
+    TEST_ASSERT_TRUE(geohex_zoneset_serialize(set, buf, sizeof(buf), &written));
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), written);
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, sizeof(expected));
+
+    geohex_zoneset_destroy(set);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_zoneset_add_contains_iterate);
+    RUN_TEST(test_zoneset_union_intersection);
+    RUN_TEST(test_zoneset_serialize);
+    RUN_TEST(test_zoneset_byte_format);
+
+    return UNITY_END();
+}